@@ -0,0 +1,27 @@
+#Reduced Groebner basis data
+#---
+#field characteristic: 1073741827
+#variable order:       x1, x2, x3, x4, x5
+#monomial order:       graded reverse lexicographical
+#length of basis:      20 elements sorted by increasing leading monomials
+#---
+[1*x1^1+1*x2^1+1*x3^1+1*x4^1+1*x5^1,
+1*x2^2+1*x2^1*x4^1+1073741826*x3^1*x4^1+2*x2^1*x5^1+1*x3^1*x5^1+1*x5^2,
+1*x3^3+1*x2^1*x3^1*x4^1+1073741825*x2^1*x4^2+1073741826*x3^1*x4^2+1073741826*x4^3+3*x3^2*x5^1+1073741825*x2^1*x4^1*x5^1+1073741825*x3^1*x4^1*x5^1+1073741824*x4^2*x5^1+3*x2^1*x5^2+3*x3^1*x5^2+1073741825*x4^1*x5^2+2*x5^3,
+1*x2^1*x3^2+1073741826*x2^1*x3^1*x4^1+1*x3^2*x4^1+1073741826*x3^2*x5^1+1*x2^1*x4^1*x5^1+1*x3^1*x4^1*x5^1+1*x4^2*x5^1+1073741826*x2^1*x5^2+1073741825*x3^1*x5^2+1*x4^1*x5^2+1073741826*x5^3,
+1*x4^4+14*x2^1*x3^1*x4^1*x5^1+6*x3^2*x4^1*x5^1+1073741800*x2^1*x4^2*x5^1+2*x3^1*x4^2*x5^1+1073741812*x4^3*x5^1+1073741826*x2^1*x3^1*x5^2+7*x3^2*x5^2+1073741817*x2^1*x4^1*x5^2+1073741818*x3^1*x4^1*x5^2+1073741794*x4^2*x5^2+24*x2^1*x5^3+33*x3^1*x5^3+1073741813*x4^1*x5^3+22*x5^4,
+1*x3^1*x4^3+1073741825*x2^1*x3^1*x4^1*x5^1+1073741826*x3^2*x4^1*x5^1+5*x2^1*x4^2*x5^1+4*x4^3*x5^1+1073741826*x2^1*x3^1*x5^2+1073741825*x3^2*x5^2+2*x2^1*x4^1*x5^2+7*x4^2*x5^2+1073741823*x2^1*x5^3+1073741820*x3^1*x5^3+2*x4^1*x5^3+1073741823*x5^4,
+1*x2^1*x4^3+1073741822*x2^1*x3^1*x4^1*x5^1+1073741825*x3^2*x4^1*x5^1+10*x2^1*x4^2*x5^1+1*x3^1*x4^2*x5^1+6*x4^3*x5^1+1073741824*x3^2*x5^2+2*x2^1*x4^1*x5^2+2*x3^1*x4^1*x5^2+13*x4^2*x5^2+1073741819*x2^1*x5^3+1073741814*x3^1*x5^3+4*x4^1*x5^3+1073741819*x5^4,
+1*x3^2*x4^2+1*x2^1*x3^1*x4^1*x5^1+1073741825*x2^1*x4^2*x5^1+2*x3^1*x4^2*x5^1+1073741826*x4^3*x5^1+1073741825*x2^1*x4^1*x5^2+1073741825*x3^1*x4^1*x5^2+1073741825*x4^2*x5^2+3*x2^1*x5^3+2*x3^1*x5^3+1073741825*x4^1*x5^3+2*x5^4,
+1*x2^1*x3^1*x4^2+1*x2^1*x3^1*x4^1*x5^1+1*x3^2*x4^1*x5^1+1073741826*x2^1*x4^2*x5^1+1*x3^1*x4^2*x5^1+1073741826*x4^3*x5^1+1073741826*x2^1*x3^1*x5^2+1073741826*x2^1*x4^1*x5^2+1073741825*x4^2*x5^2+1*x2^1*x5^3+1*x3^1*x5^3+1073741826*x4^1*x5^3+1*x5^4,
+1*x2^1*x3^1*x4^1*x5^2+536870914*x3^2*x4^1*x5^2+1*x3^1*x4^2*x5^2+536870913*x2^1*x3^1*x5^3+1073741826*x2^1*x4^1*x5^3+536870913*x3^1*x4^1*x5^3+536870913*x4^2*x5^3+536870914*x2^1*x5^4+536870914*x3^1*x5^4+1073741826*x4^1*x5^4+536870914*x5^5+536870913,
+1*x2^1*x5^5+1073741826*x3^1*x5^5+1073741826*x2^1+1*x3^1,
+1*x3^1*x4^2*x5^3+357913943*x4^3*x5^3+357913941*x2^1*x3^1*x5^4+357913941*x3^2*x5^4+715827885*x2^1*x4^1*x5^4+715827883*x3^1*x4^1*x5^4+2*x4^2*x5^4+1002159037*x3^1*x5^5+644245096*x4^1*x5^5+501079519*x5^6+1*x2^1+71582788*x3^1+429496731*x4^1+214748367*x5^1,
+1*x2^1*x4^2*x5^3+715827885*x4^3*x5^3+715827885*x2^1*x3^1*x5^4+715827885*x3^2*x5^4+357913942*x2^1*x4^1*x5^4+357913943*x3^1*x4^1*x5^4+715827884*x3^1*x5^5+357913942*x5^6+1073741826*x2^1+357913943*x3^1+1073741826*x5^1,
+1*x3^1*x4^1*x5^5+536870914*x4^2*x5^5+4*x3^1*x5^6+536870914*x4^1*x5^6+536870915*x5^7+1073741826*x3^1*x4^1+536870913*x4^2+1073741823*x3^1*x5^1+536870913*x4^1*x5^1+536870912*x5^2,
+1*x3^2*x5^5+3*x3^1*x5^6+1*x5^7+1073741826*x3^2+1073741824*x3^1*x5^1+1073741826*x5^2,
+1*x4^3*x5^4+429496733*x4^2*x5^5+644245098*x3^1*x5^6+858993462*x4^1*x5^6+214748366*x5^7+1073741825*x2^1*x3^1+1073741825*x3^2+2*x2^1*x4^1+1073741826*x3^1*x4^1+644245097*x4^2+429496726*x3^1*x5^1+214748365*x4^1*x5^1+858993463*x5^2,
+1*x5^8+42*x2^1*x3^1*x4^1+21*x3^2*x4^1+1073741662*x2^1*x4^2+42*x3^1*x4^2+1073741772*x4^3+1073741751*x2^1*x3^1*x5^1+1073741772*x3^2*x5^1+13*x2^1*x4^1*x5^1+1073741696*x3^1*x4^1*x5^1+1073741806*x4^2*x5^1+186*x2^1*x5^2+21*x3^1*x5^2+1073741785*x4^1*x5^2+219*x5^3,
+1*x4^1*x5^7+1073741717*x2^1*x3^1*x4^1+1073741772*x3^2*x4^1+52*x2^1*x4^2+60*x3^1*x4^2+39*x4^3+29*x2^1*x3^1*x5^1+1073741801*x3^2*x5^1+1073741793*x2^1*x4^1*x5^1+1073741725*x3^1*x4^1*x5^1+120*x4^2*x5^1+63*x2^1*x5^2+1073741707*x3^1*x5^2+109*x4^1*x5^2+1073741801*x5^3,
+1*x3^1*x5^7+1073741811*x2^1*x3^1*x4^1+1073741819*x3^2*x4^1+63*x2^1*x4^2+1073741811*x3^1*x4^2+21*x4^3+29*x2^1*x3^1*x5^1+21*x3^2*x5^1+1073741822*x2^1*x4^1*x5^1+50*x3^1*x4^1*x5^1+8*x4^2*x5^1+1073741756*x2^1*x5^2+1073741818*x3^1*x5^2+16*x4^1*x5^2+1073741743*x5^3,
+1*x4^2*x5^6+28*x2^1*x3^1*x4^1+14*x3^2*x4^1+1073741806*x2^1*x4^2+1073741815*x3^1*x4^2+1073741815*x4^3+1073741816*x2^1*x3^1*x5^1+3*x3^2*x5^1+9*x2^1*x4^1*x5^1+17*x3^1*x4^1*x5^1+1073741797*x4^2*x5^1+1073741822*x2^1*x5^2+29*x3^1*x5^2+1073741799*x4^1*x5^2+18*x5^3]:
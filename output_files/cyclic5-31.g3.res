@@ -0,0 +1,8 @@
+#Hilbert series data
+#---
+#field characteristic: 1073741827
+#variable order:       x1, x2, x3, x4, x5
+#monomial order:       graded reverse lexicographical
+#Hilbert series:       h(t)/(1-t)^dim, printed as [dim, degree, [coefficients of h]]
+#---
+[0, 70, [1, 4, 9, 14, 14, 13, 10, 5]]:
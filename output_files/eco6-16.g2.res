@@ -0,0 +1,25 @@
+#Reduced Groebner basis data
+#---
+#field characteristic: 65521
+#variable order:       x0, x1, x2, x3, x4, x5
+#monomial order:       graded reverse lexicographical
+#length of basis:      18 elements sorted by increasing leading monomials
+#---
+[1*x0^1+1*x1^1+1*x2^1+1*x3^1+1*x4^1+1,
+1*x4^1*x5^1+65516,
+1*x3^1*x5^1+65516*x1^1+65516*x2^1+65516*x3^1+65516*x4^1+65512,
+1*x1^1*x4^1+1*x2^1*x4^1+1*x3^1*x4^1+1*x4^2+65520*x3^1+13106*x4^1,
+1*x1^1*x3^1+1*x2^1*x3^1+1*x3^2+1*x2^1*x4^1+2*x3^1*x4^1+1*x4^2+65520*x2^1+39315*x4^1,
+1*x2^2+2*x2^1*x3^1+2*x3^2+2*x2^1*x4^1+4*x3^1*x4^1+3*x4^2+52417*x2^1*x5^1+52415*x1^1+52414*x2^1+52414*x3^1+52425*x4^1+26207,
+1*x1^1*x2^1+65520*x3^2+65520*x2^1*x4^1+65519*x3^1*x4^1+65519*x4^2+13104*x2^1*x5^1+13105*x1^1+13107*x2^1+13107*x3^1+26203*x4^1+39314,
+1*x1^2+65519*x2^1*x3^1+65520*x3^2+65519*x2^1*x4^1+65517*x3^1*x4^1+65519*x4^2+2*x1^1+2*x2^1+2*x3^1+65518*x4^1+1,
+1*x1^1*x5^2+7560*x2^1*x5^2+63001*x5^3+35249*x2^1*x3^1+22669*x3^2+15086*x2^1*x4^1+25130*x3^1*x4^1+2486*x4^2+37800*x1^1*x5^1+35277*x2^1*x5^1+57962*x5^2+50410*x1^1+25241*x2^1+20215*x3^1+7511*x4^1+40319*x5^1+2533,
+1*x4^3+33329*x2^1*x5^2+36974*x5^3+30642*x2^1*x3^1+34676*x3^2+23991*x2^1*x4^1+7658*x3^1*x4^1+25406*x4^2+12121*x1^1*x5^1+45425*x2^1*x5^1+8185*x5^2+2754*x1^1+33878*x2^1+55937*x3^1+14885*x4^1+18863*x5^1+35795,
+1*x3^1*x4^2+20882*x2^1*x5^2+41752*x5^3+17744*x2^1*x3^1+14216*x3^2+4232*x2^1*x4^1+30648*x3^1*x4^1+29536*x4^2+38260*x1^1*x5^1+36507*x2^1*x5^1+47155*x5^2+31929*x1^1+43740*x2^1+19267*x3^1+63448*x4^1+27748*x5^1+30154,
+1*x2^1*x4^2+11310*x2^1*x5^2+52316*x5^3+17135*x2^1*x3^1+16630*x3^2+37297*x2^1*x4^1+14109*x3^1*x4^1+49894*x4^2+15140*x1^1*x5^1+49110*x2^1*x5^1+10181*x5^2+30838*x1^1+53424*x2^1+55838*x3^1+52709*x4^1+18910*x5^1+65093,
+1*x3^2*x4^1+38345*x2^1*x5^2+39111*x5^3+47377*x2^1*x3^1+46366*x3^2+35281*x2^1*x4^1+28224*x3^1*x4^1+47376*x4^2+19797*x1^1*x5^1+22216*x2^1*x5^1+20362*x5^2+9261*x1^1+2012*x2^1+46155*x3^1+37284*x4^1+58787*x5^1+35835,
+1*x2^1*x3^1*x4^1+17604*x2^1*x5^2+36974*x5^3+17536*x2^1*x3^1+21568*x3^2+50201*x2^1*x4^1+33865*x3^1*x4^1+12296*x4^2+22604*x1^1*x5^1+55908*x2^1*x5^1+8185*x5^2+55169*x1^1+7672*x2^1+55936*x3^1+30604*x4^1+63417*x5^1+64625,
+1*x3^3+19483*x2^1*x5^2+8427*x5^3+21965*x2^1*x3^1+30030*x3^2+21772*x2^1*x4^1+28413*x3^1*x4^1+24586*x4^2+42587*x1^1*x5^1+1740*x2^1*x5^1+16370*x5^2+29092*x1^1+52040*x2^1+56842*x3^1+37604*x4^1+40346*x5^1+19177,
+1*x2^1*x3^2+52473*x2^1*x5^2+15846*x5^3+31856*x2^1*x3^1+29846*x3^2+10282*x2^1*x4^1+40733*x3^1*x4^1+23998*x4^2+5944*x1^1*x5^1+22840*x2^1*x5^1+16612*x5^2+20661*x1^1+30236*x2^1+37829*x3^1+7533*x4^1+36539*x5^1+13092,
+1*x5^4+55520*x2^1*x5^2+25224*x5^3+33506*x2^1*x3^1+31114*x3^2+39923*x2^1*x4^1+60465*x3^1*x4^1+31326*x4^2+12446*x1^1*x5^1+37658*x2^1*x5^1+9991*x5^2+10428*x1^1+6678*x2^1+60108*x3^1+22436*x4^1+51823*x5^1+12859,
+1*x2^1*x5^3+2510*x2^1*x5^2+42841*x5^3+55507*x2^1*x3^1+7683*x3^2+5207*x2^1*x4^1+30532*x3^1*x4^1+22949*x4^2+12550*x1^1*x5^1+55469*x2^1*x5^1+63004*x5^2+60214*x1^1+29801*x2^1+49738*x3^1+2998*x4^1+35285*x5^1+21817]:
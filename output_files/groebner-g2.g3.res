@@ -0,0 +1,8 @@
+#Hilbert series data
+#---
+#field characteristic: 0
+#variable order:       x1, x2, x3, x4, x5, x6, x7, x8, x9, y10, y11, y12, y13, y14, y15, y16, y17, y18, y19
+#monomial order:       graded reverse lexicographical
+#Hilbert series:       h(t)/(1-t)^dim, printed as [dim, degree, [coefficients of h]]
+#---
+[16, 80, [1, 3, 5, 7, 8, 8, 8, 8, 8, 8, 7, 5, 3, 1]]:
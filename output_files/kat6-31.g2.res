@@ -0,0 +1,29 @@
+#Reduced Groebner basis data
+#---
+#field characteristic: 1073741827
+#variable order:       x1, x2, x3, x4, x5, x6
+#monomial order:       graded reverse lexicographical
+#length of basis:      22 elements sorted by increasing leading monomials
+#---
+[1*x1^1+2*x2^1+2*x3^1+2*x4^1+2*x5^1+2*x6^1+1073741826,
+1*x4^2+2*x3^1*x5^1+976128938*x4^1*x5^1+390451577*x5^2+2*x2^1*x6^1+976128938*x3^1*x6^1+780903154*x4^1*x6^1+488064477*x5^1*x6^1+585677367*x6^2+292838680*x2^1+97612893*x3^1+488064466*x4^1+390451572*x5^1+878516038*x6^1,
+1*x3^1*x4^1+1*x2^1*x5^1+585677359*x4^1*x5^1+878516039*x5^2+1073741825*x2^1*x6^1+585677357*x3^1*x6^1+683290249*x4^1*x6^1+292838674*x5^1*x6^1+780903142*x6^2+927322487*x2^1+488064467*x3^1+829709594*x4^1+878516041*x5^1+97612895*x6^1,
+1*x3^2+2*x2^1*x4^1+1073741823*x2^1*x5^1+1073741823*x3^1*x5^1+1073741823*x4^1*x5^1+1073741823*x5^2+2*x2^1*x6^1+1073741823*x5^1*x6^1+1*x5^1,
+1*x2^1*x3^1+1073741825*x2^1*x4^1+3*x2^1*x5^1+4*x3^1*x5^1+976128938*x4^1*x5^1+390451578*x5^2+976128937*x3^1*x6^1+780903150*x4^1*x6^1+488064475*x5^1*x6^1+585677364*x6^2+292838680*x2^1+97612893*x3^1+1024935380*x4^1+390451572*x5^1+878516039*x6^1,
+1*x2^2+2*x2^1*x4^1+1073741825*x3^1*x5^1+878516037*x4^1*x5^1+780903144*x5^2+878516037*x3^1*x6^1+488064463*x4^1*x6^1+976128926*x5^1*x6^1+97612889*x6^2+585677360*x2^1+195225787*x3^1+976128934*x4^1+780903148*x5^1+683290255*x6^1,
+1*x4^1*x5^1*x6^1+495573152*x5^2*x6^1+1*x3^1*x6^2+991146304*x4^1*x6^2+825955255*x5^1*x6^2+825955254*x6^3+176203787*x4^1*x5^1+801176594*x5^2+289084338*x2^1*x6^1+258799312*x3^1*x6^1+982886749*x4^1*x6^1+313862995*x5^1*x6^1+591934596*x6^2+977380381*x2^1+256046128*x3^1+1057222722*x4^1+159684682*x5^1+784657489*x6^1,
+1*x4^1*x5^2+495573152*x5^3+1*x3^1*x5^1*x6^1+147596739*x5^2*x6^1+82595523*x3^1*x6^2+790766622*x4^1*x6^2+701328865*x5^1*x6^2+815691899*x6^3+289084338*x2^1*x5^1+82595525*x3^1*x5^1+589490942*x4^1*x5^1+533205431*x5^2+942761941*x2^1*x6^1+685037837*x3^1*x6^1+300569515*x4^1*x6^1+574014463*x5^1*x6^1+622806101*x6^2+873321423*x2^1+608469993*x3^1+811293324*x4^1+946508878*x5^1+1014116655*x6^1,
+1*x3^1*x5^2+165191050*x5^3+536870915*x2^1*x5^1*x6^1+165191053*x3^1*x5^1*x6^1+712080946*x5^2*x6^1+991146303*x2^1*x6^2+619466440*x3^1*x6^2+20037966*x4^1*x6^2+1044906698*x5^1*x6^2+91881409*x6^3+929199658*x2^1*x4^1+289084338*x2^1*x5^1+371679863*x3^1*x5^1+276313651*x4^1*x5^1+84088376*x5^2+822534135*x2^1*x6^1+469117998*x3^1*x6^1+116737823*x4^1*x6^1+157722354*x5^1*x6^1+304894044*x6^2+15724547*x2^1+913029329*x3^1+357002385*x4^1+984347018*x5^1+7464254*x6^1,
+1*x2^1*x5^2+523104993*x5^3+2*x2^1*x4^1*x6^1+660764199*x2^1*x5^1*x6^1+165191047*x3^1*x5^1*x6^1+813736979*x5^2*x6^1+247786577*x2^1*x6^2+495573153*x3^1*x6^2+553732137*x4^1*x6^2+168123444*x5^1*x6^2+701817606*x6^3+178956971*x2^1*x4^1+289084338*x2^1*x5^1+798423410*x3^1*x5^1+970886184*x4^1*x5^1+657905866*x5^2+991960853*x2^1*x6^1+547400843*x3^1*x6^1+97975738*x4^1*x6^1+400811187*x5^1*x6^1+800082130*x6^2+182840901*x2^1+184147886*x3^1+587384216*x4^1+216093116*x5^1+13240165*x6^1,
+1*x2^1*x4^1*x5^1+275318417*x5^3+2*x2^1*x4^1*x6^1+41297763*x2^1*x5^1*x6^1+247786576*x3^1*x5^1*x6^1+1025846196*x5^2*x6^1+165191053*x2^1*x6^2+206488814*x3^1*x6^2+977950568*x4^1*x6^2+830842560*x5^1*x6^2+481399954*x6^3+323499140*x2^1*x4^1+867253014*x2^1*x5^1+674530122*x3^1*x5^1+70353556*x4^1*x5^1+1000315190*x5^2+171137276*x2^1*x6^1+245563590*x3^1*x6^1+477948477*x4^1*x6^1+861408977*x5^1*x6^1+390296068*x6^2+358547071*x2^1+674504945*x3^1+1048470736*x4^1+891686598*x5^1+651544959*x6^1,
+1*x5^2*x6^2+2*x4^1*x6^3+572662312*x5^1*x6^3+858993465*x6^4+810973341*x5^3+455147230*x5^2*x6^1+930576250*x2^1*x6^2+1026616491*x3^1*x6^2+627542445*x4^1*x6^2+70389741*x5^1*x6^2+252925851*x6^3+570872738*x2^1*x5^1+330772135*x3^1*x5^1+1038924754*x4^1*x5^1+593361664*x5^2+79784983*x2^1*x6^1+712924805*x3^1*x6^1+282095839*x4^1*x6^1+871401145*x5^1*x6^1+860882452*x6^2+216885907*x2^1+937197658*x3^1+891682935*x4^1+503425844*x5^1+846168212*x6^1,
+1*x3^1*x5^1*x6^2+644245097*x2^1*x6^3+973525924*x3^1*x6^3+548801379*x4^1*x6^3+38177488*x5^1*x6^3+167026507*x6^4+910294460*x5^3+887626577*x2^1*x4^1*x6^1+392870204*x2^1*x5^1*x6^1+271457841*x3^1*x5^1*x6^1+1047498099*x5^2*x6^1+649574037*x2^1*x6^2+93654148*x3^1*x6^2+886758265*x4^1*x6^2+688205682*x5^1*x6^2+309471549*x6^3+701332370*x2^1*x4^1+444091666*x2^1*x5^1+789597925*x3^1*x5^1+898871839*x4^1*x5^1+241120862*x5^2+620333574*x2^1*x6^1+605458413*x3^1*x6^1+184061642*x4^1*x6^1+145920143*x5^1*x6^1+664051486*x6^2+1057973815*x2^1+272629628*x3^1+378677745*x4^1+938306819*x5^1+612978358*x6^1,
+1*x2^1*x5^1*x6^2+959209365*x2^1*x6^3+317827580*x3^1*x6^3+987842479*x4^1*x6^3+1022202217*x5^1*x6^3+372230498*x6^4+369645566*x5^3+61561198*x2^1*x4^1*x6^1+260227297*x2^1*x5^1*x6^1+75495981*x3^1*x5^1*x6^1+760320188*x5^2*x6^1+9448928*x2^1*x6^2+1062288581*x3^1*x6^2+753559215*x4^1*x6^2+14351008*x5^1*x6^2+384261492*x6^3+595815363*x2^1*x4^1+375284699*x2^1*x5^1+522037369*x3^1*x5^1+155275806*x4^1*x5^1+616601432*x5^2+369012216*x2^1*x6^1+532282304*x3^1*x6^1+149700552*x4^1*x6^1+223636770*x5^1*x6^1+269881056*x6^2+191156972*x2^1+694951216*x3^1+176782517*x4^1+16330504*x5^1+52398691*x6^1,
+1*x2^1*x4^1*x6^2+658561655*x2^1*x6^3+495352897*x3^1*x6^3+1054653085*x4^1*x6^3+193750749*x5^1*x6^3+19088745*x6^4+888919044*x5^3+607022046*x2^1*x4^1*x6^1+210167067*x2^1*x5^1*x6^1+221556684*x3^1*x5^1*x6^1+1023098722*x5^2*x6^1+248026408*x2^1*x6^2+639114996*x3^1*x6^2+269814872*x4^1*x6^2+125762911*x5^1*x6^2+337264966*x6^3+103779136*x2^1*x4^1+901044373*x2^1*x5^1+144100130*x3^1*x5^1+764407869*x4^1*x5^1+382646482*x5^2+529859530*x2^1*x6^1+109452204*x3^1*x6^1+212780976*x4^1*x6^1+484184773*x5^1*x6^1+226407831*x6^2+373547105*x2^1+931489001*x3^1+1014768308*x4^1+726587064*x5^1+602177732*x6^1,
+1*x5^3*x6^1+1073741825*x3^1*x6^3+1002159030*x4^1*x6^3+899897902*x5^1*x6^3+746506213*x6^4+326665302*x5^3+930576250*x2^1*x5^1*x6^1+308487731*x3^1*x5^1*x6^1+387858175*x5^2*x6^1+1067947030*x2^1*x6^2+997163977*x3^1*x6^2+232735993*x4^1*x6^2+732988859*x5^1*x6^2+692850865*x6^3+445858511*x2^1*x4^1+1861677*x2^1*x5^1+198930667*x3^1*x5^1+776737434*x4^1*x5^1+900344884*x5^2+969717565*x2^1*x6^1+725745383*x3^1*x6^1+962592927*x4^1*x6^1+187133036*x5^1*x6^1+927077518*x6^2+462447299*x2^1+50544249*x3^1+497059498*x4^1+261785427*x5^1+222633806*x6^1,
+1*x5^4+214748367*x2^1*x6^3+944892818*x3^1*x6^3+143165594*x4^1*x6^3+101789165*x5^1*x6^3+201375770*x6^4+204792024*x5^3+987842481*x2^1*x4^1*x6^1+632846914*x2^1*x5^1*x6^1+862677687*x3^1*x5^1*x6^1+816049074*x5^2*x6^1+316423356*x2^1*x6^2+955609045*x3^1*x6^2+660308441*x4^1*x6^2+129998201*x5^1*x6^2+207013564*x6^3+431439188*x2^1*x4^1+389597142*x2^1*x5^1+714542561*x3^1*x5^1+844559205*x4^1*x5^1+377147897*x5^2+134450805*x2^1*x6^1+71765979*x3^1*x6^1+805121768*x4^1*x6^1+934651746*x5^1*x6^1+607620950*x6^2+497476145*x2^1+746954160*x3^1+721222163*x4^1+51139182*x5^1+920278073*x6^1,
+1*x5^1*x6^4+63161285*x6^5+1042161185*x2^1*x6^3+639972421*x3^1*x6^3+630097794*x4^1*x6^3+652922548*x5^1*x6^3+283282486*x6^4+1069803905*x5^3+2322106*x2^1*x4^1*x6^1+412681071*x2^1*x5^1*x6^1+477946871*x3^1*x5^1*x6^1+472252074*x5^2*x6^1+5677016*x2^1*x6^2+169827362*x3^1*x6^2+451144995*x4^1*x6^2+389589518*x5^1*x6^2+725607149*x6^3+280228040*x2^1*x4^1+763588153*x2^1*x5^1+769580210*x3^1*x5^1+448663890*x4^1*x5^1+661123238*x5^2+947044415*x2^1*x6^1+779002177*x3^1*x6^1+833713009*x4^1*x6^1+461800111*x5^1*x6^1+987218862*x6^2+68226211*x2^1+301673541*x3^1+990497457*x4^1+479839411*x5^1+559981640*x6^1,
+1*x4^1*x6^4+757935407*x6^5+243802556*x2^1*x6^3+1052359049*x3^1*x6^3+415971409*x4^1*x6^3+482989522*x5^1*x6^3+570302360*x6^4+101690940*x5^3+882356738*x2^1*x4^1*x6^1+854322203*x2^1*x5^1*x6^1+674924206*x3^1*x5^1*x6^1+213192773*x5^2*x6^1+641025733*x2^1*x6^2+402165130*x3^1*x6^2+73501627*x4^1*x6^2+923150466*x5^1*x6^2+48494947*x6^3+256394532*x2^1*x4^1+1038632429*x2^1*x5^1+57119359*x3^1*x5^1+213384401*x4^1*x5^1+156167484*x5^2+600786114*x2^1*x6^1+165906132*x3^1*x6^1+917636413*x4^1*x6^1+791062717*x5^1*x6^1+611202155*x6^2+725681874*x2^1+324728559*x3^1+892564826*x4^1+102501743*x5^1+622042760*x6^1,
+1*x3^1*x6^4+267220817*x6^5+450597998*x2^1*x6^3+786941825*x3^1*x6^3+657836003*x4^1*x6^3+442341765*x5^1*x6^3+506673892*x6^4+271555030*x5^3+336248936*x2^1*x4^1*x6^1+804386948*x2^1*x5^1*x6^1+889349154*x3^1*x5^1*x6^1+966752497*x5^2*x6^1+857073244*x2^1*x6^2+793472286*x3^1*x6^2+862416701*x4^1*x6^2+337512387*x5^1*x6^2+559031715*x6^3+959762844*x2^1*x4^1+838141676*x2^1*x5^1+872180259*x3^1*x5^1+30182384*x4^1*x5^1+333770306*x5^2+773029280*x2^1*x6^1+840478265*x3^1*x6^1+351607542*x4^1*x6^1+26008714*x5^1*x6^1+143010514*x6^2+274635429*x2^1+562341824*x3^1+902745387*x4^1+49352419*x5^1+411649421*x6^1,
+1*x2^1*x6^4+500431711*x6^5+16555814*x2^1*x6^3+672193142*x3^1*x6^3+1047401296*x4^1*x6^3+514077466*x5^1*x6^3+759100340*x6^4+685621110*x5^3+432487894*x2^1*x4^1*x6^1+654821995*x2^1*x5^1*x6^1+408507277*x3^1*x5^1*x6^1+764141382*x5^2*x6^1+177899730*x2^1*x6^2+708583785*x3^1*x6^2+774553107*x4^1*x6^2+138794356*x5^1*x6^2+241769179*x6^3+393986626*x2^1*x4^1+957650887*x2^1*x5^1+133203994*x3^1*x5^1+447758898*x4^1*x5^1+1033033268*x5^2+957062783*x2^1*x6^1+591678353*x3^1*x6^1+425486601*x4^1*x6^1+1018505689*x5^1*x6^1+1068723562*x6^2+901000393*x2^1+608186347*x3^1+191780356*x4^1+938259242*x5^1+629832257*x6^1,
+1*x6^6+363527359*x6^5+116170170*x2^1*x6^3+462268777*x3^1*x6^3+781382195*x4^1*x6^3+601140540*x5^1*x6^3+442032501*x6^4+28619790*x5^3+466318068*x2^1*x4^1*x6^1+28200654*x2^1*x5^1*x6^1+87243783*x3^1*x5^1*x6^1+625642815*x5^2*x6^1+933110287*x2^1*x6^2+762704144*x3^1*x6^2+899197686*x4^1*x6^2+173988552*x5^1*x6^2+668573947*x6^3+637289703*x2^1*x4^1+531855625*x2^1*x5^1+516113165*x3^1*x5^1+454861001*x4^1*x5^1+967912288*x5^2+144860851*x2^1*x6^1+140051260*x3^1*x6^1+413070193*x4^1*x6^1+1022699856*x5^1*x6^1+451427197*x6^2+452171238*x2^1+896744149*x3^1+845787569*x4^1+316761172*x5^1+832539225*x6^1]:
@@ -0,0 +1,10 @@
+#Reduced Groebner basis data
+#---
+#field characteristic: 1073741827
+#variable order:       x, y
+#monomial order:       graded reverse lexicographical
+#length of basis:      3 elements sorted by increasing leading monomials
+#---
+[1*y^2+1073741826*x^1,
+1*x^1*y^1+1073741826*y^1,
+1*x^2+1073741826*x^1]:
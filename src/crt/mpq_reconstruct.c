@@ -25,8 +25,22 @@
 **/
 
 #include <gmp.h>
+#include <flint/fmpq.h>
 #include "../msolve/streams.h"
 
+/* moduli of at least that many bits are handled by FLINT's half-gcd based
+ * rational reconstruction which is subquadratic in the size of the modulus,
+ * the environment variable MSOLVE_RATRECON_HGCD_MIN overwrites it */
+#define RATRECON_HGCD_THRESHOLD 2048
+
+static inline size_t ratrecon_hgcd_min(void){
+  const char *val = getenv("MSOLVE_RATRECON_HGCD_MIN");
+  if(val != NULL && *val != '\0'){
+    return strtoull(val, NULL, 10);
+  }
+  return RATRECON_HGCD_THRESHOLD;
+}
+
 /* #define ROT(u,v,t)                                            \ */
 /*   do { mpz _t = *u; *u = *v; *v = *t; *t = _t; } while (0); */
 
@@ -189,18 +203,45 @@ int mpq_reconstruct_mpz_with_denom(mpq_t *res, mpz_t a, const mpz_t m,
 }
 
 
-/* Rational reconstruction -- classical algorithm
-   returns 1 in case of success else returns 0
-
-   assumes that 2ND < mod
-
-   In case of success, n and d are such that
-   n/d = u modulo mod
-   gcd(n,d)=1
-   and |n| < recadata->N, |d| < recdata->D
+/* Rational reconstruction of a modulo mod w.r.t. the bounds in recdata
+   via half-gcd, assumes 0 <= a < mod.
+   Returns 1 in case of success, -1 if the bounds do not satisfy
+   2ND < mod and the classical algorithm has to be used, else 0 */
+static int ratrecon_hgcd(mpz_t n, mpz_t d, const mpz_t a, const mpz_t mod,
+                         rrec_data_t recdata){
 
+  /* the bounds are chosen with ND close to mod/2, comparing bit sizes
+   * would always fail */
+  mpz_mul(recdata->tmp, recdata->N, recdata->D);
+  mpz_mul_2exp(recdata->tmp, recdata->tmp, 1);
+  if(mpz_cmp(recdata->tmp, mod) >= 0){
+    return -1;
+  }
+  fmpz_t fa, fm, fN, fD;
+  fmpq_t res;
+  fmpz_init(fa);
+  fmpz_init(fm);
+  fmpz_init(fN);
+  fmpz_init(fD);
+  fmpq_init(res);
+  fmpz_set_mpz(fa, a);
+  fmpz_set_mpz(fm, mod);
+  fmpz_set_mpz(fN, recdata->N);
+  fmpz_set_mpz(fD, recdata->D);
+
+  int b = fmpq_reconstruct_fmpz_2(res, fa, fm, fN, fD);
+  if(b){
+    fmpz_get_mpz(n, fmpq_numref(res));
+    fmpz_get_mpz(d, fmpq_denref(res));
+  }
+  fmpq_clear(res);
+  fmpz_clear(fD);
+  fmpz_clear(fN);
+  fmpz_clear(fm);
+  fmpz_clear(fa);
+  return b;
+}
 
- */
 int ratreconwden(mpz_t n, mpz_t d, /* output numerator and denominator */
                  mpz_t u, const mpz_t mod, const mpz_t gden,
                  rrec_data_t recdata){
@@ -218,6 +259,20 @@ int ratreconwden(mpz_t n, mpz_t d, /* output numerator and denominator */
   mpz_mod(recdata->r1, recdata->r1, mod);
   mpz_set_ui(recdata->t1, 1);
 
+  /* once the denominators found so far are multiplied in, most
+   * coefficients are integers which we detect without any division */
+  if(mpz_cmp(recdata->r1, recdata->N) <= 0){
+    mpz_set(n, recdata->r1);
+    mpz_set_ui(d, 1);
+    return 1;
+  }
+  if(mpz_sizeinbase(mod, 2) >= recdata->hgcd_min){
+    int b = ratrecon_hgcd(n, d, recdata->r1, mod, recdata);
+    if(b >= 0){
+      return b;
+    }
+  }
+
   while(mpz_cmp(recdata->r1, recdata->N)>0){
     mpz_fdiv_q(recdata->q, recdata->r0, recdata->r1);
 
@@ -269,6 +324,14 @@ int ratrecon(mpz_t n, mpz_t d, /* output numerator and denominator */
   mpz_set(recdata->r0, mod);
   mpz_set_ui(recdata->t0, 0);
 
+  if(mpz_sizeinbase(mod, 2) >= recdata->hgcd_min
+     && mpz_cmp(u, mod) < 0){
+    int b = ratrecon_hgcd(n, d, u, mod, recdata);
+    if(b >= 0){
+      return b;
+    }
+  }
+
   mpz_set(recdata->r1, u);
   mpz_set_ui(recdata->t1, 1);
 
@@ -191,24 +191,25 @@ void nmod_berlekamp_massey_add_point_modif(
     B->points->length = old_length + 1;
 }
 
-int nmod_em_gcd(nmod_berlekamp_massey_t B){
-  slong i, l, k, queue_len, queue_lo, queue_hi;
-  queue_lo = B->npoints; // vaut 0 en entree
-  queue_hi = B->points->length; //vaut 2*dim ou dim est la dimension du quotient
-  queue_len = queue_hi - queue_lo;
-  FLINT_ASSERT(queue_len >= 0);
-  nmod_poly_zero(B->rt);
-  for (i = 0; i < queue_len; i++)
-    {
-      nmod_poly_set_coeff_ui(B->rt, queue_len - i - 1,
-                             B->points->coeffs[queue_lo + i]);
-    }
-  B->npoints = queue_hi;
+/*
+    Below this gap between the degree l of R0 and the number k = npoints - l
+    of low order coefficients which are not needed, the remainders are
+    computed with plain euclidean divisions, (l - k)/2 of them being
+    expected. Above, the quotients are obtained from the half-gcd of the
+    high parts of R0 and R1, which costs O(M(D) log(D)) instead of O(D^2)
+    for sequences of length 2D.
+*/
+#define EM_GCD_HGCD_CUTOFF 10
 
-  //  nmod_poly_fprint_pretty(ERRSTREAM, B->R0, "x");fprintf(ERRSTREAM, "\n");
+/*
+    Adds the queue_len reversed points stored in B->rt to the internal
+    polynomials, i.e. Ri = Ri * x^queue_len + Vi*rt, then reduces R0, R1
+    until deg(R1) < B->npoints/2. B->npoints must be up to date.
+    Returns 1 if the reduction changed V1, 0 otherwise.
+*/
+static int _nmod_em_gcd_reduce(nmod_berlekamp_massey_t B, slong queue_len){
+  slong l, k;
 
-  /* Ri = Ri * x^queue_len + Vi*rt */
-  //R0 vaut x^queue_len-1 avec queue_len = 2*dim - 1
   nmod_poly_shift_left(B->R0, B->R0, queue_len);
 
   nmod_poly_mul(B->qt, B->V0, B->rt);
@@ -238,11 +239,7 @@ int nmod_em_gcd(nmod_berlekamp_massey_t B){
   k = B->npoints - l;
   FLINT_ASSERT(0 <= k && k <= l);
 
-  /*
-    (l - k)/2 is the expected number of required euclidean iterations.
-    Either branch is OK anytime. TODO: find cutoff
-  */
-  if (l - k < 10)
+  if (l - k < EM_GCD_HGCD_CUTOFF)
     {
       while (B->npoints <= 2*nmod_poly_degree(B->R1))
         {
@@ -268,6 +265,7 @@ int nmod_em_gcd(nmod_berlekamp_massey_t B){
       nmod_poly_init_mod(t0, B->V1->mod);
       nmod_poly_init_mod(t1, B->V1->mod);
 
+      /* the k low order coefficients do not change the quotients */
       nmod_poly_shift_right(r0, B->R0, k);
       nmod_poly_shift_right(r1, B->R1, k);
       sgnM = nmod_poly_hgcd(m11, m12, m21, m22, t0, t1, r0, r1);
@@ -310,268 +308,58 @@ int nmod_em_gcd(nmod_berlekamp_massey_t B){
   FLINT_ASSERT(2*nmod_poly_degree(B->R0) >= B->npoints);
   FLINT_ASSERT(2*nmod_poly_degree(B->R1) <  B->npoints);
 
-
   return 1;
 }
 
-
-int nmod_em_gcd_preinstantiated(nmod_berlekamp_massey_t B, long shift){
-  slong l, k, queue_len, queue_lo, queue_hi;
+/* reverses the points not yet added into B->rt, returns their number */
+static inline slong _nmod_em_gcd_queue(nmod_berlekamp_massey_t B){
+  slong i, queue_len, queue_lo, queue_hi;
   queue_lo = B->npoints; // vaut 0 en entree
   queue_hi = B->points->length; //vaut 2*dim ou dim est la dimension du quotient
-  queue_len = queue_hi - queue_lo + shift;
+  queue_len = queue_hi - queue_lo;
   FLINT_ASSERT(queue_len >= 0);
-  //On a deja fait ce job de maniere appropriee avant l'appel.
-  /* nmod_poly_zero(B->rt); */
-  /* for (i = 0; i < queue_len; i++) */
-  /*   { */
-  /*     nmod_poly_set_coeff_ui(B->rt, queue_len - i - 1, */
-  /*                            B->points->coeffs[queue_lo + i]); */
-  /*   } */
-  B->npoints = queue_hi;
-
-  //  nmod_poly_fprint_pretty(ERRSTREAM, B->R0, "x");fprintf(ERRSTREAM, "\n");
-
-  /* Ri = Ri * x^queue_len + Vi*rt */
-  //R0 vaut x^queue_len-1 avec queue_len = 2*dim - 1
-  nmod_poly_shift_left(B->R0, B->R0, queue_len);
-
-  nmod_poly_mul(B->qt, B->V0, B->rt);
-  nmod_poly_add(B->R0, B->R0, B->qt);
-  nmod_poly_mul(B->qt, B->V1, B->rt);
-  nmod_poly_shift_left(B->R1, B->R1, queue_len);
-  nmod_poly_add(B->R1, B->R1, B->qt);
-
-  /* now start reducing R0, R1 */
-  if (2*nmod_poly_degree(B->R1) < B->npoints)
-    {
-      /* already have deg(R1) < B->npoints/2 */
-      return 0;
-    }
-  /* one iteration of euclid to get deg(R0) >= B->npoints/2 */
-  nmod_poly_divrem(B->qt, B->rt, B->R0, B->R1);
-  nmod_poly_swap(B->R0, B->R1);
-  nmod_poly_swap(B->R1, B->rt);
-  nmod_poly_mul(B->rt, B->qt, B->V1);
-  nmod_poly_sub(B->qt, B->V0, B->rt);
-  nmod_poly_swap(B->V0, B->V1);
-  nmod_poly_swap(B->V1, B->qt);
-
-  l = nmod_poly_degree(B->R0);
-  FLINT_ASSERT(B->npoints <= 2*l && l < B->npoints);
-
-  k = B->npoints - l;
-  FLINT_ASSERT(0 <= k && k <= l);
-
-  /*
-    (l - k)/2 is the expected number of required euclidean iterations.
-    Either branch is OK anytime. TODO: find cutoff
-  */
-  if (l - k < 10)
+  nmod_poly_zero(B->rt);
+  if (queue_len > 0)
     {
-      while (B->npoints <= 2*nmod_poly_degree(B->R1))
+      /* rt has length queue_len, set coefficients directly */
+      nmod_poly_fit_length(B->rt, queue_len);
+      for (i = 0; i < queue_len; i++)
         {
-          nmod_poly_divrem(B->qt, B->rt, B->R0, B->R1);
-          nmod_poly_swap(B->R0, B->R1);
-          nmod_poly_swap(B->R1, B->rt);
-          nmod_poly_mul(B->rt, B->qt, B->V1);
-          nmod_poly_sub(B->qt, B->V0, B->rt);
-          nmod_poly_swap(B->V0, B->V1);
-          nmod_poly_swap(B->V1, B->qt);
+          B->rt->coeffs[queue_len - i - 1] = B->points->coeffs[queue_lo + i];
         }
+      _nmod_poly_set_length(B->rt, queue_len);
+      _nmod_poly_normalise(B->rt);
     }
-  else
-    {
-      slong sgnM;
-      nmod_poly_t m11, m12, m21, m22, r0, r1, t0, t1;
-      nmod_poly_init_mod(m11, B->V1->mod);
-      nmod_poly_init_mod(m12, B->V1->mod);
-      nmod_poly_init_mod(m21, B->V1->mod);
-      nmod_poly_init_mod(m22, B->V1->mod);
-      nmod_poly_init_mod(r0, B->V1->mod);
-      nmod_poly_init_mod(r1, B->V1->mod);
-      nmod_poly_init_mod(t0, B->V1->mod);
-      nmod_poly_init_mod(t1, B->V1->mod);
-
-      nmod_poly_shift_right(r0, B->R0, k);
-      nmod_poly_shift_right(r1, B->R1, k);
-      sgnM = nmod_poly_hgcd(m11, m12, m21, m22, t0, t1, r0, r1);
-
-      /* multiply [[V0 R0] [V1 R1]] by M^(-1) on the left */
-      nmod_poly_mul(B->rt, m22, B->V0);
-      nmod_poly_mul(B->qt, m12, B->V1);
-      sgnM > 0 ? nmod_poly_sub(r0, B->rt, B->qt)
-        : nmod_poly_sub(r0, B->qt, B->rt);
-      nmod_poly_mul(B->rt, m11, B->V1);
-      nmod_poly_mul(B->qt, m21, B->V0);
-      sgnM > 0 ? nmod_poly_sub(r1, B->rt, B->qt)
-        : nmod_poly_sub(r1, B->qt, B->rt);
-      nmod_poly_swap(B->V0, r0);
-      nmod_poly_swap(B->V1, r1);
-
-      nmod_poly_mul(B->rt, m22, B->R0);
-      nmod_poly_mul(B->qt, m12, B->R1);
-      sgnM > 0 ? nmod_poly_sub(r0, B->rt, B->qt)
-        : nmod_poly_sub(r0, B->qt, B->rt);
-      nmod_poly_mul(B->rt, m11, B->R1);
-      nmod_poly_mul(B->qt, m21, B->R0);
-      sgnM > 0 ? nmod_poly_sub(r1, B->rt, B->qt)
-        : nmod_poly_sub(r1, B->qt, B->rt);
-      nmod_poly_swap(B->R0, r0);
-      nmod_poly_swap(B->R1, r1);
-
-      nmod_poly_clear(m11);
-      nmod_poly_clear(m12);
-      nmod_poly_clear(m21);
-      nmod_poly_clear(m22);
-      nmod_poly_clear(r0);
-      nmod_poly_clear(r1);
-      nmod_poly_clear(t0);
-      nmod_poly_clear(t1);
-    }
-
-  FLINT_ASSERT(nmod_poly_degree(B->V1) >= 0);
-  FLINT_ASSERT(2*nmod_poly_degree(B->V1) <= B->npoints);
-  FLINT_ASSERT(2*nmod_poly_degree(B->R0) >= B->npoints);
-  FLINT_ASSERT(2*nmod_poly_degree(B->R1) <  B->npoints);
-
-  return 1;
+  B->npoints = queue_hi;
+  return queue_len;
 }
 
+int nmod_em_gcd(nmod_berlekamp_massey_t B){
+  slong queue_len = _nmod_em_gcd_queue(B);
+  //R0 vaut x^queue_len-1 avec queue_len = 2*dim - 1
+  return _nmod_em_gcd_reduce(B, queue_len);
+}
 
 
-
+int nmod_em_gcd_preinstantiated(nmod_berlekamp_massey_t B, long shift){
+  slong queue_len = B->points->length - B->npoints + shift;
+  FLINT_ASSERT(queue_len >= 0);
+  //On a deja fait ce job de maniere appropriee avant l'appel:
+  //B->rt contient deja les points renverses.
+  B->npoints = B->points->length;
+  return _nmod_em_gcd_reduce(B, queue_len);
+}
 
 
 /* return 1 if reduction changed the master poly, 0 otherwise */
 int nmod_berlekamp_massey_reduce_modif(
     nmod_berlekamp_massey_t B)
 {
-    slong i, l, k, queue_len, queue_lo, queue_hi;
-
     /*
         the points in B->points->coeffs[j] for queue_lo <= j < queue_hi need
         to be added to the internal polynomials.
         These are first reversed into rt. deg(rt) < queue_len.
     */
-    queue_lo = B->npoints;
-    queue_hi = B->points->length;
-    queue_len = queue_hi - queue_lo;
-    FLINT_ASSERT(queue_len >= 0);
-    nmod_poly_zero(B->rt);
-    for (i = 0; i < queue_len; i++)
-    {
-        nmod_poly_set_coeff_ui(B->rt, queue_len - i - 1,
-                                      B->points->coeffs[queue_lo + i]);
-    }
-    B->npoints = queue_hi;
-    //    fprintf(ERRSTREAM, "queue_len = %ld, queue_hi = %ld, queue_lo=%ld\n", queue_len, queue_hi, queue_lo);
-    //    nmod_poly_fprint_pretty(ERRSTREAM, B->R0, "x");fprintf(ERRSTREAM, "\n");
-    /* Ri = Ri * x^queue_len + Vi*rt */
-    //R0 vaut x^queue_len
-    nmod_poly_shift_left(B->R0, B->R0, queue_len);
-    //    nmod_poly_fprint_pretty(ERRSTREAM, B->R0, "x");fprintf(ERRSTREAM, "\n");
-    //done.
-
-    nmod_poly_mul(B->qt, B->V0, B->rt);
-    nmod_poly_add(B->R0, B->R0, B->qt);
-    nmod_poly_mul(B->qt, B->V1, B->rt);
-    nmod_poly_shift_left(B->R1, B->R1, queue_len);
-    nmod_poly_add(B->R1, B->R1, B->qt);
-
-    /* now start reducing R0, R1 */
-    if (2*nmod_poly_degree(B->R1) < B->npoints)
-    {
-        /* already have deg(R1) < B->npoints/2 */
-        return 0;
-    }
-
-    /* one iteration of euclid to get deg(R0) >= B->npoints/2 */
-    nmod_poly_divrem(B->qt, B->rt, B->R0, B->R1);
-    nmod_poly_swap(B->R0, B->R1);
-    nmod_poly_swap(B->R1, B->rt);
-    nmod_poly_mul(B->rt, B->qt, B->V1);
-    nmod_poly_sub(B->qt, B->V0, B->rt);
-    nmod_poly_swap(B->V0, B->V1);
-    nmod_poly_swap(B->V1, B->qt);
-
-    l = nmod_poly_degree(B->R0);
-    FLINT_ASSERT(B->npoints <= 2*l && l < B->npoints);
-
-    k = B->npoints - l;
-    FLINT_ASSERT(0 <= k && k <= l);
-
-    /*
-        (l - k)/2 is the expected number of required euclidean iterations.
-        Either branch is OK anytime. TODO: find cutoff
-    */
-    if (l - k < 10)
-    {
-        while (B->npoints <= 2*nmod_poly_degree(B->R1))
-        {
-            nmod_poly_divrem(B->qt, B->rt, B->R0, B->R1);
-            nmod_poly_swap(B->R0, B->R1);
-            nmod_poly_swap(B->R1, B->rt);
-            nmod_poly_mul(B->rt, B->qt, B->V1);
-            nmod_poly_sub(B->qt, B->V0, B->rt);
-            nmod_poly_swap(B->V0, B->V1);
-            nmod_poly_swap(B->V1, B->qt);
-        }
-    }
-    else
-    {
-        slong sgnM;
-        nmod_poly_t m11, m12, m21, m22, r0, r1, t0, t1;
-        nmod_poly_init_mod(m11, B->V1->mod);
-        nmod_poly_init_mod(m12, B->V1->mod);
-        nmod_poly_init_mod(m21, B->V1->mod);
-        nmod_poly_init_mod(m22, B->V1->mod);
-        nmod_poly_init_mod(r0, B->V1->mod);
-        nmod_poly_init_mod(r1, B->V1->mod);
-        nmod_poly_init_mod(t0, B->V1->mod);
-        nmod_poly_init_mod(t1, B->V1->mod);
-
-        nmod_poly_shift_right(r0, B->R0, k);
-        nmod_poly_shift_right(r1, B->R1, k);
-        sgnM = nmod_poly_hgcd(m11, m12, m21, m22, t0, t1, r0, r1);
-
-        /* multiply [[V0 R0] [V1 R1]] by M^(-1) on the left */
-        nmod_poly_mul(B->rt, m22, B->V0);
-        nmod_poly_mul(B->qt, m12, B->V1);
-        sgnM > 0 ? nmod_poly_sub(r0, B->rt, B->qt)
-                 : nmod_poly_sub(r0, B->qt, B->rt);
-        nmod_poly_mul(B->rt, m11, B->V1);
-        nmod_poly_mul(B->qt, m21, B->V0);
-        sgnM > 0 ? nmod_poly_sub(r1, B->rt, B->qt)
-                 : nmod_poly_sub(r1, B->qt, B->rt);
-        nmod_poly_swap(B->V0, r0);
-        nmod_poly_swap(B->V1, r1);
-
-        nmod_poly_mul(B->rt, m22, B->R0);
-        nmod_poly_mul(B->qt, m12, B->R1);
-        sgnM > 0 ? nmod_poly_sub(r0, B->rt, B->qt)
-                 : nmod_poly_sub(r0, B->qt, B->rt);
-        nmod_poly_mul(B->rt, m11, B->R1);
-        nmod_poly_mul(B->qt, m21, B->R0);
-        sgnM > 0 ? nmod_poly_sub(r1, B->rt, B->qt)
-                 : nmod_poly_sub(r1, B->qt, B->rt);
-        nmod_poly_swap(B->R0, r0);
-        nmod_poly_swap(B->R1, r1);
-
-        nmod_poly_clear(m11);
-        nmod_poly_clear(m12);
-        nmod_poly_clear(m21);
-        nmod_poly_clear(m22);
-        nmod_poly_clear(r0);
-        nmod_poly_clear(r1);
-        nmod_poly_clear(t0);
-        nmod_poly_clear(t1);
-    }
-
-    FLINT_ASSERT(nmod_poly_degree(B->V1) >= 0);
-    FLINT_ASSERT(2*nmod_poly_degree(B->V1) <= B->npoints);
-    FLINT_ASSERT(2*nmod_poly_degree(B->R0) >= B->npoints);
-    FLINT_ASSERT(2*nmod_poly_degree(B->R1) <  B->npoints);
-
-    return 1;
+    slong queue_len = _nmod_em_gcd_queue(B);
+    return _nmod_em_gcd_reduce(B, queue_len);
 }
@@ -36,10 +36,256 @@ static inline void free_sp_mat_fglm(sp_matfglm_t *mat){
     posix_memalign_free(mat->triv_pos);
     posix_memalign_free(mat->dense_idx);
     posix_memalign_free(mat->dst);
+    free(mat->cmp_data);
+    free(mat->cmp_off);
+    free(mat->cmp_nnz);
+    free(mat->cmp_buf);
     free(mat);
   }
 }
 
+/* rows with at most len / SP_MATFGLM_SPARSE_RATIO nonzero entries among
+ * their len = ncols - dst[i] first ones are stored in CSR */
+#define SP_MATFGLM_SPARSE_RATIO 4
+/* matrices with fewer entries are kept dense, unless the environment
+ * variable MSOLVE_FGLM_COMPRESS_MIN gives another bound (0 compresses all
+ * matrices, e.g. to test the compressed storage on small inputs) */
+#define SP_MATFGLM_COMPRESS_MIN (UINT64_C(1) << 24)
+
+static inline uint64_t sp_matfglm_compress_min(void){
+  const char *val = getenv("MSOLVE_FGLM_COMPRESS_MIN");
+  if(val != NULL && *val != '\0'){
+    return strtoull(val, NULL, 10);
+  }
+  return SP_MATFGLM_COMPRESS_MIN;
+}
+
+static inline int sp_matfglm_is_compressed(const sp_matfglm_t *mat){
+  return mat->cmp_off != NULL;
+}
+
+/* switches mat to the compressed storage, rows have to be (re)inserted
+ * with sp_matfglm_compress_row */
+static inline void sp_matfglm_init_compressed(sp_matfglm_t *mat){
+  mat->cmp_off = (uint64_t *)calloc(mat->nrows + 1, sizeof(uint64_t));
+  mat->cmp_nnz = (szmat_t *)calloc(mat->nrows + 1, sizeof(szmat_t));
+  mat->cmp_buf = (CF_t *)calloc(mat->ncols, sizeof(CF_t));
+  mat->cmp_len = 0;
+  if(mat->cmp_off == NULL || mat->cmp_nnz == NULL || mat->cmp_buf == NULL){
+    fprintf(ERRSTREAM, "Problem when allocating compressed matrix\n");
+    exit(1);
+  }
+}
+
+/* appends row, a dense vector of ncols entries, in compressed form to
+ * data which has alloc entries, the first len of them being used. nnz and
+ * dst get the values of cmp_nnz and dst for this row. row is zeroed on
+ * return so that it can be reused for the next row. */
+static inline void sp_matfglm_append_row(CF_t **data, uint64_t *alloc,
+                                         uint64_t *len, szmat_t *nnzp,
+                                         szmat_t *dstp, const szmat_t ncols,
+                                         CF_t *row){
+  szmat_t rlen = ncols;
+  while(rlen > 0 && row[rlen - 1] == 0){
+    rlen--;
+  }
+  szmat_t nnz = 0;
+  for(szmat_t j = 0; j < rlen; j++){
+    nnz += (row[j] != 0);
+  }
+  const int sparse = (uint64_t)SP_MATFGLM_SPARSE_RATIO * nnz <= rlen;
+  const uint64_t need = *len + (sparse ? 2 * (uint64_t)nnz : rlen);
+  if(need > *alloc){
+    uint64_t nalloc = 2 * *alloc;
+    if(nalloc < need){
+      nalloc = need + ncols;
+    }
+    CF_t *tmp = (CF_t *)realloc(*data, nalloc * sizeof(CF_t));
+    if(tmp == NULL){
+      fprintf(ERRSTREAM, "Problem when allocating compressed matrix (amount = %lu)\n",
+              (unsigned long)nalloc);
+      exit(1);
+    }
+    *data  = tmp;
+    *alloc = nalloc;
+  }
+  CF_t *out = *data + *len;
+  if(sparse){
+    szmat_t k = 0;
+    for(szmat_t j = 0; j < rlen; j++){
+      if(row[j] != 0){
+        out[k]       = j;
+        out[nnz + k] = row[j];
+        k++;
+      }
+    }
+    *nnzp = nnz;
+  }
+  else{
+    memcpy(out, row, rlen * sizeof(CF_t));
+    *nnzp = SP_MATFGLM_PACKED;
+  }
+  memset(row, 0, rlen * sizeof(CF_t));
+  *len  = need;
+  *dstp = ncols - rlen;
+}
+
+/* stores row i of mat, given as a dense vector of ncols entries, and sets
+ * dst[i] accordingly. Rows are stored in increasing order, starting again
+ * from i = 0 overwrites the former content. row is zeroed on return so that
+ * it can be reused for the next row. */
+static inline void sp_matfglm_compress_row(sp_matfglm_t *mat, const szmat_t i,
+                                           CF_t *row){
+  if(i == 0){
+    mat->cmp_len = 0;
+  }
+  mat->cmp_off[i] = mat->cmp_len;
+  sp_matfglm_append_row(&(mat->cmp_data), &(mat->cmp_alloc), &(mat->cmp_len),
+                        mat->cmp_nnz + i, mat->dst + i, mat->ncols, row);
+}
+
+/* converts the dense rows of mat to the compressed storage */
+static inline void sp_matfglm_compress(sp_matfglm_t *mat){
+  if(sp_matfglm_is_compressed(mat)){
+    return;
+  }
+  sp_matfglm_init_compressed(mat);
+  for(szmat_t i = 0; i < mat->nrows; i++){
+    sp_matfglm_compress_row(mat, i, mat->dense_mat + (uint64_t)i * mat->ncols);
+  }
+  CF_t *tmp = (CF_t *)realloc(mat->cmp_data, (mat->cmp_len + 1) * sizeof(CF_t));
+  if(tmp != NULL){
+    mat->cmp_data  = tmp;
+    mat->cmp_alloc = mat->cmp_len + 1;
+  }
+  posix_memalign_free(mat->dense_mat);
+  mat->dense_mat = NULL;
+}
+
+/* returns the dense row i of mat, or the work row cmp_buf of a compressed
+ * matrix which has to be handed over to sp_matfglm_compress_row */
+static inline CF_t *sp_matfglm_row(sp_matfglm_t *mat, const szmat_t i){
+  if(sp_matfglm_is_compressed(mat)){
+    return mat->cmp_buf;
+  }
+  return mat->dense_mat + (uint64_t)i * mat->ncols;
+}
+
+/* sets *row to the entries of row i which are stored contiguously and
+ * returns their number (0 for a sparse row of a compressed matrix) */
+static inline szmat_t sp_matfglm_packed_row(const sp_matfglm_t *mat,
+                                            const szmat_t i,
+                                            const CF_t **row){
+  if(!sp_matfglm_is_compressed(mat)){
+    *row = mat->dense_mat + (uint64_t)i * mat->ncols;
+    return mat->ncols - mat->dst[i];
+  }
+  *row = mat->cmp_data + mat->cmp_off[i];
+  if(mat->cmp_nnz[i] == SP_MATFGLM_PACKED){
+    return mat->ncols - mat->dst[i];
+  }
+  return 0;
+}
+
+/* entry idx = i * ncols + j of mat, whatever its storage */
+static inline CF_t sp_matfglm_entry(const sp_matfglm_t *mat, const uint64_t idx){
+  if(!sp_matfglm_is_compressed(mat)){
+    return mat->dense_mat[idx];
+  }
+  const szmat_t i = idx / mat->ncols;
+  const szmat_t j = idx % mat->ncols;
+  const CF_t *row = mat->cmp_data + mat->cmp_off[i];
+  const szmat_t nnz = mat->cmp_nnz[i];
+  if(nnz == SP_MATFGLM_PACKED){
+    return (j < mat->ncols - mat->dst[i]) ? row[j] : 0;
+  }
+  szmat_t lo = 0, hi = nnz;
+  while(lo < hi){
+    const szmat_t mid = lo + (hi - lo) / 2;
+    if(row[mid] < j){
+      lo = mid + 1;
+    }
+    else{
+      hi = mid;
+    }
+  }
+  return (lo < nnz && row[lo] == j) ? row[nnz + lo] : 0;
+}
+
+/* overwrites the entries idx[0], ..., idx[n-1] of mat with w. For a
+ * compressed matrix, the rows are rebuilt with these entries only, they are
+ * expected by increasing rows and those lying in a row already rebuilt are
+ * skipped. */
+static inline void sp_matfglm_set_entries(sp_matfglm_t *mat, const uint64_t *idx,
+                                          const CF_t *w, const uint64_t n){
+  if(!sp_matfglm_is_compressed(mat)){
+    for(uint64_t k = 0; k < n; k++){
+      mat->dense_mat[idx[k]] = w[k];
+    }
+    return;
+  }
+  uint64_t k = 0;
+  for(szmat_t i = 0; i < mat->nrows; i++){
+    while(k < n && idx[k] / mat->ncols <= i){
+      if(idx[k] / mat->ncols == i){
+        mat->cmp_buf[idx[k] % mat->ncols] = w[k];
+      }
+      k++;
+    }
+    sp_matfglm_compress_row(mat, i, mat->cmp_buf);
+  }
+}
+
+/* number of zero entries of the nrows x ncols non-trivial part of mat */
+static inline uint64_t sp_matfglm_nzeros(const sp_matfglm_t *mat){
+  uint64_t nz = 0;
+  if(!sp_matfglm_is_compressed(mat)){
+    const uint64_t sz = (uint64_t)mat->nrows * mat->ncols;
+    for(uint64_t i = 0; i < sz; i++){
+      nz += (mat->dense_mat[i] == 0);
+    }
+    return nz;
+  }
+  for(szmat_t i = 0; i < mat->nrows; i++){
+    const CF_t *row = mat->cmp_data + mat->cmp_off[i];
+    nz += mat->ncols;
+    if(mat->cmp_nnz[i] == SP_MATFGLM_PACKED){
+      for(szmat_t j = 0; j < mat->ncols - mat->dst[i]; j++){
+        nz -= (row[j] != 0);
+      }
+    }
+    else{
+      nz -= mat->cmp_nnz[i];
+    }
+  }
+  return nz;
+}
+
+/* dot product of row i of mat with vec[0], vec[stride], ... modulo prime */
+static inline CF_t sp_matfglm_row_dot(const sp_matfglm_t *mat, const szmat_t i,
+                                      const CF_t *vec, const szmat_t stride,
+                                      const mod_t prime){
+  const uint64_t sq = (uint64_t)prime * prime;
+  const uint64_t red = ((UINT64_C(1) << 63) / sq) * sq;
+  uint64_t acc = 0;
+  const CF_t *row;
+  const szmat_t len = sp_matfglm_packed_row(mat, i, &row);
+  if(!sp_matfglm_is_compressed(mat) || mat->cmp_nnz[i] == SP_MATFGLM_PACKED){
+    for(szmat_t k = 0; k < len; k++){
+      acc += (uint64_t)row[k] * vec[(uint64_t)k * stride];
+      acc -= (acc >> 63) * red;
+    }
+  }
+  else{
+    const szmat_t nnz = mat->cmp_nnz[i];
+    for(szmat_t k = 0; k < nnz; k++){
+      acc += (uint64_t)row[nnz + k] * vec[(uint64_t)row[k] * stride];
+      acc -= (acc >> 63) * red;
+    }
+  }
+  return acc % prime;
+}
+
 static inline fglm_data_t *allocate_fglm_data(szmat_t nrows, szmat_t ncols, szmat_t nvars){
   fglm_data_t * data = malloc(sizeof(fglm_data_t));
 
@@ -96,9 +342,9 @@ static inline void display_fglm_matrix(FILE *file, sp_matfglm_t *matrix){
   fprintf(file, "%u\n", matrix->ncols);
   fprintf(file, "%u\n", matrix->nrows);
 
-  szmat_t len1 = (matrix->ncols)*(matrix->nrows);
-  for(szmat_t i = 0; i < len1; i++){
-    fprintf(file, "%d ", matrix->dense_mat[i]);
+  uint64_t len1 = (uint64_t)(matrix->ncols)*(matrix->nrows);
+  for(uint64_t i = 0; i < len1; i++){
+    fprintf(file, "%d ", sp_matfglm_entry(matrix, i));
   }
   fprintf(file, "\n");
   szmat_t len2 = (matrix->ncols) - (matrix->nrows);
@@ -51,6 +51,21 @@ int nmod_fglm_compute_apply_trace_data(sp_matfglm_t *,
                                        const long,
                                        const int,
                                        md_t *);
+void nmod_fglm_compute_apply_trace_data_multi(sp_matfglm_t **,
+                                              const mod_t *,
+                                              const int,
+                                              param_t **,
+                                              const long,
+                                              const long,
+                                              nvars_t *,
+                                              nvars_t **,
+                                              uint32_t **,
+                                              nvars_t **,
+                                              fglm_data_t **,
+                                              fglm_bms_data_t **,
+                                              const long,
+                                              uint32_t *,
+                                              md_t *);
 
 void display_fglm_param(FILE *, param_t *);
 void display_fglm_param_maple(FILE *, param_t *);
@@ -40,7 +40,9 @@ double omp_get_wtime(void) { return realtime();}
 #define MIN(x, y) ((x) > (y) ? (y) : (x))
 
 #define DEBUGFGLM 0
-//#define BLOCKWIED 0
+/* block Wiedemann sequences are used from dimension st->bw_min_dim of the
+ * quotient on, comment out BLOCKWIED to only use the scalar sequence */
+#define BLOCKWIED 1
 
 #include <flint/fmpz.h>
 #include <flint/nmod_poly.h>
@@ -347,63 +349,126 @@ static int invert_hankel_matrix(fglm_bms_data_t *data_bms, szmat_t dim){
 }
 
 
+/*
+  Temporaries for the computation of one coordinate of the
+  parametrization. Once the inverse of the Hankel matrix (resp. of the
+  table polynomial modulo elim) is known, coordinates are independent and
+  are computed in parallel, each thread using its own temporaries.
+ */
+typedef struct{
+  nmod_poly_t V;
+  nmod_poly_t A;
+  nmod_poly_t B;
+  nmod_poly_t T;
+  nmod_poly_t Z;
+  nmod_poly_t P; /* computed coordinate */
+} coord_tmp_t;
+
+static inline void coord_tmp_init(coord_tmp_t *t, const mod_t prime){
+  nmod_poly_init(t->V, prime);
+  nmod_poly_init(t->A, prime);
+  nmod_poly_init(t->B, prime);
+  nmod_poly_init(t->T, prime);
+  nmod_poly_init(t->Z, prime);
+  nmod_poly_init(t->P, prime);
+}
+
+static inline void coord_tmp_clear(coord_tmp_t *t){
+  nmod_poly_clear(t->V);
+  nmod_poly_clear(t->A);
+  nmod_poly_clear(t->B);
+  nmod_poly_clear(t->T);
+  nmod_poly_clear(t->Z);
+  nmod_poly_clear(t->P);
+}
+
 /*
  Z1 and Z2 must be arrays of length d + 1
  Mirroring them will give an array of length d + 1
+
+ The mirrors rZ1 and rZ2 do not depend on the coordinate, they are
+ computed once by mirror_hankel_inverse before calling solve_hankel.
  */
 
-static inline void solve_hankel(fglm_bms_data_t *data_bms,
+static inline void mirror_hankel_inverse(fglm_bms_data_t *data_bms,
+                                         szmat_t dim){
+  mirror_poly_solve(data_bms->rZ1, data_bms->Z1, dim + 1);
+  mirror_poly_solve(data_bms->rZ2, data_bms->Z2, dim + 1);
+}
+
+/* data_bms is only read, the solution is stored in t->P */
+static inline void solve_hankel(coord_tmp_t *t,
+                                const fglm_bms_data_t *data_bms,
                                 szmat_t dim,
                                 szmat_t block_size,
                                 CF_t *res,
                                 int ncoord){
-  data_bms->V->length = dim;
+  nmod_poly_fit_length(t->V, dim);
+  t->V->length = dim;
 
   for(szmat_t i = 0; i < dim; i++){
-    data_bms->V->coeffs[i] = res[ncoord-1+i*(block_size)];
+    t->V->coeffs[i] = res[ncoord-1+i*(block_size)];
   }
 
   #if DEBUGFGLM > 0
   fprintf(VERBSTREAM, "\n ncoord = %d\n", ncoord);
   fprintf(VERBSTREAM, "V = ");
-  nmod_poly_fprint_pretty(VERBSTREAM, data_bms->V, "x");
+  nmod_poly_fprint_pretty(VERBSTREAM, t->V, "x");
   fprintf(VERBSTREAM, "\n");
   #endif
 
-  mirror_poly_inplace(data_bms->V);
-  mirror_poly_solve(data_bms->rZ1, data_bms->Z1, dim + 1);
-  mirror_poly_solve(data_bms->rZ2, data_bms->Z2, dim + 1);
+  mirror_poly_inplace(t->V);
 
-  nmod_poly_mullow(data_bms->A, data_bms->rZ1, data_bms->V, dim); // mod t^dim
-  nmod_poly_mullow(data_bms->B, data_bms->Z2, data_bms->V, dim); // mod t^dim
+  nmod_poly_mullow(t->A, data_bms->rZ1, t->V, dim); // mod t^dim
+  nmod_poly_mullow(t->B, data_bms->Z2, t->V, dim); // mod t^dim
 
-  mirror_poly_solve(data_bms->rZ1, data_bms->B, dim);
+  mirror_poly_solve(t->T, t->B, dim);
+  nmod_poly_mullow(t->B, data_bms->Z1, t->T, dim);
+  mirror_poly_solve(t->T, t->A, dim);
+  nmod_poly_mullow(t->A, data_bms->rZ2, t->T, dim);
 
-  for(szmat_t i = 0; i < dim ; i++){
-    data_bms->B->coeffs[i] = data_bms->rZ1->coeffs[i];
-  }
-  data_bms->B->length = data_bms->rZ1->length;
-  mirror_poly_solve(data_bms->rZ1, data_bms->A, dim);
-  for(szmat_t i = 0; i < dim ; i++){
-    data_bms->A->coeffs[i] = data_bms->rZ1->coeffs[i];
-  }
-  data_bms->A->length = data_bms->rZ1->length;
-
-  nmod_poly_mullow(data_bms->rZ1, data_bms->Z1, data_bms->B, dim);
-  nmod_poly_mullow(data_bms->rZ2, data_bms->rZ2, data_bms->A, dim);
-
-  nmod_poly_neg(data_bms->rZ2, data_bms->rZ2);
-
-  nmod_poly_add(data_bms->param, data_bms->rZ1, data_bms->rZ2);
+  nmod_poly_sub(t->P, t->B, t->A);
 
   mp_limb_t inv = n_invmod(data_bms->Z1->coeffs[0], (data_bms->Z1->mod).n);
 
-  nmod_poly_scalar_mul_nmod(data_bms->param, data_bms->param, inv);
+  nmod_poly_scalar_mul_nmod(t->P, t->P, inv);
 
 }
 
 
 
+/* product of the non-trivial part of a compressed matrix with vec: packed
+ * rows use the dense dot products, sparse rows their CSR entries */
+static inline void compressed_matrix_vector_product(CF_t *vres,
+                                                    const sp_matfglm_t *mat,
+                                                    const CF_t *vec,
+                                                    const mod_t prime,
+                                                    md_t *st){
+#if defined(HAVE_AVX512_F) || defined(HAVE_AVX2)
+  nmod_t mod;
+  uint64_t pow2_precomp;
+  nmod_init(&mod, (uint64_t)prime);
+  NMOD_RED(pow2_precomp, (UINT64_C(1) << __DOT_SPLIT_BITS), mod);
+#endif
+  const szmat_t nrows = mat->nrows;
+#pragma omp parallel for num_threads (st->nthrds) schedule(dynamic, 16)
+  for(szmat_t i = 0; i < nrows; i++){
+    if(mat->cmp_nnz[i] != SP_MATFGLM_PACKED){
+      vres[i] = sp_matfglm_row_dot(mat, i, vec, 1, prime);
+      continue;
+    }
+    const CF_t *row = mat->cmp_data + mat->cmp_off[i];
+    const szmat_t len = mat->ncols - mat->dst[i];
+#if defined(HAVE_AVX512_F)
+    vres[i] = _nmod32_vec_dot_split_avx512(vec, row, len, mod, pow2_precomp);
+#elif defined(HAVE_AVX2)
+    vres[i] = _nmod32_vec_dot_split_avx2(vec, row, len, mod, pow2_precomp);
+#else
+    non_avx_matrix_vector_product(vres + i, row, vec, len, 1, prime);
+#endif
+  }
+}
+
 /*
 
 Matrix vector product.
@@ -423,6 +488,13 @@ static inline void sparse_mat_fglm_mult_vec(CF_t *res, sp_matfglm_t *mat,
   for(szmat_t i = 0; i < ntriv; i++){
     res[mat->triv_idx[i]] = vec[mat->triv_pos[i]];
   }
+  if(sp_matfglm_is_compressed(mat)){
+    compressed_matrix_vector_product(vres, mat, vec, prime, st);
+    for(szmat_t i = 0; i < nrows; i++){
+      res[mat->dense_idx[i]] = vres[i];
+    }
+    return;
+  }
 #if defined(HAVE_AVX512_F)
   nmod_t mod;
   uint64_t pow2_precomp;
@@ -545,83 +617,6 @@ static inline void mynmod_berlekamp_massey_print_poly(FILE *file,
 }
 #endif
 
-#ifdef BLOCKWIED
-static void generate_matrix_sequence(sp_matfglm_t *matxn, fglm_data_t *data,
-                                     szmat_t block_size, long dimquot,
-                                     nvars_t* squvars,
-                                     nvars_t* linvars,
-                                     long nvars,
-                                     mod_t prime,
-                                     md_t *st){
-  uint32_t RED_32 = ((uint64_t)2<<31) % prime;
-  uint32_t RED_64 = ((uint64_t)1<<63) % prime;
-  RED_64 = (RED_64*2) % prime;
-
-  const uint32_t preinv = 2^(62) / prime;
-
-  const szmat_t ncols = matxn->ncols;
-  const szmat_t nrows = matxn->nrows;
-
-  int BL = 0;
-  if(nvars < 16){
-      BL = 16;
-  }
-  else{
-      BL = 32;
-  }
-
-  /* allocates random matrix */
-  CF_t *Rmat ALIGNED32;
-  if(posix_memalign((void **)&Rmat, 32, BL*ncols*sizeof(CF_t))){
-    fprintf(ERRSTREAM, "posix_memalign failed\n");
-    exit(1);
-  }
-  memset(Rmat, 0, (ncols)*sizeof(CF_t));
-  for(szmat_t i = 0; i < BL*ncols; i++){
-    Rmat[i] = 0;
-  }
-  for(szmat_t i = 0; i < matxn->ncols; i++){
-    Rmat[i] = (CF_t)rand() % prime;
-    Rmat[i] += (CF_t)rand() % prime;
-  }
-
-  /* allocates result matrix (matxn * Rmat) */
-  CF_t *res ALIGNED32;
-  if(posix_memalign((void **)&res, 32, BL*ncols*sizeof(CF_t))){
-    fprintf(ERRSTREAM, "posix_memalign failed\n");
-    exit(1);
-  }
-  memset(res, 0, BL*ncols*sizeof(CF_t));
-
-  /* allocates temporary matrix */
-  CF_t *tres ALIGNED32;
-  if(posix_memalign((void **)&tres, 32, nrows*ncols*sizeof(CF_t))){
-    fprintf(ERRSTREAM, "posix_memalign failed\n");
-    exit(1);
-  }
-  memset(tres, 0, nrows*ncols*sizeof(CF_t));
-
-  szmat_t nb = 2 * matxn->ncols / BL;
-  for(szmat_t i = 0; i < nb; i++){
-#ifdef HAVE_AVX2
-    sparse_matfglm_mul(res, matxn, Rmat,
-                       tres,
-                       BL,
-                       prime, preinv,
-                       RED_32,
-                       RED_64);
-#else
-    fprintf(ERRSTREAM, "Not implemented yet\n");
-    exit(1);
-#endif
-  }
-  posix_memalign_free(Rmat);
-  posix_memalign_free(res);
-  posix_memalign_free(tres);
-
-}
-#endif
-
 static void generate_sequence_verif(sp_matfglm_t *matrix, fglm_data_t * data,
                                     szmat_t block_size, szmat_t dimquot,
                                     nvars_t* squvars,
@@ -705,6 +700,183 @@ static void generate_sequence_verif(sp_matfglm_t *matrix, fglm_data_t * data,
 
 
 
+#ifdef HAVE_AVX2
+/* dst[idx[r]] = src[pos[r]] for the blocks of np entries of interleaved
+ * vectors, np is a constant at the call sites */
+static inline void interleaved_copy(CF_t *dst, const CF_t *src,
+                                    const szmat_t *idx, const szmat_t *pos,
+                                    const szmat_t len, const int np){
+  for(szmat_t r = 0; r < len; r++){
+    memcpy(dst + (uint64_t)idx[r] * np, src + (uint64_t)pos[r] * np,
+           np * sizeof(CF_t));
+  }
+}
+
+/*
+
+  Same sequences as generate_sequence_verif for the np = 4 or 8 primes of
+  primes[], the multiplication matrices having the same trivial rows and
+  dense row indices (they come from the same trace data). The dense parts
+  and the vectors are interleaved, entry k of prime q being at k*np+q, so
+  that one pass over the index arrays and the dense parts serves all
+  primes, see _avx2_matrix_vector_product_multi.
+
+ */
+static void generate_sequence_multi(sp_matfglm_t **matrices,
+                                    fglm_data_t **data,
+                                    const int np,
+                                    szmat_t block_size,
+                                    nvars_t **squvars,
+                                    nvars_t *linvars,
+                                    nvars_t nvars,
+                                    const mod_t *primes,
+                                    md_t *st)
+{
+  const sp_matfglm_t *mat = matrices[0];
+  const szmat_t ncols = mat->ncols;
+  const szmat_t nrows = mat->nrows;
+  const szmat_t ntriv = ncols - nrows;
+
+  nmod_t mod[8];
+  uint64_t pow2_precomp[8];
+  for(int q = 0; q < np; q++){
+    nmod_init(&mod[q], (uint64_t)primes[q]);
+    NMOD_RED(pow2_precomp[q], (UINT64_C(1) << __DOT_SPLIT_BITS), mod[q]);
+  }
+
+  /* position of the entries copied in the second half of data->res */
+  szmat_t *sqpos = (szmat_t *)malloc(block_size * sizeof(szmat_t));
+  int dec= 0;
+  for(szmat_t j = 1; j < block_size; j++){
+    while (nvars-1-j-dec > 0 && linvars[nvars-1-j-dec] != 0) {
+      dec++;
+    }
+    sqpos[j] = nvars-1-j-dec;
+  }
+
+  /* trailing zeros common to all primes */
+  szmat_t *dst = (szmat_t *)malloc(nrows * sizeof(szmat_t));
+  for(szmat_t i = 0; i < nrows; i++){
+    dst[i] = mat->dst[i];
+    for(int q = 1; q < np; q++){
+      dst[i] = MIN(dst[i], matrices[q]->dst[i]);
+    }
+  }
+
+  CF_t *imat = (CF_t *)malloc((uint64_t)nrows * ncols * np * sizeof(CF_t));
+#pragma omp parallel for num_threads (st->nthrds)
+  for(szmat_t i = 0; i < nrows; i++){
+    CF_t *irow = imat + (uint64_t)i * ncols * np;
+    for(int q = 0; q < np; q++){
+      const CF_t *row = matrices[q]->dense_mat + (uint64_t)i * ncols;
+      for(szmat_t k = 0; k < ncols; k++){
+        irow[(uint64_t)k * np + q] = row[k];
+      }
+    }
+  }
+
+  CF_t *vin = (CF_t *)malloc((uint64_t)ncols * np * sizeof(CF_t));
+  CF_t *vout = (CF_t *)malloc((uint64_t)ncols * np * sizeof(CF_t));
+  CF_t *vres = (CF_t *)malloc((uint64_t)nrows * np * sizeof(CF_t));
+  for(int q = 0; q < np; q++){
+    for(szmat_t k = 0; k < ncols; k++){
+      vin[(uint64_t)k * np + q] = data[q]->vecinit[k];
+    }
+    for(szmat_t j = 1; j < block_size; j++){
+      data[q]->res[j+ncols*block_size]
+        = data[q]->vecinit[squvars[q][sqpos[j]]];
+    }
+  }
+
+  for(szmat_t i = 1; i < 2*ncols; i++){
+    if(np == 8){
+      interleaved_copy(vout, vin, mat->triv_idx, mat->triv_pos, ntriv, 8);
+    }
+    else{
+      interleaved_copy(vout, vin, mat->triv_idx, mat->triv_pos, ntriv, 4);
+    }
+    _avx2_matrix_vector_product_multi(vres, imat, vin, dst, ncols, nrows,
+                                      np, mod, pow2_precomp, st->nthrds);
+    for(szmat_t r = 0; r < nrows; r++){
+      memcpy(vout + (uint64_t)mat->dense_idx[r] * np,
+             vres + (uint64_t)r * np, np * sizeof(CF_t));
+    }
+    CF_t *tmp = vin;
+    vin = vout;
+    vout = tmp;
+    for(int q = 0; q < np; q++){
+      CF_t *res = data[q]->res;
+      res[i*block_size] = vin[q];
+      if(i < ncols){
+        for(szmat_t j = 1; j < block_size; j++){
+          res[j+i*block_size] = vin[(uint64_t)(j+1) * np + q];
+          res[j+(i+ncols)*block_size]
+            = vin[(uint64_t)squvars[q][sqpos[j]] * np + q];
+        }
+      }
+    }
+  }
+
+  for(int q = 0; q < np; q++){
+    for(ulong i = 0; i < 2 * (ulong)ncols; i++){
+      data[q]->pts[i] = data[q]->res[i*block_size];
+    }
+  }
+  free(sqpos);
+  free(dst);
+  free(imat);
+  free(vin);
+  free(vout);
+  free(vres);
+}
+
+/* the sequences of np primes are generated together if the part of the
+ * interleaved dense rows of each thread fits in about a L2 cache, and, with
+ * several threads, if it is large enough for the products to outweigh the
+ * synchronisation of the threads after each of them, unless the environment
+ * variable MSOLVE_FGLM_MULTI_PRIME_MIN gives another lower bound (0 e.g. to
+ * test it on small inputs) */
+#define MULTI_PRIME_MAX_BYTES (UINT64_C(1) << 20)
+#define MULTI_PRIME_MIN_ENTRIES (UINT64_C(1) << 14)
+
+static inline uint64_t multi_prime_sequence_min(void){
+  const char *val = getenv("MSOLVE_FGLM_MULTI_PRIME_MIN");
+  if(val != NULL && *val != '\0'){
+    return strtoull(val, NULL, 10);
+  }
+  return MULTI_PRIME_MIN_ENTRIES;
+}
+
+static inline int multi_prime_sequence_fits(const sp_matfglm_t *mat,
+                                            const int np, const int nthrds,
+                                            const uint64_t min){
+  const uint64_t entries = (uint64_t)np * mat->nrows * mat->ncols / nthrds;
+  return entries * sizeof(CF_t) <= MULTI_PRIME_MAX_BYTES
+    && (nthrds == 1 || entries >= min);
+}
+
+/* checks if the sequence modulo prime can be generated together with the
+ * one of the reference matrix ref by generate_sequence_multi */
+static inline int multi_prime_sequence_compatible(const sp_matfglm_t *ref,
+                                                  const nvars_t *reflinvars,
+                                                  const sp_matfglm_t *mat,
+                                                  const nvars_t *linvars,
+                                                  const mod_t prime,
+                                                  const long nvars){
+  if(sp_matfglm_is_compressed(mat) || prime > DOT2_ACC8_MAX_MODULUS){
+    return 0;
+  }
+  if(mat->ncols != ref->ncols || mat->nrows != ref->nrows){
+    return 0;
+  }
+  const szmat_t ntriv = mat->ncols - mat->nrows;
+  return memcmp(mat->triv_idx, ref->triv_idx, ntriv * sizeof(szmat_t)) == 0
+    && memcmp(mat->triv_pos, ref->triv_pos, ntriv * sizeof(szmat_t)) == 0
+    && memcmp(mat->dense_idx, ref->dense_idx, mat->nrows * sizeof(szmat_t)) == 0
+    && memcmp(linvars, reflinvars, nvars * sizeof(nvars_t)) == 0;
+}
+#endif
+
 static inline void compute_elim_poly(fglm_data_t *data,
                                      fglm_bms_data_t *data_bms,
                                      long dimquot){
@@ -866,7 +1038,8 @@ static int compute_parametrizations(param_t *param,
                                     szmat_t nlins,
                                     nvars_t *linvars,
                                     uint32_t *lineqs,
-                                    szmat_t nvars){
+                                    szmat_t nvars,
+                                    const int nthrds){
 
   nmod_poly_one(param->denom);
 
@@ -881,39 +1054,56 @@ static int compute_parametrizations(param_t *param,
 
   if(b){
 
+    /* column of data->res read for coordinate nvars-2-nc */
+    long *col = (long *)malloc(nvars * sizeof(long));
     szmat_t dec = 0;
-
     for(nvars_t nc = 0; nc < (int)nvars - 1 ; nc++){
+      col[nc] = nc + 2 - dec;
+      if(linvars[nvars - 2 - nc] != 0){
+        dec++;
+      }
+    }
+    if(nlins != nvars){
+      mirror_hankel_inverse(data_bms, dim);
+    }
 
-      if(linvars[nvars - 2- nc] == 0){
-        solve_hankel(data_bms, dim, block_size, data->res,
-                     nc + 2 - dec);
+#pragma omp parallel num_threads (nthrds)
+    {
+      coord_tmp_t t;
+      coord_tmp_init(&t, param->elim->mod.n);
+#pragma omp for schedule(dynamic)
+      for(nvars_t nc = 0; nc < (int)nvars - 1 ; nc++){
 
-        nmod_poly_neg(data_bms->param, data_bms->param);
-        nmod_poly_reverse(param->coords[nvars-2-nc], data_bms->param, dim);
-        nmod_poly_rem(param->coords[nvars-2-nc], param->coords[nvars-2-nc],
-                      param->elim);
+        if(linvars[nvars - 2- nc] == 0){
+          solve_hankel(&t, data_bms, dim, block_size, data->res, col[nc]);
+
+          nmod_poly_neg(t.P, t.P);
+          nmod_poly_reverse(param->coords[nvars-2-nc], t.P, dim);
+          nmod_poly_rem(param->coords[nvars-2-nc], param->coords[nvars-2-nc],
+                        param->elim);
 
 #if DEBUGFGLM > 0
-        nmod_poly_fprint_pretty(VERBSTREAM, param->coords[nvars-2-nc], "X");
-        fprintf(VERBSTREAM, "\n");
+          nmod_poly_fprint_pretty(VERBSTREAM, param->coords[nvars-2-nc], "X");
+          fprintf(VERBSTREAM, "\n");
 #endif
 
-      }
-      else{
-        if(param->coords[nvars-2-nc]->alloc <  param->elim->alloc - 1){
-          nmod_poly_fit_length(param->coords[nvars-2-nc],
-                               param->elim->length-1 );
         }
+        else{
+          if(param->coords[nvars-2-nc]->alloc <  param->elim->alloc - 1){
+            nmod_poly_fit_length(param->coords[nvars-2-nc],
+                                 param->elim->length-1 );
+          }
 
-        param->coords[nvars-2-nc]->length = param->elim->length-1 ;
+          param->coords[nvars-2-nc]->length = param->elim->length-1 ;
 
-        for(deg_t i = 0; i < param->elim->length-1 ; i++){
-          param->coords[nvars-2-nc]->coeffs[i] = 0;
+          for(deg_t i = 0; i < param->elim->length-1 ; i++){
+            param->coords[nvars-2-nc]->coeffs[i] = 0;
+          }
         }
-        dec++;
       }
+      coord_tmp_clear(&t);
     }
+    free(col);
 
     set_param_linear_vars(param, nlins, linvars, lineqs, nvars);
 
@@ -929,50 +1119,283 @@ static int compute_parametrizations(param_t *param,
   }
 }
 
-static inline int invert_table_polynomial (param_t *param,
+#ifdef BLOCKWIED
+static inline int use_block_wiedemann(const md_t *st, const long dimquot){
+  const long min_dim = st->bw_min_dim > 0 ? st->bw_min_dim : BLOCKWIED_MIN_DIM;
+  return dimquot >= min_dim;
+}
+
+/* xorshift generator, same as for the random values of the hash tables */
+static inline uint32_t block_wiedemann_random(uint32_t *seed){
+  uint32_t rseed = *seed;
+  rseed ^= (rseed << 13);
+  rseed ^= (rseed >> 17);
+  rseed ^= (rseed << 5);
+  *seed = rseed;
+  return rseed;
+}
+
+/*
+
+  Block Wiedemann computation of the parametrization, for ideals in shape
+  position with a squarefree eliminating polynomial of degree dimquot.
+
+  A block L of nb random linear forms (the first one is data->vecinit) is
+  multiplied by the multiplication matrix and, at each step, projected on
+  nb monomials of the basis: the block_size ones read by the scalar
+  sequence (1 and the variables to parametrize) and random other ones.
+  This gives the matrix sequence S_k = U M^k L for k < len.
+
+  Rows of minimal degree of an approximant basis of [S; -I] give, once
+  reversed, a left matrix generator P and a numerator N such that
+  S(T) = P(T)^(-1) N(T), and det P is the eliminating polynomial. Row i of
+  the first column of P^(-1) N is n_i / elim where n_i / n_0 is the i-th
+  coordinate of the solutions. The second column only serves to check the
+  result.
+
+  Returns 1 if param has been computed, 0 if one needs to fall back to the
+  scalar sequence (unlucky choices, non shape position, multiplicities).
+
+ */
+static int block_wiedemann_param(param_t *param, sp_matfglm_t *matxn,
+                                 fglm_data_t *data,
+                                 const szmat_t block_size,
+                                 const szmat_t nlins,
+                                 nvars_t *linvars,
+                                 uint32_t *lineqs,
+                                 const nvars_t nvars,
+                                 const mod_t prime,
+                                 md_t *st){
+  const szmat_t dimquot = matxn->ncols;
+  slong nb = (nvars < 16) ? 16 : 32;
+  if(nb < block_size){
+    nb = block_size;
+  }
+  if(4 * nb > (slong)dimquot){
+    return 0;
+  }
+  /* degrees of the generator are about dimquot / nb */
+  const slong len = 2 * ((dimquot + nb - 1) / nb) + 4;
+
+  /* random choices only depend on the prime, not on the calls to rand()
+   * made before, so that they do not depend on the order of the primes */
+  uint32_t rsd = 2463534242u ^ prime;
+
+  /* monomials on which the sequence is projected */
+  szmat_t *pos = (szmat_t *)malloc(nb * sizeof(szmat_t));
+  pos[0] = 0;
+  for(slong i = 1; i < block_size; i++){
+    pos[i] = i + 1;
+  }
+  for(slong i = block_size; i < nb; i++){
+    slong j;
+    do{
+      pos[i] = block_wiedemann_random(&rsd) % dimquot;
+      for(j = 0; j < i && pos[j] != pos[i]; j++);
+    } while(j < i);
+  }
+
+  CF_t *blk = (CF_t *)malloc(nb * dimquot * sizeof(CF_t));
+  CF_t *nblk = (CF_t *)malloc(nb * dimquot * sizeof(CF_t));
+  for(szmat_t k = 0; k < dimquot; k++){
+    blk[k * nb] = data->vecinit[k];
+    for(slong j = 1; j < nb; j++){
+      blk[k * nb + j] = block_wiedemann_random(&rsd) % prime;
+    }
+  }
+
+  nmod_poly_mat_t F;
+  nmod_poly_mat_init(F, 2 * nb, nb, prime);
+  for(slong i = 0; i < nb; i++){
+    for(slong j = 0; j < nb; j++){
+      nmod_poly_fit_length(nmod_poly_mat_entry(F, i, j), len);
+    }
+    nmod_poly_set_coeff_ui(nmod_poly_mat_entry(F, nb + i, i), 0, prime - 1);
+  }
+  for(slong k = 0; k < len; k++){
+    for(slong i = 0; i < nb; i++){
+      const CF_t *row = blk + (uint64_t)pos[i] * nb;
+      for(slong j = 0; j < nb; j++){
+        nmod_poly_mat_entry(F, i, j)->coeffs[k] = row[j];
+      }
+    }
+    if(k < len - 1){
+      sparse_matfglm_mul_block(nblk, matxn, blk, nb, prime, st);
+      CF_t *tmp = blk;
+      blk = nblk;
+      nblk = tmp;
+    }
+  }
+  for(slong i = 0; i < nb; i++){
+    for(slong j = 0; j < nb; j++){
+      _nmod_poly_set_length(nmod_poly_mat_entry(F, i, j), len);
+      _nmod_poly_normalise(nmod_poly_mat_entry(F, i, j));
+    }
+  }
+  free(pos);
+  free(blk);
+  free(nblk);
+
+  /* the shift on the columns of -I makes numerators of degree less than
+   * the one of the generator, as expected after reversal */
+  nmod_poly_mat_t appbas;
+  nmod_poly_mat_init(appbas, 2 * nb, 2 * nb, prime);
+  slong *shift = (slong *)calloc(2 * nb, sizeof(slong));
+  for(slong i = nb; i < 2 * nb; i++){
+    shift[i] = 1;
+  }
+  nmod_poly_mat_pmbasis(appbas, shift, F, len);
+  nmod_poly_mat_clear(F);
+
+  /* the generator is given by the nb rows of smallest shifted degree */
+  slong *perm = (slong *)malloc(2 * nb * sizeof(slong));
+  for(slong i = 0; i < 2 * nb; i++){
+    slong j = i;
+    while(j > 0 && shift[perm[j - 1]] > shift[i]){
+      perm[j] = perm[j - 1];
+      j--;
+    }
+    perm[j] = i;
+  }
+
+  nmod_poly_mat_t P, N, X;
+  nmod_poly_mat_init(P, nb, nb, prime);
+  nmod_poly_mat_init(N, nb, 2, prime);
+  nmod_poly_mat_init(X, nb, 2, prime);
+  for(slong i = 0; i < nb; i++){
+    const slong r = perm[i];
+    for(slong j = 0; j < nb; j++){
+      nmod_poly_reverse(nmod_poly_mat_entry(P, i, j),
+                        nmod_poly_mat_entry(appbas, r, j), shift[r] + 1);
+    }
+    for(slong j = 0; j < 2; j++){
+      nmod_poly_reverse(nmod_poly_mat_entry(N, i, j),
+                        nmod_poly_mat_entry(appbas, r, nb + j), shift[r]);
+    }
+  }
+  nmod_poly_mat_clear(appbas);
+  free(shift);
+  free(perm);
+
+  nmod_poly_t den, inv, tmp;
+  nmod_poly_init(den, prime);
+  nmod_poly_init(inv, prime);
+  nmod_poly_init(tmp, prime);
+
+  int b = nmod_poly_mat_solve(X, den, P, N);
+  b = b && (nmod_poly_degree(den) == (slong)dimquot);
+  if(b){
+    nmod_poly_make_monic(param->elim, den);
+    b = nmod_poly_is_squarefree(param->elim);
+  }
+  if(b){
+    for(slong i = 0; i < nb; i++){
+      for(slong j = 0; j < 2; j++){
+        nmod_poly_rem(nmod_poly_mat_entry(X, i, j),
+                      nmod_poly_mat_entry(X, i, j), param->elim);
+      }
+    }
+    b = !nmod_poly_is_zero(nmod_poly_mat_entry(X, 0, 0))
+      && nmod_poly_invmod(inv, nmod_poly_mat_entry(X, 0, 0), param->elim);
+  }
+  if(b){
+    szmat_t dec = 0;
+    for(nvars_t nc = 0; nc < nvars - 1 && b; nc++){
+      nmod_poly_struct *c = param->coords[nvars - 2 - nc];
+      if(linvars[nvars - 2 - nc] == 0){
+        /* same coordinate as the one read by solve_hankel */
+        const slong i = nc + 1 - dec;
+        nmod_poly_mulmod(c, nmod_poly_mat_entry(X, i, 0), inv, param->elim);
+        nmod_poly_neg(c, c);
+
+        /* the second linear form has to give the same coordinate */
+        nmod_poly_mulmod(tmp, c, nmod_poly_mat_entry(X, 0, 1), param->elim);
+        nmod_poly_add(tmp, tmp, nmod_poly_mat_entry(X, i, 1));
+        b = nmod_poly_is_zero(tmp);
+      }
+      else{
+        nmod_poly_fit_length(c, param->elim->length - 1);
+        c->length = param->elim->length - 1;
+        for(deg_t i = 0; i < param->elim->length - 1; i++){
+          c->coeffs[i] = 0;
+        }
+        dec++;
+      }
+    }
+  }
+  if(b){
+    nmod_poly_one(param->denom);
+    param->degelimpol = dimquot;
+    param->degsqfrelimpol = dimquot;
+    set_param_linear_vars(param, nlins, linvars, lineqs, nvars);
+  }
+
+  nmod_poly_clear(den);
+  nmod_poly_clear(inv);
+  nmod_poly_clear(tmp);
+  nmod_poly_mat_clear(P);
+  nmod_poly_mat_clear(N);
+  nmod_poly_mat_clear(X);
+  return b;
+}
+#endif
+
+/*
+  C is the table polynomial of coordinate ncoord (shifted by lambda times
+  the first one) and inv its inverse modulo elim. t->V, t->T and t->B are
+  used as temporaries, data_bms is only read.
+
+  returns 1 if C is invertible modulo elim.
+ */
+static inline int invert_table_polynomial (nmod_poly_t inv,
+                                           nmod_poly_t C,
+                                           coord_tmp_t *t,
+                                           param_t *param,
 					   fglm_data_t *data,
-					   fglm_bms_data_t *data_bms,
+					   const fglm_bms_data_t *data_bms,
 					   szmat_t block_size,
 					   mod_t prime,
 					   int ncoord,
 					   uint64_t lambda) {
 
   szmat_t length= data_bms->BMS->V1->length-1;
-  nmod_poly_zero(data_bms->BMS->R0);
-  nmod_poly_zero(data_bms->Z1);
-  nmod_poly_zero(data_bms->Z2);
-  nmod_poly_fit_length(data_bms->BMS->R0, length);
-  nmod_poly_fit_length(data_bms->BMS->R0, length);
+  nmod_poly_zero(t->V);
+  nmod_poly_zero(C);
+  nmod_poly_zero(inv);
+  nmod_poly_fit_length(t->V, length);
 
   for (long i = 0; i < length; i++){
 
     if (lambda == 0) {
-      nmod_poly_set_coeff_ui (data_bms->BMS->R0,i,
+      nmod_poly_set_coeff_ui (t->V,i,
 			      data->res[(length-i-1)*block_size+ncoord]);
     }
     else {
       uint64_t coeff= (lambda*data->res[(length-i-1)*block_size]) % prime;
       coeff= (data->res[(length-i-1)*block_size+ncoord] + coeff) % prime;
-      nmod_poly_set_coeff_ui (data_bms->BMS->R0,i,
+      nmod_poly_set_coeff_ui (t->V,i,
 			      coeff);
     }
 
   }
 
-  nmod_poly_zero(data_bms->BMS->R1);
+  nmod_poly_zero(t->B);
 
-  nmod_poly_mul (data_bms->Z1,data_bms->BMS->R0,data_bms->BMS->V1);
-  nmod_poly_shift_right (data_bms->Z1,data_bms->Z1,length);
-  nmod_poly_xgcd (data_bms->BMS->R0,data_bms->BMS->R1,data_bms->Z2,param->elim,
-		  data_bms->Z1);
+  nmod_poly_mul (C,t->V,data_bms->BMS->V1);
+  nmod_poly_shift_right (C,C,length);
+  nmod_poly_xgcd (t->T,t->B,inv,param->elim,C);
 
-  return (nmod_poly_degree (data_bms->BMS->R0) == 0);
+  return (nmod_poly_degree (t->T) == 0);
 }
 
 
-static inline void divide_table_polynomials (param_t *param,
+/* the result is stored in t->P, inv is the inverse computed by
+ * invert_table_polynomial, t->V is used as a temporary */
+static inline void divide_table_polynomials (coord_tmp_t *t,
+                                             const nmod_poly_t inv,
+                                             param_t *param,
 					     fglm_data_t *data,
-					     fglm_bms_data_t *data_bms,
+					     const fglm_bms_data_t *data_bms,
 					     ulong dimquot,
 					     szmat_t block_size,
 					     mod_t prime,
@@ -980,28 +1403,28 @@ static inline void divide_table_polynomials (param_t *param,
 					     uint64_t lambda) {
 
   szmat_t length= data_bms->BMS->V1->length-1;
-  nmod_poly_zero (data_bms->BMS->R0);
-  nmod_poly_fit_length(data_bms->BMS->R0, length);
-  nmod_poly_zero(data_bms->BMS->R1);
+  nmod_poly_zero (t->V);
+  nmod_poly_fit_length(t->V, length);
+  nmod_poly_zero(t->P);
 
   for (long i = 0; i < length; i++){
     if (lambda == 0) {
-      nmod_poly_set_coeff_ui (data_bms->BMS->R0,i,
+      nmod_poly_set_coeff_ui (t->V,i,
 			      data->res[(length-i-1)*block_size+ncoord]);
 
     }
     else {
       uint64_t coeff= (lambda*data->res[(length-i-1)*block_size+ncoord]) % prime;
       coeff= (data->res[(dimquot+length-i-1)*block_size+ncoord] + coeff) % prime;
-      nmod_poly_set_coeff_ui (data_bms->BMS->R0,i,
+      nmod_poly_set_coeff_ui (t->V,i,
 			      coeff);
     }
   }
 
-  nmod_poly_mul (data_bms->BMS->R1,data_bms->BMS->R0,data_bms->BMS->V1);
-  nmod_poly_shift_right (data_bms->BMS->R1,data_bms->BMS->R1,length);
-  nmod_poly_mul (data_bms->BMS->R1,data_bms->BMS->R1,data_bms->Z2);
-  nmod_poly_rem (data_bms->BMS->R1,data_bms->BMS->R1,param->elim);
+  nmod_poly_mul (t->P,t->V,data_bms->BMS->V1);
+  nmod_poly_shift_right (t->P,t->P,length);
+  nmod_poly_mul (t->P,t->P,inv);
+  nmod_poly_rem (t->P,t->P,param->elim);
 
 }
 
@@ -1054,10 +1477,15 @@ int compute_parametrizations_non_shape_position_case(param_t *param,
                                                      nvars_t *squvars,
                                                      long nvars,
                                                      mod_t prime,
-                                                     int verif){
+                                                     int verif,
+                                                     const int nthrds){
   int nr_fail_param=-1;
-  if (invert_table_polynomial (param, data, data_bms, block_size,
-                               prime, 0, 0)) {
+  coord_tmp_t t0;
+  coord_tmp_init(&t0, prime);
+  int b = invert_table_polynomial (data_bms->Z2, data_bms->Z1, &t0, param,
+                                   data, data_bms, block_size, prime, 0, 0);
+  coord_tmp_clear(&t0);
+  if (b) {
 #if DEBUGFGLM > 0
     fprintf (VERBSTREAM,"C1=");
     nmod_poly_fprint_pretty (VERBSTREAM, data_bms->Z1, "x"); fprintf (VERBSTREAM,"\n");
@@ -1065,104 +1493,104 @@ int compute_parametrizations_non_shape_position_case(param_t *param,
     nmod_poly_fprint_pretty (VERBSTREAM, data_bms->Z2, "x"); fprintf (VERBSTREAM,"\n");
 #endif
 
+    /* column of data->res read for coordinate nvars-2-nc, random shifts
+     * used for the verification and coordinates which do not check */
+    long *col = (long *)malloc(nvars * sizeof(long));
+    uint64_t *lambda = (uint64_t *)malloc(nvars * sizeof(uint64_t));
+    int *fail = (int *)calloc(nvars, sizeof(int));
     long dec = 0;
-
     for(long nc = 0; nc < nvars - 1 ; nc++){
-
-      if(linvars[nvars - 2 - nc] == 0){
-        divide_table_polynomials(param,data,data_bms, dimquot, block_size, prime,
-                                 nc + 1-dec,0);
-        if(data_bms->BMS->R1->length>0){
-          nmod_poly_neg(param->coords[nvars-2-nc], data_bms->BMS->R1);
-        }
-        else{
-          nmod_poly_fit_length(param->coords[nvars-2-nc],
-                               FLINT_MAX(2, param->elim->length-1) );
-          param->coords[nvars-2-nc]->length = data_bms->BMS->R1->length ;
-          param->coords[nvars-2-nc]->coeffs[0] = 0;
-          param->coords[nvars-2-nc]->coeffs[1] = 0;
-
-        }
-
-#if DEBUGFGLM > 0
-        nmod_poly_fprint_pretty(VERBSTREAM, param->coords[nvars-2-nc], "X");
-        fprintf(VERBSTREAM, "\n");
-#endif
-      }
-      else{
+      col[nc] = nc + 1 - dec;
+      lambda[nc] = 0;
+      if(linvars[nvars - 2 - nc] != 0){
         dec++;
-        if(param->coords[nvars-2-nc]->alloc <  param->elim->alloc - 1){
-          nmod_poly_fit_length(param->coords[nvars-2-nc],
-                               param->elim->length-1 );
-        }
-
-        param->coords[nvars-2-nc]->length = param->elim->length-1 ;
-
-        for(long i = 0; i < param->elim->length-1 ; i++){
-          param->coords[nvars-2-nc]->coeffs[i] = 0;
-        }
-
+      }
+      else if(verif && squvars[nvars - 2 - nc] != 0){
+        /* needed for verification */
+        lambda[nc] = 1 + ((uint64_t) rand() % (prime-1));
       }
     }
 
-    /* parametrizations verification */
-    if (verif) {
-      dec = 0;
+#pragma omp parallel num_threads (nthrds)
+    {
+      coord_tmp_t t;
+      coord_tmp_init(&t, prime);
+#pragma omp for schedule(dynamic)
       for(long nc = 0; nc < nvars - 1 ; nc++){
 
-        if(linvars[nvars - 2 - nc] == 0
-           && squvars[nvars - 2 - nc] != 0){
+        if(linvars[nvars - 2 - nc] == 0){
+          divide_table_polynomials(&t, data_bms->Z2, param, data, data_bms,
+                                   dimquot, block_size, prime, col[nc], 0);
+          if(t.P->length>0){
+            nmod_poly_neg(param->coords[nvars-2-nc], t.P);
+          }
+          else{
+            nmod_poly_fit_length(param->coords[nvars-2-nc],
+                                 FLINT_MAX(2, param->elim->length-1) );
+            param->coords[nvars-2-nc]->length = t.P->length ;
+            param->coords[nvars-2-nc]->coeffs[0] = 0;
+            param->coords[nvars-2-nc]->coeffs[1] = 0;
 
-          uint64_t lambda= 1 + ((uint64_t) rand() % (prime-1));
-          /* needed for verification */
+          }
 
-          invert_table_polynomial (param, data, data_bms, block_size,
-                                   prime, nc+1-dec, lambda);
+#if DEBUGFGLM > 0
+          nmod_poly_fprint_pretty(VERBSTREAM, param->coords[nvars-2-nc], "X");
+          fprintf(VERBSTREAM, "\n");
+#endif
+
+          /* parametrizations verification */
+          if(lambda[nc] != 0){
+            invert_table_polynomial (t.Z, t.A, &t, param, data, data_bms,
+                                     block_size, prime, col[nc], lambda[nc]);
 #if DEBUGFGLM > 1
-          fprintf (VERBSTREAM,"C2=");
-          nmod_poly_fprint_pretty (VERBSTREAM, data_bms->Z1, "x"); fprintf (VERBSTREAM,"\n");
-          fprintf(VERBSTREAM, "invC2=");
-          nmod_poly_fprint_pretty (VERBSTREAM, data_bms->Z2, "x"); fprintf (VERBSTREAM,"\n");
+            fprintf (VERBSTREAM,"C2=");
+            nmod_poly_fprint_pretty (VERBSTREAM, t.A, "x"); fprintf (VERBSTREAM,"\n");
+            fprintf(VERBSTREAM, "invC2=");
+            nmod_poly_fprint_pretty (VERBSTREAM, t.Z, "x"); fprintf (VERBSTREAM,"\n");
 #endif
 
-          divide_table_polynomials(param,data,data_bms, dimquot, block_size,
-                                   prime, nc+1-dec,lambda);
-          nmod_poly_neg(data_bms->BMS->R1, data_bms->BMS->R1);
+            divide_table_polynomials(&t, t.Z, param, data, data_bms, dimquot,
+                                     block_size, prime, col[nc], lambda[nc]);
+            nmod_poly_neg(t.P, t.P);
 
 #if DEBUGFGLM > 1
-          nmod_poly_fprint_pretty(VERBSTREAM, data_bms->BMS->R1, "X");
-          fprintf(VERBSTREAM, "\n");
+            nmod_poly_fprint_pretty(VERBSTREAM, t.P, "X");
+            fprintf(VERBSTREAM, "\n");
 #endif
 
-          if (! nmod_poly_equal (param->coords[nvars-2-nc],data_bms->BMS->R1)) {
-            if (nr_fail_param == -1) {
-              nr_fail_param= nvars-2-nc;
+            if (! nmod_poly_equal (param->coords[nvars-2-nc], t.P)) {
+              fail[nc] = 1;
             }
           }
-
         }
         else{
           /* might happen that the ideal is non radical and still some squared
              variables are not in the quotient.
              In that case, a random linear form has been introduced.
           */
-          if(linvars[nvars - 2 - nc] != 0){
+          long len = verif ? param->elim->length : param->elim->length-1;
+          if(param->coords[nvars-2-nc]->alloc < len){
+            nmod_poly_fit_length(param->coords[nvars-2-nc], len);
+          }
 
-            if(param->coords[nvars-2-nc]->alloc <  param->elim->alloc ){
-              nmod_poly_fit_length(param->coords[nvars-2-nc],
-                                   param->elim->alloc  );
-            }
-            param->coords[nvars-2-nc]->length = param->elim->length ;
-            for(long i = 0; i < param->elim->length ; i++){
-              param->coords[nvars-2-nc]->coeffs[i] = 0;
-            }
+          param->coords[nvars-2-nc]->length = len ;
+
+          for(long i = 0; i < len ; i++){
+            param->coords[nvars-2-nc]->coeffs[i] = 0;
           }
         }
-        if(linvars[nvars - 2 - nc] != 0){
-          dec++;
-        }
       }
+      coord_tmp_clear(&t);
     }
+    for(long nc = 0; nc < nvars - 1 ; nc++){
+      if(fail[nc]){
+        nr_fail_param= nvars-2-nc;
+        break;
+      }
+    }
+    free(col);
+    free(lambda);
+    free(fail);
 
     set_param_linear_vars(param, nlins, linvars, lineqs, nvars);
 
@@ -1189,8 +1617,10 @@ static int compute_parametrizations_colon(param_t *param,
 					  int verif){
 
   int nr_fail_param=-1;
-  if (invert_table_polynomial (param, data, data_bms, block_size,
-                               prime, 0, 0)) {
+  coord_tmp_t t;
+  coord_tmp_init(&t, prime);
+  if (invert_table_polynomial (data_bms->Z2, data_bms->Z1, &t, param, data,
+                               data_bms, block_size, prime, 0, 0)) {
 #if DEBUGFGLM > 0
     fprintf (VERBSTREAM,"C1=");
     nmod_poly_fprint_pretty (VERBSTREAM, data_bms->Z1, "x"); fprintf (VERBSTREAM,"\n");
@@ -1223,7 +1653,8 @@ static int compute_parametrizations_colon(param_t *param,
           uint64_t lambda= 1 + ((uint64_t) rand() % (prime-1));
           /* needed for verification */
 
-          invert_table_polynomial (param, data, data_bms, block_size,
+          invert_table_polynomial (data_bms->Z2, data_bms->Z1, &t, param,
+                                   data, data_bms, block_size,
                                    prime, nc+1-dec, lambda);
 #if DEBUGFGLM > 1
           fprintf (VERBSTREAM,"C2=");
@@ -1270,8 +1701,10 @@ static int compute_parametrizations_colon(param_t *param,
     display_fglm_param_maple(ERRSTREAM, param);
 #endif
 
+    coord_tmp_clear(&t);
     return nvars-1-nr_fail_param;
   } else {
+    coord_tmp_clear(&t);
     return 0;
   }
 }
@@ -1279,13 +1712,8 @@ static int compute_parametrizations_colon(param_t *param,
 static inline long initialize_fglm_data(sp_matfglm_t *matrix,
                                         fglm_data_t *data,
                                         const mod_t prime,
-                                        const szmat_t sz,
                                         const szmat_t block_size){
-  szmat_t nb = 0;
-  for(szmat_t i = 0; i < sz; i++){
-    if(matrix->dense_mat[i]==0)
-      nb++;
-  }
+  const long nb = sp_matfglm_nzeros(matrix);
   data->vecinit[0] = 1 + ((CF_t) rand() % (prime-1)); /* random, nonzero */
   for(szmat_t i = 1; i < matrix->ncols; i++){
     data->vecinit[i] = (CF_t)rand() % prime;
@@ -1356,10 +1784,8 @@ param_t *nmod_fglm_compute_trace_data(sp_matfglm_t *matrix, mod_t prime,
 
   param_t *param = allocate_fglm_param(prime, nvars);
 
-  szmat_t sz = matrix->ncols * matrix->nrows;
-
  restart:
-  initialize_fglm_data(matrix, *bdata, prime, sz, block_size);
+  initialize_fglm_data(matrix, *bdata, prime, block_size);
 
   /* if(info_level){ */
   /*   fprintf(ERRSTREAM, "[%u, %u], Dense / Total = %.2f%%\n", */
@@ -1374,17 +1800,32 @@ param_t *nmod_fglm_compute_trace_data(sp_matfglm_t *matrix, mod_t prime,
   double st_fglm = realtime();
   double cst_fglm = cputime();
 
-#if BLOCKWIED > 0
-  fprintf(ERRSTREAM, "Starts computation of matrix sequence\n");
-  double st0 = omp_get_wtime();
-  generate_matrix_sequence(matrix, *bdata, block_size, dimquot,
-                           squvars, linvars, nvars, prime, st);
-  double et0 = omp_get_wtime() - st0;
-  fprintf(ERRSTREAM, "Matrix sequence computed\n");
-  fprintf(ERRSTREAM, "Elapsed time : %.2f\n", et0);
-  fprintf(ERRSTREAM, "Implementation to be completed\n");
-  exit(1);
-#else
+#ifdef BLOCKWIED
+  if(use_block_wiedemann(st, dimquot)){
+    if (info_level > 1) {
+      fprintf(VERBSTREAM,
+              "block sequence and parametrizations                 ");
+      fflush(VERBSTREAM);
+    }
+    int b = block_wiedemann_param(param, matrix, *bdata, block_size,
+                                  nlins, linvars, lineqs, nvars, prime, st);
+    if(info_level > 1){
+      double rt_fglm = realtime()-st_fglm;
+      double crt_fglm = cputime()-cst_fglm;
+      fprintf (VERBSTREAM, "%15.2f | %-13.2f\n",rt_fglm,crt_fglm);
+    }
+    if(b){
+      /* Berlekamp-Massey data are used by the next primes */
+      *bdata_bms = allocate_fglm_bms_data(dimquot, prime);
+      goto end;
+    }
+    if(info_level > 1){
+      fprintf(VERBSTREAM, "falls back to the scalar sequence\n");
+    }
+    st_fglm = realtime();
+    cst_fglm = cputime();
+  }
+#endif
   if (info_level > 1) {
     fprintf(VERBSTREAM,
 	    "scalar sequence                                     ");
@@ -1392,7 +1833,6 @@ param_t *nmod_fglm_compute_trace_data(sp_matfglm_t *matrix, mod_t prime,
   }
   generate_sequence_verif(matrix, *bdata, block_size, dimquot,
                           squvars, linvars, nvars, prime, st);
-#endif
 
   if(info_level > 1){
     double rt_fglm = realtime()-st_fglm;
@@ -1440,7 +1880,7 @@ param_t *nmod_fglm_compute_trace_data(sp_matfglm_t *matrix, mod_t prime,
     if(compute_parametrizations(param, *bdata, *bdata_bms,
                                 dimquot, block_size,
                                 nlins, linvars, lineqs,
-                                nvars) == 0){
+                                nvars, st->nthrds) == 0){
 
       fprintf(ERRSTREAM, "Matrix is not invertible (there should be a bug)\n");
       return NULL;
@@ -1475,7 +1915,8 @@ param_t *nmod_fglm_compute_trace_data(sp_matfglm_t *matrix, mod_t prime,
                                                                       lineqs,
                                                                       squvars,
                                                                       nvars, prime,
-                                                                      1); /* verif */
+                                                                      1, /* verif */
+                                                                      st->nthrds);
 
     if (info_level > 1){
       double rt_fglm = realtime()-st_fglm;
@@ -1508,12 +1949,85 @@ param_t *nmod_fglm_compute_trace_data(sp_matfglm_t *matrix, mod_t prime,
 
     }
   }
+#ifdef BLOCKWIED
+ end:
+#endif
   st->fglm_rtime = realtime() - st->fglm_rtime;
   st->fglm_ctime = cputime() - st->fglm_ctime;
   print_fglm_data (VERBSTREAM, st, matrix, param);
   return param;
 }
 
+/*
+
+  Computes the parametrization modulo prime once the sequence of
+  data_fglm is known, common part of the application of the trace data
+  for one prime and for several primes.
+
+  Returns 0 if the computation is correct, else 1.
+
+ */
+static int apply_trace_data_from_sequence(sp_matfglm_t *matrix,
+                                          const mod_t prime,
+                                          param_t *param,
+                                          const long nvars,
+                                          const szmat_t block_size,
+                                          const long nlins,
+                                          nvars_t *linvars,
+                                          uint32_t *lineqs,
+                                          nvars_t *squvars,
+                                          fglm_data_t *data_fglm,
+                                          fglm_bms_data_t *data_bms,
+                                          const long deg_init,
+                                          const int info_level,
+                                          const int nthrds){
+  const ulong dimquot = (matrix->ncols);
+
+  double st_fglm = realtime();
+
+  fglm_bms_data_set_prime(data_bms, prime);
+
+  compute_minpoly(param, data_fglm, data_bms, dimquot);
+
+  if(info_level){
+    fprintf(VERBSTREAM, "Time spent to compute eliminating polynomial (elapsed): %.2f sec\n",
+            realtime()-st_fglm);
+  }
+  if(param->elim->length-1 != deg_init){
+    if(info_level){
+      fprintf(VERBSTREAM, "Warning: Degree of elim poly = %ld\n", param->elim->length-1);
+    }
+    return 1;
+  }
+
+  if (dimquot == (long unsigned int)(param->degelimpol)) {
+
+    if(compute_parametrizations(param, data_fglm, data_bms,
+				dimquot, block_size,
+				nlins, linvars, lineqs,
+				nvars, nthrds) == 0){
+
+      fprintf(ERRSTREAM, "Matrix is not invertible (there should be a bug)\n");
+      return 1;
+    }
+
+  } else {
+    /* parametrization of the radical */
+    compute_parametrizations_non_shape_position_case(param,
+                                                     data_fglm,
+                                                     data_bms,
+                                                     dimquot,
+                                                     block_size,
+                                                     nlins, linvars,
+                                                     lineqs,
+                                                     squvars,
+                                                     nvars, prime,
+                                                     1, nthrds);
+  }
+  return 0;
+}
+
+
 /*
 
   Fonction qui applique sparse FGLM apres le premier round dans
@@ -1549,7 +2063,7 @@ int nmod_fglm_compute_apply_trace_data(sp_matfglm_t *matrix,
   if(prime>=1518500213){
     fprintf(ERRSTREAM, "Prime %u is too large.\n", prime);
     fprintf(ERRSTREAM, "One needs to use update linear algebra fglm functions\n");
-    exit(1);
+    return 1;
   }
 
   /* block-size in  data->res */
@@ -1560,7 +2074,7 @@ int nmod_fglm_compute_apply_trace_data(sp_matfglm_t *matrix,
   fglm_param_set_prime(param, prime);
 
   const long sz = matrix->ncols * matrix->nrows;
-  const long nb = initialize_fglm_data(matrix, data_fglm, prime, sz, block_size);
+  const long nb = initialize_fglm_data(matrix, data_fglm, prime, block_size);
 
   if(info_level){
     fprintf(VERBSTREAM, "[%u, %u], Dense / Total = %.2f%%\n",
@@ -1580,6 +2094,19 @@ int nmod_fglm_compute_apply_trace_data(sp_matfglm_t *matrix,
 
   double st_fglm = realtime();
 
+#ifdef BLOCKWIED
+  if(use_block_wiedemann(st, dimquot) && (long)dimquot == deg_init
+     && block_wiedemann_param(param, matrix, data_fglm, block_size,
+                              nlins, linvars, lineqs, nvars, prime, st)){
+    if(info_level){
+      fprintf(VERBSTREAM, "Time spent in block Wiedemann (elapsed): %.2f sec\n",
+              realtime()-st_fglm);
+    }
+    fglm_bms_data_set_prime(data_bms, prime);
+    return 0;
+  }
+#endif
+
   //////////////////////////////////////////////////////////////////
 
   /* generate_sequence(matrix, data_fglm, block_size, dimquot, prime, st); */
@@ -1593,48 +2120,136 @@ int nmod_fglm_compute_apply_trace_data(sp_matfglm_t *matrix,
     fprintf(VERBSTREAM, "Time spent to generate sequence (elapsed): %.2f sec (%.2f Gops/sec)\n", rt_fglm, nops / rt_fglm);
   }
 
-  st_fglm = realtime();
+  return apply_trace_data_from_sequence(matrix, prime, param, nvars,
+                                        block_size, nlins, linvars, lineqs,
+                                        squvars, data_fglm, data_bms,
+                                        deg_init, info_level, st->nthrds);
+}
 
-  fglm_bms_data_set_prime(data_bms, prime);
+/*
 
-  compute_minpoly(param, data_fglm, data_bms, dimquot);
+  Applies sparse FGLM for the np primes of primes[]. Primes i with
+  bad[i] != 0 are skipped, bad[i] is set to 1 when the computation modulo
+  primes[i] is not correct.
 
-  if(info_level){
-    fprintf(VERBSTREAM, "Time spent to compute eliminating polynomial (elapsed): %.2f sec\n",
-            realtime()-st_fglm);
+  With AVX2, the sequences of groups of 8 (or 4) primes whose matrices
+  share their index arrays are generated together by
+  generate_sequence_multi, using all threads, if the sizes suit it, see
+  multi_prime_sequence_fits. The remaining primes go through
+  nmod_fglm_compute_apply_trace_data, one prime per thread, as do all
+  primes when block Wiedemann applies.
+
+ */
+void nmod_fglm_compute_apply_trace_data_multi(sp_matfglm_t **matrices,
+                                              const mod_t *primes,
+                                              const int np,
+                                              param_t **params,
+                                              const long nvars,
+                                              const long bsz,
+                                              nvars_t *nlins,
+                                              nvars_t **linvars,
+                                              uint32_t **lineqs,
+                                              nvars_t **squvars,
+                                              fglm_data_t **data_fglm,
+                                              fglm_bms_data_t **data_bms,
+                                              const long deg_init,
+                                              uint32_t *bad,
+                                              md_t *st){
+  const szmat_t block_size = bsz;
+  int ng = 0;
+  int *good = (int *)malloc(np * sizeof(int));
+  for(int i = 0; i < np; i++){
+    if(bad[i] == 0){
+      good[ng++] = i;
+    }
   }
-  if(param->elim->length-1 != deg_init){
-    if(info_level){
-      fprintf(VERBSTREAM, "Warning: Degree of elim poly = %ld\n", param->elim->length-1);
+  /* set for the primes whose sequence is already generated */
+  int *seq = (int *)calloc(np, sizeof(int));
+#ifdef HAVE_AVX2
+  int nm = 0;
+  int multi = ng >= 4;
+#ifdef BLOCKWIED
+  /* block sequences already share the index traffic between vectors */
+  if(multi && use_block_wiedemann(st, matrices[good[0]]->ncols)
+     && (long)matrices[good[0]]->ncols == deg_init){
+    multi = 0;
+  }
+#endif
+  int *grp = (int *)malloc(np * sizeof(int));
+  for(int q = 0; q < ng && multi; q++){
+    const int i = good[q];
+    const int ref = nm > 0 ? grp[0] : i;
+    if(multi_prime_sequence_compatible(matrices[ref], linvars[ref],
+                                       matrices[i], linvars[i],
+                                       primes[i], nvars)){
+      grp[nm++] = i;
     }
-    return 1;
   }
-
-  if (dimquot == (long unsigned int)(param->degelimpol)) {
-
-    if(compute_parametrizations(param, data_fglm, data_bms,
-				dimquot, block_size,
-				nlins, linvars, lineqs,
-				nvars) == 0){
-
-      fprintf(ERRSTREAM, "Matrix is not invertible (there should be a bug)\n");
-      exit(1);
+  const uint64_t min = multi_prime_sequence_min();
+  sp_matfglm_t *mats[8];
+  fglm_data_t *data[8];
+  nvars_t *squs[8];
+  mod_t ps[8];
+  for(int g = 0; ; ){
+    int w = 0;
+    if(nm - g >= 8 && multi_prime_sequence_fits(matrices[grp[g]], 8, st->nthrds, min)){
+      w = 8;
     }
-
-  } else {
-    /* parametrization of the radical */
-    compute_parametrizations_non_shape_position_case(param,
-                                                     data_fglm,
-                                                     data_bms,
-                                                     dimquot,
-                                                     block_size,
-                                                     nlins, linvars,
-                                                     lineqs,
-                                                     squvars,
-                                                     nvars, prime,
-                                                     1);
+    else{
+      if(nm - g >= 4 && multi_prime_sequence_fits(matrices[grp[g]], 4, st->nthrds, min)){
+        w = 4;
+      }
+    }
+    if(w == 0){
+      break;
+    }
+    for(int q = 0; q < w; q++){
+      const int i = grp[g+q];
+      mats[q] = matrices[i];
+      data[q] = data_fglm[i];
+      squs[q] = squvars[i];
+      ps[q] = primes[i];
+      fglm_param_set_prime(params[i], primes[i]);
+      initialize_fglm_data(matrices[i], data_fglm[i], primes[i], block_size);
+      seq[i] = 1;
+    }
+    generate_sequence_multi(mats, data, w, block_size, squs,
+                            linvars[grp[g]], nvars, ps, st);
+    g += w;
   }
-  return 0;
+  free(grp);
+#endif
+  /* a single prime keeps all threads for its products */
+  const int nthrds = st->nthrds;
+  if(ng > 1){
+    st->nthrds = 1;
+  }
+#pragma omp parallel for num_threads (nthrds) schedule(dynamic)
+  for(int q = 0; q < ng; q++){
+    const int i = good[q];
+    int err;
+    if(seq[i]){
+      err = apply_trace_data_from_sequence(matrices[i], primes[i], params[i],
+                                           nvars, block_size, nlins[i],
+                                           linvars[i], lineqs[i], squvars[i],
+                                           data_fglm[i], data_bms[i],
+                                           deg_init, 0, 1);
+    }
+    else{
+      err = nmod_fglm_compute_apply_trace_data(matrices[i], primes[i],
+                                               params[i], nvars, bsz,
+                                               nlins[i], linvars[i],
+                                               lineqs[i], squvars[i],
+                                               data_fglm[i], data_bms[i],
+                                               deg_init, 0, st);
+    }
+    if(err){
+      bad[i] = 1;
+    }
+  }
+  st->nthrds = nthrds;
+  free(seq);
+  free(good);
 }
 
 static inline void guess_minpoly_colon(param_t *param,
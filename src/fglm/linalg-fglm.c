@@ -656,6 +656,193 @@ static inline void _avx2_matrix_vector_product(uint32_t * vec_res,
     else if (nrows - i == 1)
         vec_res[i] = _nmod32_vec_dot_split_avx2(vec, mat + i*ncols, ncols - dst[i], mod, pow2_precomp);
 }
+
+/*------------------------------------------------------*/
+/* vectorized (AVX2) matrix vector product, np primes   */
+/*------------------------------------------------------*/
+
+// the matrices and vectors of np = 4 or 8 primes are interleaved: entry k
+// of prime q is at k*np + q, so one coefficient of the dense part is
+// loaded for all primes at once and each 64 bit lane accumulates the dot
+// product modulo one prime, as for a single prime 8 terms are accumulated
+// before splitting (modulus <= DOT2_ACC8_MAX_MODULUS)
+
+// reduces the split accumulators of np lanes into res[0..np-1]
+static inline
+void _nmod32_multi_reduce(uint32_t * res, const uint64_t * lo, const uint64_t * hi,
+                          const int np, const nmod_t * mod, const uint64_t * pow2_precomp)
+{
+    for (int q = 0; q < np; q++)
+    {
+        const uint64_t h = hi[q] + (lo[q] >> __DOT_SPLIT_BITS);
+        uint64_t r;
+        NMOD_RED(r, pow2_precomp[q] * h + (lo[q] & __DOT_SPLIT_MASK), mod[q]);
+        res[q] = (uint32_t)r;
+    }
+}
+
+// 8 primes, rows row0 and row1: the even primes are in the low 32 bit
+// words, the odd ones in the high 32 bit words of the 64 bit lanes, the
+// entries of vec are loaded once for both rows
+static inline
+void _nmod32_vec_dot2_multi8_split_avx2(uint32_t * res0, uint32_t * res1,
+                                        const uint32_t * vec,
+                                        const uint32_t * row0, const uint32_t * row1,
+                                        int64_t len, const nmod_t * mod,
+                                        const uint64_t * pow2_precomp)
+{
+    const __m256i low_bits = _mm256_set1_epi64x(__DOT_SPLIT_MASK);
+    __m256i dp_lo[4], dp_hi[4];
+    for (int l = 0; l < 4; l++)
+    {
+        dp_lo[l] = _mm256_setzero_si256();
+        dp_hi[l] = _mm256_setzero_si256();
+    }
+
+    // each pass accumulates at most 8 terms per lane before splitting
+    for (int64_t k = 0; k < len; k += 8)
+    {
+        const int64_t end = MIN(k+8, len);
+        for (int64_t j = k; j < end; j++)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i *) (vec+8*j));
+            __m256i m0 = _mm256_loadu_si256((const __m256i *) (row0+8*j));
+            __m256i m1 = _mm256_loadu_si256((const __m256i *) (row1+8*j));
+            dp_lo[0] = _mm256_add_epi64(dp_lo[0], _mm256_mul_epu32(m0, v));
+            dp_lo[2] = _mm256_add_epi64(dp_lo[2], _mm256_mul_epu32(m1, v));
+            v = _mm256_srli_epi64(v, 32);
+            m0 = _mm256_srli_epi64(m0, 32);
+            m1 = _mm256_srli_epi64(m1, 32);
+            dp_lo[1] = _mm256_add_epi64(dp_lo[1], _mm256_mul_epu32(m0, v));
+            dp_lo[3] = _mm256_add_epi64(dp_lo[3], _mm256_mul_epu32(m1, v));
+        }
+        for (int l = 0; l < 4; l++)
+        {
+            dp_hi[l] = _mm256_add_epi64(dp_hi[l], _mm256_srli_epi64(dp_lo[l], __DOT_SPLIT_BITS));
+            dp_lo[l] = _mm256_and_si256(dp_lo[l], low_bits);
+        }
+    }
+
+    uint64_t lo[2][8], hi[2][8], t[4];
+    for (int l = 0; l < 4; l++)
+    {
+        // lanes of dp_lo[l] are the primes 2*i + (l&1) of row l>>1
+        _mm256_storeu_si256((__m256i *) t, dp_lo[l]);
+        for (int i = 0; i < 4; i++)
+            lo[l>>1][2*i+(l&1)] = t[i];
+        _mm256_storeu_si256((__m256i *) t, dp_hi[l]);
+        for (int i = 0; i < 4; i++)
+            hi[l>>1][2*i+(l&1)] = t[i];
+    }
+
+    _nmod32_multi_reduce(res0, lo[0], hi[0], 8, mod, pow2_precomp);
+    _nmod32_multi_reduce(res1, lo[1], hi[1], 8, mod, pow2_precomp);
+}
+
+// 4 primes, rows row0 and row1: one load holds two consecutive columns,
+// so as for 8 primes the lanes of dp_lo[0] / dp_lo[2] hold the primes 0 and
+// 2 and those of dp_lo[1] / dp_lo[3] the primes 1 and 3, of even columns in
+// the lower and of odd columns in the upper half
+static inline
+void _nmod32_vec_dot2_multi4_split_avx2(uint32_t * res0, uint32_t * res1,
+                                        const uint32_t * vec,
+                                        const uint32_t * row0, const uint32_t * row1,
+                                        int64_t len, const nmod_t * mod,
+                                        const uint64_t * pow2_precomp)
+{
+    const __m256i low_bits = _mm256_set1_epi64x(__DOT_SPLIT_MASK);
+    __m256i dp_lo[4], dp_hi[4];
+    for (int l = 0; l < 4; l++)
+    {
+        dp_lo[l] = _mm256_setzero_si256();
+        dp_hi[l] = _mm256_setzero_si256();
+    }
+
+    // each pass accumulates at most 8 terms per lane before splitting,
+    // an odd last column is loaded alone in the lower half
+    for (int64_t k = 0; k < len; k += 16)
+    {
+        const int64_t end = MIN(k+16, len);
+        for (int64_t j = k; j < end; j += 2)
+        {
+            __m256i v, m0, m1;
+            if (j+1 < end)
+            {
+                v = _mm256_loadu_si256((const __m256i *) (vec+4*j));
+                m0 = _mm256_loadu_si256((const __m256i *) (row0+4*j));
+                m1 = _mm256_loadu_si256((const __m256i *) (row1+4*j));
+            }
+            else
+            {
+                const __m256i z = _mm256_setzero_si256();
+                v = _mm256_inserti128_si256(z, _mm_loadu_si128((const __m128i *) (vec+4*j)), 0);
+                m0 = _mm256_inserti128_si256(z, _mm_loadu_si128((const __m128i *) (row0+4*j)), 0);
+                m1 = _mm256_inserti128_si256(z, _mm_loadu_si128((const __m128i *) (row1+4*j)), 0);
+            }
+            dp_lo[0] = _mm256_add_epi64(dp_lo[0], _mm256_mul_epu32(m0, v));
+            dp_lo[2] = _mm256_add_epi64(dp_lo[2], _mm256_mul_epu32(m1, v));
+            v = _mm256_srli_epi64(v, 32);
+            m0 = _mm256_srli_epi64(m0, 32);
+            m1 = _mm256_srli_epi64(m1, 32);
+            dp_lo[1] = _mm256_add_epi64(dp_lo[1], _mm256_mul_epu32(m0, v));
+            dp_lo[3] = _mm256_add_epi64(dp_lo[3], _mm256_mul_epu32(m1, v));
+        }
+        for (int l = 0; l < 4; l++)
+        {
+            dp_hi[l] = _mm256_add_epi64(dp_hi[l], _mm256_srli_epi64(dp_lo[l], __DOT_SPLIT_BITS));
+            dp_lo[l] = _mm256_and_si256(dp_lo[l], low_bits);
+        }
+    }
+
+    uint64_t lo[2][4], hi[2][4], t[4];
+    for (int l = 0; l < 4; l++)
+    {
+        // both halves of dp_lo[l] hold the primes (l&1) and 2 + (l&1)
+        _mm256_storeu_si256((__m256i *) t, dp_lo[l]);
+        lo[l>>1][l&1] = t[0] + t[2];
+        lo[l>>1][2+(l&1)] = t[1] + t[3];
+        _mm256_storeu_si256((__m256i *) t, dp_hi[l]);
+        hi[l>>1][l&1] = t[0] + t[2];
+        hi[l>>1][2+(l&1)] = t[1] + t[3];
+    }
+
+    _nmod32_multi_reduce(res0, lo[0], hi[0], 4, mod, pow2_precomp);
+    _nmod32_multi_reduce(res1, lo[1], hi[1], 4, mod, pow2_precomp);
+}
+
+// row i of the result, i.e. vec_res[i*np .. i*np+np-1], is the product of
+// row i of the interleaved dense part with vec, dst[i] being the number of
+// trailing zeros common to all primes, rows are handled by pairs
+static inline void _avx2_matrix_vector_product_multi(uint32_t * vec_res,
+                                                     const uint32_t * mat,
+                                                     const uint32_t * vec,
+                                                     const uint32_t * dst,
+                                                     const uint32_t ncols,
+                                                     const uint32_t nrows,
+                                                     const int np,
+                                                     const nmod_t * mod,
+                                                     const uint64_t * pow2_precomp,
+                                                     const int nthrds)
+{
+    const uint64_t rl = (uint64_t)np * ncols;
+
+#pragma omp parallel for num_threads (nthrds) if (nthrds > 1)
+    for (slong i = 0; i < (slong)(nrows+1)/2; i++)
+    {
+        const slong i0 = 2*i;
+        // the last row of an odd number of rows is paired with itself
+        const slong i1 = MIN(i0+1, (slong)nrows-1);
+        const int64_t len = ncols - MIN(dst[i0], dst[i1]);
+        if (np == 8)
+            _nmod32_vec_dot2_multi8_split_avx2(vec_res + 8*i0, vec_res + 8*i1,
+                                               vec, mat + i0*rl, mat + i1*rl,
+                                               len, mod, pow2_precomp);
+        else
+            _nmod32_vec_dot2_multi4_split_avx2(vec_res + 4*i0, vec_res + 4*i1,
+                                               vec, mat + i0*rl, mat + i1*rl,
+                                               len, mod, pow2_precomp);
+    }
+}
 #endif
 
 /*-------------------------------------------*/
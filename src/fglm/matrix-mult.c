@@ -23,45 +23,6 @@
 
 #ifdef HAVE_AVX2
 #include <immintrin.h>
-
-#define AVX2LOAD(A) _mm256_load_si256((__m256i*)(A))
-#define AVX2LOADU(A) _mm256_loadu_si256((__m256i*)(A))
-#define AVX2STORE(res,A) _mm256_store_si256((__m256i*)(res),A);
-#define AVX2STOREU(res,A) _mm256_storeu_si256((__m256i*)(res),A);
-#define AVX2SETZERO() _mm256_setzero_si256()
-#define AVX2SET1_64(A0) _mm256_set1_epi64x(A0)
-#define AVX2AND_(A,B) _mm256_and_si256(A,B)
-#define AVX2ADD_64(A,B) _mm256_add_epi64(A,B)
-#define AVX2MUL(A,B) _mm256_mul_epu32(A,B)
-#define AVX2SRLI_64(A,i) _mm256_srli_epi64(A,i)
-
-#define AVXINNERPROD(res1, mat8, vec8, va, vtmp, prod1, prod2)        \
-  {                                                                   \
-    mat8=AVX2LOADU(va);                                           \
-    vec8=AVX2LOADU(vtmp);                                         \
-    /* four 32-bits mul, lower parts */                           \
-    /* four 32-bits mul, higher parts */                          \
-    prod1=AVX2MUL(mat8,vec8);                                     \
-    prod2= AVX2MUL(AVX2SRLI_64(mat8,32),AVX2SRLI_64(vec8,32));    \
-    res1 = prod1 + prod2;                                         \
-    va+=8;                                                      \
-    vtmp+=8;                                                    \
-  }                                                               \
-
-
-#define AVXINNERPRODLOOP(res1, mat8, vec8, va, vtmp, prod1, prod2)  \
-  {                                                                 \
-    mat8=AVX2LOADU(va);                                             \
-    vec8=AVX2LOADU(vtmp);                                           \
-    /* four 32-bits mul, lower parts */                             \
-    /* four 32-bits mul, higher parts */                            \
-    prod1=AVX2MUL(mat8,vec8);                                       \
-    prod2= AVX2MUL(AVX2SRLI_64(mat8,32),AVX2SRLI_64(vec8,32));      \
-    res1 += prod1 + prod2;                                          \
-    va+=8;                                                        \
-    vtmp+=8;                                                      \
-  }                                                                 \
-
 #endif
 
 
@@ -112,38 +73,6 @@ static inline uint64_t ADDMODRED32(uint64_t a, uint64_t b,
 * }
 */
 
-#if HAVE_AVX2
-static inline void REDUCE(uint64_t *acc64, uint64_t *acc4x64,
-                          __m256i acc_low, __m256i acc_high,
-                          const uint32_t fc, const uint32_t preinv,
-                          const uint32_t RED_32, const uint32_t RED_64){
-    AVX2STOREU(acc4x64,acc_low);
-    AVX2STOREU(acc4x64+4,acc_high);
-    /* Reduction */
-    *acc64=0;
-    acc4x64[0]+=MODRED32((acc4x64[4]>>32)*RED_64,fc,preinv);
-    /* partie basse du registre haut (2^32->2^63) */
-    acc4x64[0]+=MODRED32((acc4x64[4]&((uint64_t)0xFFFFFFFF))*RED_32,fc,preinv);
-    *acc64+=MODRED32(acc4x64[0],fc,preinv);
-
-    acc4x64[1]+=MODRED32((acc4x64[5]>>32)*RED_64,fc,preinv);
-    /* partie basse du registre haut (2^32->2^63) */
-    acc4x64[1]+=MODRED32((acc4x64[5]&((uint64_t)0xFFFFFFFF))*RED_32,fc,preinv);
-    *acc64+=MODRED32(acc4x64[1],fc,preinv);
-
-    acc4x64[2]+=MODRED32((acc4x64[6]>>32)*RED_64,fc,preinv);
-    /* partie basse du registre haut (2^32->2^63) */
-    acc4x64[2]+=MODRED32((acc4x64[6]&((uint64_t)0xFFFFFFFF))*RED_32,fc,preinv);
-    *acc64+=MODRED32(acc4x64[2],fc,preinv);
-
-    acc4x64[3]+=MODRED32((acc4x64[7]>>32)*RED_64, fc, preinv);
-    /* partie basse du registre haut (2^32->2^63) */
-    acc4x64[3]+=MODRED32((acc4x64[7]&((uint64_t)0xFFFFFFFF))*RED_32,fc,preinv);
-    *acc64+=MODRED32(acc4x64[3],fc,preinv);
-    *acc64=MODRED32(*acc64,fc,preinv);
-}
-#endif
-
 /* B has l rows, n columns */
 /* stores in tmp the entries of B column-wise */
 /* tmp = [ B[0][0], B[1][0], ..., B[n][0],
@@ -167,135 +96,316 @@ static inline void make_zero(uint32_t ** D,
 
 }
 
-#ifdef HAVE_AVX2
 /*
-  m = number of rows in A
-  l = number of cols in A = number of rows in B
-  n = number of cols in B
-
-  D = A*B
-
+  Product of the multiplication matrix matxn by a block of nc vectors,
+  used by the block Wiedemann sequence.
+
+  blk and res are stored row-wise, i.e. entry j of row k is at k*nc+j,
+  so that blk is already packed for the kernels below: row k of blk
+  holds the nc entries which are multiplied by column k of the dense
+  part of matxn.
+
+  The product by the dense part is tiled as in a GEMM. Its columns are
+  cut into panels of MATBLK_KC columns, so that the corresponding
+  MATBLK_KC rows of blk stay in cache while all rows of the dense part
+  are run through. Within a panel, MATBLK_MR consecutive rows are packed
+  into a tile which is multiplied by the panel of blk with a register
+  blocked micro-kernel, tiles are distributed among the threads.
+
+  As for the matrix vector products of linalg-fglm.c, products are
+  accumulated on 64 bits and split every 8 terms, hence prime must be
+  at most DOT2_ACC8_MAX_MODULUS.
 */
-void _mod_mat_addmul_transpose_op(uint32_t *D, 
-                                  uint32_t *A, uint32_t *B,
-                                  const uint32_t m, const uint32_t l,
-                                  const uint32_t n,
-                                  const uint32_t fc, const uint32_t preinv,
-                                  const uint32_t RED_32, const uint32_t RED_64){
-
-  __m256i acc_low, acc_high, mask, vec8, mat8;
-  __m256i prod1,prod2;
-  __m256i res1;
-#if IS_ALIGNED_TMP
-  uint64_t acc4x64[8] ALIGNED32;
-#else
-  uint64_t acc4x64[8];
-#endif
-  uint64_t acc64 = 0;
-
-  mask=AVX2SET1_64(MONE32);
-
-  const uint32_t *va;
-  const uint32_t *vtmp;
-
-  acc_low=AVX2SETZERO();
-  acc_high=AVX2SETZERO();
-
-  //quo(l, 2^6) * 2^6
-  const uint32_t bl = ((l >> 6) << 6);
-
-  for(uint32_t i = 0; i < m; i++){
-    for(uint32_t j = 0; j < n; j++){
-      acc64 = 0;
-
-      acc_low=AVX2SETZERO();
-      acc_high=AVX2SETZERO();
-      for(uint32_t k = 0; k < bl; k+=64){
-
-        /* va = A[i]+k; */
-        va = A+(i*l)+k;
-        vtmp = B+j*l+k;
-
-        AVXINNERPROD(res1, mat8, vec8, va, vtmp, prod1, prod2);
-        AVXINNERPRODLOOP(res1, mat8, vec8, va, vtmp, prod1, prod2);
-        AVXINNERPRODLOOP(res1, mat8, vec8, va, vtmp, prod1, prod2);
-        AVXINNERPRODLOOP(res1, mat8, vec8, va, vtmp, prod1, prod2);
-
-        AVXINNERPRODLOOP(res1, mat8, vec8, va, vtmp, prod1, prod2);
-        AVXINNERPRODLOOP(res1, mat8, vec8, va, vtmp, prod1, prod2);
-        AVXINNERPRODLOOP(res1, mat8, vec8, va, vtmp, prod1, prod2);
-        AVXINNERPRODLOOP(res1, mat8, vec8, va, vtmp, prod1, prod2);
-
-        acc_low = AVX2ADD_64(acc_low,AVX2AND_(res1,mask));
-        acc_high = AVX2ADD_64(acc_high,AVX2SRLI_64(res1,32));
 
+#define MATBLK_MR 4
+#define MATBLK_KC 256
+
+/* lo and hi store the MATBLK_MR x nc accumulators row-wise, ap is the
+ * packed tile, entry r of column k being at k*MATBLK_MR+r, b is the
+ * panel of blk, kc is the number of columns of the tile */
+static inline void _matblk_kernel(uint64_t *lo, uint64_t *hi,
+                                  const CF_t *ap, const CF_t *b,
+                                  const szmat_t kc, const int nc){
+  szmat_t k = 0;
+  while(k < kc){
+    const szmat_t ke = (kc - k > 8) ? k + 8 : kc;
+    for(; k < ke; k++){
+      const CF_t *bk = b + (uint64_t)k * nc;
+      for(int r = 0; r < MATBLK_MR; r++){
+        const uint64_t a = ap[k * MATBLK_MR + r];
+        uint64_t *l = lo + r * nc;
+        for(int j = 0; j < nc; j++){
+          l[j] += a * bk[j];
+        }
       }
+    }
+    for(int j = 0; j < MATBLK_MR * nc; j++){
+      hi[j] += lo[j] >> __DOT_SPLIT_BITS;
+      lo[j] &= __DOT_SPLIT_MASK;
+    }
+  }
+}
 
-      REDUCE(&acc64, acc4x64, acc_low, acc_high, fc, preinv,
-             RED_32, RED_64);
-
-      uint64_t p = 0, u = 0, d = 0;
-      uint64_t r, Shi = 0, Slo = 0;
-      const long c2 = j*l;
-      const long c1 = i*l;
-      for(uint32_t k = bl; k < l; k++){
+#ifdef HAVE_AVX2
+#define MATBLK_AVX2_MADD(C0, C1, A)                                   \
+  {                                                                   \
+    const __m256i va = _mm256_set1_epi64x(A);                         \
+    C0 = _mm256_add_epi64(C0, _mm256_mul_epu32(va, b0));              \
+    C1 = _mm256_add_epi64(C1, _mm256_mul_epu32(va, b1));              \
+  }
 
-        /* p = ((uint64_t)A[i][k] * (uint64_t)tmp[c+k]); */
-        p = ((uint64_t)A[c1+k] * (uint64_t)B[c2+k]);
-        u = p>>32;
-        d = p - (u<<32);
-        Shi += u;
-        Slo += d;
+#define MATBLK_AVX2_SPLIT(C, H)                                       \
+  {                                                                   \
+    __m256i vh = _mm256_loadu_si256((__m256i *)(H));                  \
+    vh = _mm256_add_epi64(vh, _mm256_srli_epi64(C, __DOT_SPLIT_BITS));\
+    _mm256_storeu_si256((__m256i *)(H), vh);                          \
+    C = _mm256_and_si256(C, low_bits);                                \
+  }
 
+/* 4 x 8 micro-kernel, nc must be a multiple of 8, the high parts are
+ * accumulated in hi directly since they are updated every 8 terms only */
+static inline void _matblk_kernel_avx2(uint64_t *lo, uint64_t *hi,
+                                       const CF_t *ap, const CF_t *b,
+                                       const szmat_t kc, const int nc){
+  const __m256i low_bits = _mm256_set1_epi64x(__DOT_SPLIT_MASK);
+  for(int j = 0; j < nc; j += 8){
+    __m256i c00 = _mm256_setzero_si256(), c01 = _mm256_setzero_si256();
+    __m256i c10 = _mm256_setzero_si256(), c11 = _mm256_setzero_si256();
+    __m256i c20 = _mm256_setzero_si256(), c21 = _mm256_setzero_si256();
+    __m256i c30 = _mm256_setzero_si256(), c31 = _mm256_setzero_si256();
+    szmat_t k = 0;
+    while(k < kc){
+      const szmat_t ke = (kc - k > 8) ? k + 8 : kc;
+      for(; k < ke; k++){
+        const CF_t *bk = b + (uint64_t)k * nc + j;
+        const CF_t *a  = ap + k * MATBLK_MR;
+        const __m256i b0 = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *)bk));
+        const __m256i b1 = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *)(bk + 4)));
+        MATBLK_AVX2_MADD(c00, c01, a[0]);
+        MATBLK_AVX2_MADD(c10, c11, a[1]);
+        MATBLK_AVX2_MADD(c20, c21, a[2]);
+        MATBLK_AVX2_MADD(c30, c31, a[3]);
       }
-      uint64_t hi, lo;
-      hi = Shi>>32;
-      lo = Shi - (hi<<32);
-      r = MODRED32(hi<<32, fc, preinv);
-      r = ADDMODRED32(lo, r, fc, preinv);
-      r = MODRED32((r<<32), fc, preinv);
-      r = ADDMODRED32(Slo, r, fc, preinv);
+      MATBLK_AVX2_SPLIT(c00, hi + j);
+      MATBLK_AVX2_SPLIT(c01, hi + j + 4);
+      MATBLK_AVX2_SPLIT(c10, hi + nc + j);
+      MATBLK_AVX2_SPLIT(c11, hi + nc + j + 4);
+      MATBLK_AVX2_SPLIT(c20, hi + 2 * nc + j);
+      MATBLK_AVX2_SPLIT(c21, hi + 2 * nc + j + 4);
+      MATBLK_AVX2_SPLIT(c30, hi + 3 * nc + j);
+      MATBLK_AVX2_SPLIT(c31, hi + 3 * nc + j + 4);
+    }
+    _mm256_storeu_si256((__m256i *)(lo + j), c00);
+    _mm256_storeu_si256((__m256i *)(lo + j + 4), c01);
+    _mm256_storeu_si256((__m256i *)(lo + nc + j), c10);
+    _mm256_storeu_si256((__m256i *)(lo + nc + j + 4), c11);
+    _mm256_storeu_si256((__m256i *)(lo + 2 * nc + j), c20);
+    _mm256_storeu_si256((__m256i *)(lo + 2 * nc + j + 4), c21);
+    _mm256_storeu_si256((__m256i *)(lo + 3 * nc + j), c30);
+    _mm256_storeu_si256((__m256i *)(lo + 3 * nc + j + 4), c31);
+  }
+}
+#endif
 
-      acc64 = ADDMODRED32(acc64, r, fc, preinv);
+#ifdef HAVE_AVX512_F
+#define MATBLK_AVX512_MADD(C0, C1, A)                                 \
+  {                                                                   \
+    const __m512i va = _mm512_set1_epi64(A);                          \
+    C0 = _mm512_add_epi64(C0, _mm512_mul_epu32(va, b0));              \
+    C1 = _mm512_add_epi64(C1, _mm512_mul_epu32(va, b1));              \
+  }
 
-      D[i*n+j] = ADDMODRED32(D[i*n+j], acc64, fc, preinv);
+#define MATBLK_AVX512_SPLIT(C, H)                                     \
+  {                                                                   \
+    H = _mm512_add_epi64(H, _mm512_srli_epi64(C, __DOT_SPLIT_BITS));  \
+    C = _mm512_and_si512(C, low_bits);                                \
+  }
 
+/* 4 x 16 micro-kernel, nc must be a multiple of 16, all accumulators
+ * are kept in registers */
+static inline void _matblk_kernel_avx512(uint64_t *lo, uint64_t *hi,
+                                         const CF_t *ap, const CF_t *b,
+                                         const szmat_t kc, const int nc){
+  const __m512i low_bits = _mm512_set1_epi64(__DOT_SPLIT_MASK);
+  for(int j = 0; j < nc; j += 16){
+    __m512i c00 = _mm512_setzero_si512(), c01 = _mm512_setzero_si512();
+    __m512i c10 = _mm512_setzero_si512(), c11 = _mm512_setzero_si512();
+    __m512i c20 = _mm512_setzero_si512(), c21 = _mm512_setzero_si512();
+    __m512i c30 = _mm512_setzero_si512(), c31 = _mm512_setzero_si512();
+    __m512i h00 = _mm512_setzero_si512(), h01 = _mm512_setzero_si512();
+    __m512i h10 = _mm512_setzero_si512(), h11 = _mm512_setzero_si512();
+    __m512i h20 = _mm512_setzero_si512(), h21 = _mm512_setzero_si512();
+    __m512i h30 = _mm512_setzero_si512(), h31 = _mm512_setzero_si512();
+    szmat_t k = 0;
+    while(k < kc){
+      const szmat_t ke = (kc - k > 8) ? k + 8 : kc;
+      for(; k < ke; k++){
+        const CF_t *bk = b + (uint64_t)k * nc + j;
+        const CF_t *a  = ap + k * MATBLK_MR;
+        const __m512i b0 = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i *)bk));
+        const __m512i b1 = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i *)(bk + 8)));
+        MATBLK_AVX512_MADD(c00, c01, a[0]);
+        MATBLK_AVX512_MADD(c10, c11, a[1]);
+        MATBLK_AVX512_MADD(c20, c21, a[2]);
+        MATBLK_AVX512_MADD(c30, c31, a[3]);
+      }
+      MATBLK_AVX512_SPLIT(c00, h00);
+      MATBLK_AVX512_SPLIT(c01, h01);
+      MATBLK_AVX512_SPLIT(c10, h10);
+      MATBLK_AVX512_SPLIT(c11, h11);
+      MATBLK_AVX512_SPLIT(c20, h20);
+      MATBLK_AVX512_SPLIT(c21, h21);
+      MATBLK_AVX512_SPLIT(c30, h30);
+      MATBLK_AVX512_SPLIT(c31, h31);
     }
+    _mm512_storeu_si512((__m512i *)(lo + j), c00);
+    _mm512_storeu_si512((__m512i *)(lo + j + 8), c01);
+    _mm512_storeu_si512((__m512i *)(lo + nc + j), c10);
+    _mm512_storeu_si512((__m512i *)(lo + nc + j + 8), c11);
+    _mm512_storeu_si512((__m512i *)(lo + 2 * nc + j), c20);
+    _mm512_storeu_si512((__m512i *)(lo + 2 * nc + j + 8), c21);
+    _mm512_storeu_si512((__m512i *)(lo + 3 * nc + j), c30);
+    _mm512_storeu_si512((__m512i *)(lo + 3 * nc + j + 8), c31);
+    _mm512_storeu_si512((__m512i *)(hi + j), h00);
+    _mm512_storeu_si512((__m512i *)(hi + j + 8), h01);
+    _mm512_storeu_si512((__m512i *)(hi + nc + j), h10);
+    _mm512_storeu_si512((__m512i *)(hi + nc + j + 8), h11);
+    _mm512_storeu_si512((__m512i *)(hi + 2 * nc + j), h20);
+    _mm512_storeu_si512((__m512i *)(hi + 2 * nc + j + 8), h21);
+    _mm512_storeu_si512((__m512i *)(hi + 3 * nc + j), h30);
+    _mm512_storeu_si512((__m512i *)(hi + 3 * nc + j + 8), h31);
   }
-
 }
 #endif
 
-/* not yet implemented for non-AVX machine */
+/* multiplies a packed tile by a panel of blk, lo and hi must be zero */
+static inline void _matblk_mul_tile(uint64_t *lo, uint64_t *hi,
+                                    const CF_t *ap, const CF_t *b,
+                                    const szmat_t kc, const int nc){
+#ifdef HAVE_AVX512_F
+  if(nc % 16 == 0){
+    _matblk_kernel_avx512(lo, hi, ap, b, kc, nc);
+    return;
+  }
+#endif
 #ifdef HAVE_AVX2
-static inline void sparse_matfglm_mul(CF_t *res, sp_matfglm_t *matxn, CF_t *R,
-                                      CF_t *tres,
-                                      const int nc,
-                                      const mod_t prime, const uint32_t preinv,
-                                      const uint32_t RED_32,
-                                      const uint64_t RED_64){
-  szmat_t ncols = matxn->ncols;
-  szmat_t nrows = matxn->nrows;
-  szmat_t ntriv = ncols - nrows;
-
-  for(szmat_t j = 0; j < ntriv; j++){
-    for(int i = 0; i < nc; i++){
-      uint32_t idx = i*(matxn->ncols);
-      res[idx + matxn->triv_idx[j]] = R[idx + matxn->triv_pos[j]];
-    }
+  if(nc % 8 == 0){
+    _matblk_kernel_avx2(lo, hi, ap, b, kc, nc);
+    return;
   }
+#endif
+  _matblk_kernel(lo, hi, ap, b, kc, nc);
+}
 
-  /* real product */
-  _mod_mat_addmul_transpose_op(tres, matxn->dense_mat, R,
-                               matxn->nrows, matxn->ncols, nc,
-                               prime, preinv,
-                               RED_32, RED_64);
+static inline void sparse_matfglm_mul_block(CF_t *res, sp_matfglm_t *matxn,
+                                            const CF_t *blk,
+                                            const int nc,
+                                            const mod_t prime,
+                                            md_t *st){
+  const szmat_t ncols  = matxn->ncols;
+  const szmat_t nrows  = matxn->nrows;
+  const szmat_t ntriv  = ncols - nrows;
+  const szmat_t ntiles = (nrows + MATBLK_MR - 1) / MATBLK_MR;
+  nmod_t mod;
+  uint64_t pow2_precomp;
+  nmod_init(&mod, (uint64_t)prime);
+  NMOD_RED(pow2_precomp, (UINT64_C(1) << __DOT_SPLIT_BITS), mod);
+
+  for(szmat_t i = 0; i < ntriv; i++){
+    memcpy(res + (uint64_t)matxn->triv_idx[i] * nc,
+           blk + (uint64_t)matxn->triv_pos[i] * nc, nc * sizeof(CF_t));
+  }
 
-  for(szmat_t j = 0; j < nrows; j++){
-    for(int i = 0; i < nc; i++){
-      uint32_t idx = i*(matxn->ncols);
-      res[idx + matxn->dense_idx[j]] = tres[idx + j];
+  /* trailing zeros of the rows of a tile are skipped, sparse rows of a
+   * compressed matrix are left out of the tiles */
+  szmat_t *tlen = (szmat_t *)malloc(ntiles * sizeof(szmat_t));
+  for(szmat_t t = 0; t < ntiles; t++){
+    tlen[t] = 0;
+    for(szmat_t i = t * MATBLK_MR; i < nrows && i < (t + 1) * MATBLK_MR; i++){
+      const CF_t *row;
+      const szmat_t len = sp_matfglm_packed_row(matxn, i, &row);
+      if(len > tlen[t]){
+        tlen[t] = len;
+      }
     }
   }
+
+#pragma omp parallel num_threads (st->nthrds)
+  {
+    CF_t *ap = (CF_t *)malloc(MATBLK_MR * MATBLK_KC * sizeof(CF_t));
+    uint64_t *lo = (uint64_t *)malloc(2 * MATBLK_MR * nc * sizeof(uint64_t));
+    uint64_t *hi = lo + MATBLK_MR * nc;
+#pragma omp for
+    for(szmat_t i = 0; i < nrows; i++){
+      memset(res + (uint64_t)matxn->dense_idx[i] * nc, 0, nc * sizeof(CF_t));
+    }
+    for(szmat_t pc = 0; pc < ncols; pc += MATBLK_KC){
+#pragma omp for schedule(dynamic, 8)
+      for(szmat_t t = 0; t < ntiles; t++){
+        if(tlen[t] <= pc){
+          continue;
+        }
+        const szmat_t kc = (tlen[t] - pc > MATBLK_KC) ? MATBLK_KC : tlen[t] - pc;
+        const szmat_t i0 = t * MATBLK_MR;
+        const int mr = (nrows - i0 > MATBLK_MR) ? MATBLK_MR : nrows - i0;
+        for(int r = 0; r < mr; r++){
+          const CF_t *row;
+          const szmat_t len = sp_matfglm_packed_row(matxn, i0 + r, &row);
+          const szmat_t kr = (len <= pc) ? 0 : (len - pc < kc) ? len - pc : kc;
+          for(szmat_t k = 0; k < kr; k++){
+            ap[k * MATBLK_MR + r] = row[pc + k];
+          }
+          for(szmat_t k = kr; k < kc; k++){
+            ap[k * MATBLK_MR + r] = 0;
+          }
+        }
+        for(int r = mr; r < MATBLK_MR; r++){
+          for(szmat_t k = 0; k < kc; k++){
+            ap[k * MATBLK_MR + r] = 0;
+          }
+        }
+        memset(lo, 0, 2 * MATBLK_MR * nc * sizeof(uint64_t));
+        _matblk_mul_tile(lo, hi, ap, blk + (uint64_t)pc * nc, kc, nc);
+        for(int r = 0; r < mr; r++){
+          CF_t *c = res + (uint64_t)matxn->dense_idx[i0 + r] * nc;
+          for(int j = 0; j < nc; j++){
+            uint64_t v;
+            NMOD_RED(v, hi[r * nc + j] * pow2_precomp + lo[r * nc + j], mod);
+            v += c[j];
+            c[j] = (v >= prime) ? v - prime : v;
+          }
+        }
+      }
+    }
+    if(sp_matfglm_is_compressed(matxn)){
+      const uint64_t sq = (uint64_t)prime * prime;
+      const uint64_t red = ((UINT64_C(1) << 63) / sq) * sq;
+#pragma omp for schedule(dynamic, 16)
+      for(szmat_t i = 0; i < nrows; i++){
+        const szmat_t nnz = matxn->cmp_nnz[i];
+        if(nnz == SP_MATFGLM_PACKED){
+          continue;
+        }
+        const CF_t *row = matxn->cmp_data + matxn->cmp_off[i];
+        for(int j = 0; j < nc; j++){
+          lo[j] = 0;
+        }
+        for(szmat_t k = 0; k < nnz; k++){
+          const CF_t *b = blk + (uint64_t)row[k] * nc;
+          const uint64_t a = row[nnz + k];
+          for(int j = 0; j < nc; j++){
+            lo[j] += a * b[j];
+            lo[j] -= (lo[j] >> 63) * red;
+          }
+        }
+        CF_t *c = res + (uint64_t)matxn->dense_idx[i] * nc;
+        for(int j = 0; j < nc; j++){
+          c[j] = lo[j] % prime;
+        }
+      }
+    }
+    free(ap);
+    free(lo);
+  }
+  free(tlen);
 }
-#endif
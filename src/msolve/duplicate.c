@@ -203,7 +203,11 @@ static inline void duplicate_data_mthread_trace(int nthreads,
     long len2 = dquot - len0;
 
     sp_matfglm_t *matrix = bmatrix[i];
-    if(posix_memalign((void **)&matrix->dense_mat, 32, sizeof(CF_t)*len1)){
+    /* rows are compressed on the fly if those of bmatrix[0] are */
+    if(sp_matfglm_is_compressed(bmatrix[0])){
+      sp_matfglm_init_compressed(matrix);
+    }
+    else if(posix_memalign((void **)&matrix->dense_mat, 32, sizeof(CF_t)*len1)){
       fprintf(ERRSTREAM, "Problem when allocating matrix->dense_mat\n");
       exit(1);
     }
@@ -0,0 +1,287 @@
+/* This file is part of msolve.
+ *
+ * msolve is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * msolve is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with msolve.  If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors:
+ * Jérémy Berthomieu
+ * Christian Eder
+ * Mohab Safey El Din */
+
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "msolve-data.h"
+
+/* Farming of primes to worker processes: after the learning phase the
+ * coordinator forks worker processes which inherit the learned data. The
+ * coordinator sends primes through a pipe, each worker computes the
+ * parametrization modulo this prime and sends back its image, i.e. the
+ * coefficients of the eliminating polynomial and of the coordinates and
+ * the witness coefficients of the multiplication matrix used for lifting
+ * its trace and determinant. All CRT and rational reconstruction steps are
+ * done by the coordinator.
+ *
+ * A request is one prime, the prime 0 terminates the worker. An image is
+ * a sequence of 32 bit words
+ *
+ *     prime, bad, degelimpol, degsqfrelimpol,
+ *     length of elim, coefficients of elim,
+ *     length of coords[i], coefficients of coords[i]   (i < nvars - 1),
+ *     nrows witness coefficients
+ *
+ * where the polynomials are only sent if bad is zero, followed by the
+ * time in seconds spent in F4 as a double.
+ *
+ * Workers are forked once the OpenMP runtime of the coordinator has been
+ * started, its thread pool is not usable in the worker. Hence workers run
+ * with one thread only, so that no parallel region needs the pool. A
+ * prime for which the computation fails is sent back as bad. If a worker
+ * calls exit nevertheless, e.g. on a failed allocation, it leaves through
+ * _exit: neither the atexit handlers of the coordinator nor its stdio
+ * buffers, which are copied into the worker, are run resp. flushed. The
+ * coordinator then sees the pipe of the worker closing. */
+
+/* writes exactly len bytes to fd, returns 0 on success */
+static int farm_write(int fd, const void *buf, size_t len){
+  const char *p = (const char *)buf;
+  while(len > 0){
+    ssize_t r = write(fd, p, len);
+    if(r < 0){
+      if(errno == EINTR){
+        continue;
+      }
+      return -1;
+    }
+    p   +=  r;
+    len -=  r;
+  }
+  return 0;
+}
+
+/* reads exactly len bytes from fd, returns 0 on success */
+static int farm_read(int fd, void *buf, size_t len){
+  char *p = (char *)buf;
+  while(len > 0){
+    ssize_t r = read(fd, p, len);
+    if(r < 0){
+      if(errno == EINTR){
+        continue;
+      }
+      return -1;
+    }
+    if(r == 0){
+      return -1;
+    }
+    p   +=  r;
+    len -=  r;
+  }
+  return 0;
+}
+
+static inline int farm_write_poly(int fd, const nmod_poly_t pol){
+  uint32_t len = pol->length;
+  uint32_t *buf = (uint32_t *)malloc((len + 1) * sizeof(uint32_t));
+  buf[0] = len;
+  for(uint32_t i = 0; i < len; i++){
+    buf[i + 1] = pol->coeffs[i];
+  }
+  int err = farm_write(fd, buf, (len + 1) * sizeof(uint32_t));
+  free(buf);
+  return err;
+}
+
+static inline int farm_read_poly(int fd, nmod_poly_t pol){
+  uint32_t len;
+  if(farm_read(fd, &len, sizeof(uint32_t))){
+    return -1;
+  }
+  uint32_t *buf = (uint32_t *)malloc((len + 1) * sizeof(uint32_t));
+  int err = farm_read(fd, buf, len * sizeof(uint32_t));
+  if(err == 0){
+    nmod_poly_fit_length(pol, len);
+    for(uint32_t i = 0; i < len; i++){
+      pol->coeffs[i] = buf[i];
+    }
+    _nmod_poly_set_length(pol, len);
+    _nmod_poly_normalise(pol);
+  }
+  free(buf);
+  return err;
+}
+
+/* sends the image of the parametrization modulo prime computed by a
+ * worker, witness coefficients are taken from mat at the indices widx */
+static int farm_write_image(int fd, const uint32_t prime, const uint32_t bad,
+                            const param_t *param, const sp_matfglm_t *mat,
+                            const uint64_t *widx, const uint32_t nrows,
+                            const double stf4){
+  uint32_t hd[4];
+  hd[0] = prime;
+  hd[1] = bad;
+  hd[2] = bad ? 0 : param->degelimpol;
+  hd[3] = bad ? 0 : param->degsqfrelimpol;
+  int err = farm_write(fd, hd, 4 * sizeof(uint32_t));
+  if(bad == 0){
+    err = err || farm_write_poly(fd, param->elim);
+    for(nvars_t i = 0; i < param->nvars - 1; i++){
+      err = err || farm_write_poly(fd, param->coords[i]);
+    }
+    uint32_t *w = (uint32_t *)malloc(nrows * sizeof(uint32_t));
+    for(uint32_t i = 0; i < nrows; i++){
+      w[i] = sp_matfglm_entry(mat, widx[i]);
+    }
+    err = err || farm_write(fd, w, nrows * sizeof(uint32_t));
+    free(w);
+  }
+  err = err || farm_write(fd, &stf4, sizeof(double));
+  return err;
+}
+
+/* receives an image sent by farm_write_image, param and the witness
+ * coefficients of mat are overwritten if the prime is not bad */
+static int farm_read_image(int fd, uint32_t *prime, uint32_t *bad,
+                           param_t *param, sp_matfglm_t *mat,
+                           const uint64_t *widx, const uint32_t nrows,
+                           double *stf4){
+  uint32_t hd[4];
+  int err = farm_read(fd, hd, 4 * sizeof(uint32_t));
+  if(err){
+    return err;
+  }
+  *prime  = hd[0];
+  *bad    = hd[1];
+  if(*bad == 0){
+    fglm_param_set_prime(param, *prime);
+    param->degelimpol     = hd[2];
+    param->degsqfrelimpol = hd[3];
+    err = err || farm_read_poly(fd, param->elim);
+    for(nvars_t i = 0; i < param->nvars - 1; i++){
+      err = err || farm_read_poly(fd, param->coords[i]);
+    }
+    uint32_t *w = (uint32_t *)malloc(nrows * sizeof(uint32_t));
+    err = err || farm_read(fd, w, nrows * sizeof(uint32_t));
+    if(err == 0){
+      sp_matfglm_set_entries(mat, widx, w, nrows);
+    }
+    free(w);
+  }
+  err = err || farm_read(fd, stf4, sizeof(double));
+  return err;
+}
+
+/* registered by each worker, the only handler run when it calls exit */
+static void farm_worker_exit(void){
+  _exit(1);
+}
+
+typedef struct{
+  int32_t nw;     /* number of workers */
+  pid_t *pid;     /* process ids of the workers */
+  int *req;       /* pipes to send primes to the workers */
+  int *res;       /* pipes to receive images from the workers */
+  int32_t next;   /* worker from which the next image is received */
+  struct sigaction sigpipe; /* handling of SIGPIPE before the farm started */
+} farm_t;
+
+/* terminates all workers, images not yet received are lost */
+static void farm_stop(farm_t *farm){
+  for(int32_t i = 0; i < farm->nw; i++){
+    close(farm->req[i]);
+    close(farm->res[i]);
+    kill(farm->pid[i], SIGTERM);
+  }
+  for(int32_t i = 0; i < farm->nw; i++){
+    waitpid(farm->pid[i], NULL, 0);
+  }
+  free(farm->pid);
+  free(farm->req);
+  free(farm->res);
+  farm->nw = 0;
+  sigaction(SIGPIPE, &farm->sigpipe, NULL);
+}
+
+/* starts nw workers, each runs worker(rfd, wfd, data) and exits
+ * afterwards, returns 0 on success, otherwise no worker is running */
+static int farm_start(farm_t *farm, const int32_t nw,
+                      void (*worker)(int, int, void *), void *data){
+  farm->nw    = 0;
+  farm->next  = 0;
+  farm->pid   = (pid_t *)malloc(nw * sizeof(pid_t));
+  farm->req   = (int *)malloc(nw * sizeof(int));
+  farm->res   = (int *)malloc(nw * sizeof(int));
+
+  /* a failing worker must not kill the coordinator when it sends a prime,
+   * the former handling of SIGPIPE is restored by farm_stop */
+  struct sigaction ign;
+  memset(&ign, 0, sizeof(struct sigaction));
+  ign.sa_handler = SIG_IGN;
+  sigemptyset(&ign.sa_mask);
+  sigaction(SIGPIPE, &ign, &farm->sigpipe);
+  /* buffered output would otherwise be written by each worker, too */
+  fflush(stdout);
+  fflush(stderr);
+  for(int32_t i = 0; i < nw; i++){
+    int rq[2], rs[2];
+    if(pipe(rq)){
+      break;
+    }
+    if(pipe(rs)){
+      close(rq[0]);
+      close(rq[1]);
+      break;
+    }
+    pid_t pid = fork();
+    if(pid < 0){
+      close(rq[0]);
+      close(rq[1]);
+      close(rs[0]);
+      close(rs[1]);
+      break;
+    }
+    if(pid == 0){
+      atexit(farm_worker_exit);
+      sigaction(SIGPIPE, &farm->sigpipe, NULL);
+      /* worker: drop pipes of the other workers */
+      for(int32_t j = 0; j < farm->nw; j++){
+        close(farm->req[j]);
+        close(farm->res[j]);
+      }
+      close(rq[1]);
+      close(rs[0]);
+      worker(rq[0], rs[1], data);
+      close(rq[0]);
+      close(rs[1]);
+      _exit(0);
+    }
+    close(rq[0]);
+    close(rs[1]);
+    farm->pid[farm->nw] = pid;
+    farm->req[farm->nw] = rq[1];
+    farm->res[farm->nw] = rs[0];
+    farm->nw++;
+  }
+  if(farm->nw < nw){
+    fprintf(ERRSTREAM, "Could not start %d worker processes\n", nw);
+    farm_stop(farm);
+    return -1;
+  }
+  return 0;
+}
+
+static inline int farm_send_prime(farm_t *farm, const int32_t w,
+                                  const uint32_t prime){
+  return farm_write(farm->req[w], &prime, sizeof(uint32_t));
+}
@@ -38,6 +38,136 @@ void print_fglm_header(
 }
 
 
+/* hash index of the monomial basis lmb: maps an exponent vector to its
+ * position in lmb, replacing the linear scans of lmb when building the
+ * multiplication matrix. Once built, the index is only read, so it can be
+ * shared by threads filling different rows. */
+typedef struct{
+  const int32_t *lmb;
+  long *tab;      /* positions in lmb, -1 for empty slots */
+  uint64_t mask;
+  int32_t *evi;   /* positions of the variables in hash table exponents */
+  int nv;
+} lmb_index_t;
+
+static inline uint64_t lmb_index_mix(uint64_t h, const uint64_t e){
+  return (h ^ e) * UINT64_C(0x9E3779B97F4A7C15);
+}
+
+static inline uint64_t lmb_index_hash(const int32_t *exp, const int32_t dxn,
+                                      const int nv){
+  uint64_t h = 0;
+  for(int k = 0; k < nv - 1; k++){
+    h = lmb_index_mix(h, (uint64_t)exp[k]);
+  }
+  h = lmb_index_mix(h, (uint64_t)(exp[nv-1] + dxn));
+  return h ^ (h >> 31);
+}
+
+static inline void lmb_index_init(lmb_index_t *lidx, const int32_t *lmb,
+                                  const long dquot, const int nv,
+                                  const ht_t *ht){
+  uint64_t sz = 2;
+  while(sz < 2 * (uint64_t)dquot){
+    sz <<= 1;
+  }
+  lidx->lmb  = lmb;
+  lidx->nv   = nv;
+  lidx->mask = sz - 1;
+  lidx->tab  = malloc(sz * sizeof(long));
+  for(uint64_t i = 0; i < sz; i++){
+    lidx->tab[i] = -1;
+  }
+  for(long i = 0; i < dquot; i++){
+    uint64_t h = lmb_index_hash(lmb + i * nv, 0, nv) & lidx->mask;
+    while(lidx->tab[h] != -1){
+      h = (h + 1) & lidx->mask;
+    }
+    lidx->tab[h] = i;
+  }
+  lidx->evi = NULL;
+  if(ht != NULL){
+    const len_t ebl = ht->ebl;
+    const len_t evl = ht->evl;
+    lidx->evi = malloc((unsigned long)nv * sizeof(int32_t));
+    if (ebl == 0) {
+      for (long i = 1; i < evl; ++i) {
+        lidx->evi[i-1]    =   i;
+      }
+    } else {
+      for (long i = 1; i < ebl; ++i) {
+        lidx->evi[i-1]    =   i;
+      }
+      for (long i = ebl+1; i < evl; ++i) {
+        lidx->evi[i-2]    =   i;
+      }
+    }
+  }
+}
+
+static inline void lmb_index_clear(lmb_index_t *lidx){
+  free(lidx->tab);
+  free(lidx->evi);
+  lidx->tab = NULL;
+  lidx->evi = NULL;
+}
+
+/* position in lmb of exp * xn^dxn, -1 if it is not in lmb */
+static inline long lmb_index_find(const lmb_index_t *lidx, const int32_t *exp,
+                                  const int32_t dxn){
+  const int nv = lidx->nv;
+  uint64_t h = lmb_index_hash(exp, dxn, nv) & lidx->mask;
+  long p;
+  while((p = lidx->tab[h]) != -1){
+    const int32_t *e = lidx->lmb + p * nv;
+    int k = 0;
+    while(k < nv - 1 && e[k] == exp[k]){
+      k++;
+    }
+    if(k == nv - 1 && e[nv-1] == exp[nv-1] + dxn){
+      return p;
+    }
+    h = (h + 1) & lidx->mask;
+  }
+  return -1;
+}
+
+/* same for an exponent vector stored in a hash table, read through evi */
+static inline long lmb_index_find_ev(const lmb_index_t *lidx,
+                                     const exp_t *ev, const int32_t *evi){
+  const int nv = lidx->nv;
+  uint64_t h = 0;
+  for(int k = 0; k < nv; k++){
+    h = lmb_index_mix(h, (uint64_t)(int32_t)ev[evi[k]]);
+  }
+  h = (h ^ (h >> 31)) & lidx->mask;
+  long p;
+  while((p = lidx->tab[h]) != -1){
+    const int32_t *e = lidx->lmb + p * nv;
+    int k = 0;
+    while(k < nv && e[k] == (int32_t)ev[evi[k]]){
+      k++;
+    }
+    if(k == nv){
+      return p;
+    }
+    h = (h + 1) & lidx->mask;
+  }
+  return -1;
+}
+
+/* checks whether x_n times the monomial at position i in lmb is in lmb,
+ * pos is then its position relative to i */
+static inline int member_xxn_index(const lmb_index_t *lidx, const long i,
+                                   long *pos){
+  const long p = lmb_index_find(lidx, lidx->lmb + i * lidx->nv, 1);
+  if(p > i){
+    *pos = p - i;
+    return 1;
+  }
+  return 0;
+}
+
 static void (*copy_poly_in_matrix_from_bs)(sp_matfglm_t* matrix,
                                            long nrows,
                                            bs_t *bs,
@@ -45,6 +175,7 @@ static void (*copy_poly_in_matrix_from_bs)(sp_matfglm_t* matrix,
                                            long idx, long len,
                                            long start, long pos,
                                            int32_t *lmb,
+                                           const lmb_index_t *lidx,
                                            const int nv,
                                            const long fc);
 
@@ -52,6 +183,7 @@ static void (*copy_nf_in_matrix_from_bs)(sp_matfglm_t* matrix,
 					 long nrows,
 					 long pos,
 					 int32_t *lmb,
+					 const lmb_index_t *lidx,
 					 const bs_t * const tbr,
 					 const ht_t * const bht,
 					 int32_t * evi,
@@ -171,133 +303,195 @@ static inline int64_t sum(int32_t *ind, int32_t length){
   return s;
 }
 
+/* staircase being enumerated by staircase_rec */
+typedef struct{
+  int32_t *basis;   /* monomials found so far */
+  long len;
+  long alloc;
+  long nvars;
+  long stride;      /* size of the lists of leading monomials in act */
+  int unbounded;    /* set when the staircase is infinite */
+} staircase_t;
+
 /*
-  - len1 is the current dimension of the quotient
-  - len_lm is the number of polynomials in the GB
-  - basis will contain the final monomial basis
-  - new_basis
+  Enumerates the monomials outside the ideal generated by the leading
+  monomials in bexp_lm, by fixing the exponent of the variable v (the last
+  variable first) and recursing on the variables before it.
+  - par holds the npar leading monomials which divide the exponents
+    already fixed in the variables after v, the other ones play no role in
+    the slice
+  - act is a workspace of nvars lists of leading monomials
+  - budget bounds the degree left for the variables up to v, it is negative
+    when the degree is not bounded
+
+  exponents are taken in decreasing order, the monomials are thus found
+  by decreasing lex order on (e_{n-1}, ..., e_0), which within each degree
+  is the increasing DRL order.
 */
-static inline int32_t generate_new_elts_basis(int32_t nvars, int32_t *ind,
-                                              len_t len1,
-                                              int32_t *basis, int32_t *new_basis,
-                                              len_t len_lm,
-                                              int32_t *bexp_lm){
-
-  len_t c = 0;
-  for(int64_t n = nvars-1; n >= 0; n--){
-    for(len_t i = ind[nvars-1-n]; i < len1; i++){
-      for(int64_t k = 0; k < nvars; k++){
-        new_basis[c*nvars+k] = basis[i*nvars+k];
-      }
-      new_basis[c*nvars+n]++;
-      if(!is_divisible_lexp(nvars, len_lm, (new_basis+c*nvars), bexp_lm)){
-        c++;
+static void staircase_rec(staircase_t *sc, const int32_t *bexp_lm,
+                          const long *par, const long npar, long *act,
+                          int32_t *exp, const long v, const long budget){
+  const long nvars = sc->nvars;
+
+  /* the slice is empty as soon as a leading monomial of par which only
+   * involves variables from v on divides exp */
+  long amax = budget;
+  int bounded = (budget >= 0);
+  for(long i = 0; i < npar; i++){
+    const int32_t *lm = bexp_lm + par[i] * nvars;
+    long w = 0;
+    while(w < v && lm[w] == 0){
+      w++;
+    }
+    if(w == v && (!bounded || lm[v] - 1 < amax)){
+      amax = lm[v] - 1;
+      bounded = 1;
+    }
+  }
+  if(!bounded){
+    sc->unbounded = 1;
+    return;
+  }
+  long *cur = act + v * sc->stride;
+  for(long a = amax; a >= 0; a--){
+    exp[v] = a;
+    if(v == 0){
+      if(sc->len == sc->alloc){
+        sc->alloc = 2 * sc->alloc + 16;
+        int32_t *basis = realloc(sc->basis,
+                                 sizeof(int32_t) * sc->alloc * nvars);
+        if(basis == NULL){
+          fprintf(ERRSTREAM, "Issue with realloc\n");
+          exit(1);
+        }
+        sc->basis = basis;
       }
+      memcpy(sc->basis + sc->len * nvars, exp, sizeof(int32_t) * nvars);
+      sc->len++;
+      continue;
     }
-  }
-
-  return c;
-}
-
-/* takes as input an exponent and an index and returns the degree of the
-   variable next to the index */
-static inline int degree_prev_var(int32_t *exp, long n){
-  return(exp[n+1]);
-}
-
-static inline void update_indices(int32_t *ind, int32_t *basis,
-                                  long dquot, long new_length, long nvars){
-
-  ind[0] = dquot;
-  for(long n = nvars - 2; n >= 0 ; n--){
-    for(long i = ind[nvars-1-n-1]; i < dquot + new_length; i++){
-      if(degree_prev_var(basis+i*nvars, n)==0){
-        ind[nvars-n-1] = i;
-        break;
-      }
-      for(long k = n; k>=0; k--){
-        ind[nvars-k-1] = dquot + new_length;
+    long ncur = 0;
+    for(long i = 0; i < npar; i++){
+      if(bexp_lm[par[i] * nvars + v] <= a){
+        cur[ncur++] = par[i];
       }
     }
+    staircase_rec(sc, bexp_lm, cur, ncur, act, exp, v - 1,
+                  budget < 0 ? -1 : budget - a);
+    if(sc->unbounded){
+      return;
+    }
   }
 }
 
 /** length is the length of the GB
     nvars is the number of variables
     bexp_lm encodes the leading monomials
-    dquot is a pointer to an integer that will be the dimension of the quotient
+    maxdeg bounds the degree of the monomials, no bound when it is negative
+    dquot is a pointer to an integer that will be the number of monomials
 
-    assumes bexp_lm is for grevlex ordering
+    returns the monomials of degree at most maxdeg which are not divisible
+    by any leading monomial, by increasing DRL order, or NULL when there is
+    none or when they are infinitely many.
  */
-static inline int32_t *monomial_basis(long length, long nvars,
-                                      int32_t *bexp_lm, long *dquot){
-  /* basis will contain the monomial basis */
-  int32_t *basis = calloc(nvars, sizeof(int32_t));
-  (*dquot) = 0;
+static inline int32_t *staircase_drl(long length, long nvars,
+                                     int32_t *bexp_lm, const long maxdeg,
+                                     long *dquot){
+  staircase_t sc;
+  sc.basis     = NULL;
+  sc.len       = 0;
+  sc.alloc     = 0;
+  sc.nvars     = nvars;
+  sc.stride    = length + 1;
+  sc.unbounded = 0;
+
+  long *act = malloc(sizeof(long) * (nvars + 1) * sc.stride);
+  long *par = act + nvars * sc.stride;
+  for(long i = 0; i < length; i++){
+    par[i] = i;
+  }
+  int32_t *exp = calloc(nvars, sizeof(int32_t));
+  staircase_rec(&sc, bexp_lm, par, length, act, exp, nvars - 1, maxdeg);
+  free(exp);
+  free(act);
 
-  if(is_divisible_lexp(nvars, length, (basis), bexp_lm)){
-    free(basis);
+  (*dquot) = 0;
+  if(sc.unbounded || sc.len == 0){
+    free(sc.basis);
     return NULL;
   }
-  else{
-    (*dquot)++;
-  }
-  int32_t *ind = calloc(nvars, sizeof(int32_t));
-
-#ifdef DEBUGHILBERT
-  fprintf(ERRSTREAM, "new = %ld \n", sum(ind, nvars) + nvars);
-#endif
 
-  int32_t *new_basis = malloc(sizeof(int32_t) * nvars * (sum(ind, nvars) + nvars));
-  int32_t new_length = generate_new_elts_basis(nvars, ind, (*dquot),
-                                               basis, new_basis,
-                                               length, bexp_lm);
-#ifdef DEBUGHILBERT
-  //  display_monomials_from_array(ERRSTREAM, new_length, new_basis, gens);
-  fprintf(ERRSTREAM, "%ld new elements.\n", new_length);
-#endif
-  while(new_length>0){
-    int32_t *basis2 = realloc(basis,
-                              ((*dquot) + new_length) * nvars * sizeof(int32_t));
-    if(basis2==NULL){
-      fprintf(ERRSTREAM, "Issue with realloc\n");
-      exit(1);
+  /* stable counting sort by degree */
+  long dmax = 0;
+  long *deg = malloc(sizeof(long) * sc.len);
+  for(long i = 0; i < sc.len; i++){
+    deg[i] = sum(sc.basis + i * nvars, nvars);
+    if(deg[i] > dmax){
+      dmax = deg[i];
     }
+  }
+  long *start = calloc(dmax + 2, sizeof(long));
+  for(long i = 0; i < sc.len; i++){
+    start[deg[i] + 1]++;
+  }
+  for(long d = 0; d <= dmax; d++){
+    start[d + 1] += start[d];
+  }
+  int32_t *basis = malloc(sizeof(int32_t) * sc.len * nvars);
+  for(long i = 0; i < sc.len; i++){
+    memcpy(basis + (start[deg[i]]++) * nvars, sc.basis + i * nvars,
+           sizeof(int32_t) * nvars);
+  }
+  free(start);
+  free(deg);
+  free(sc.basis);
 
-    basis = basis2;
-    for(long i = 0; i < new_length; i++){
-      for(long k = 0; k < nvars; k++){
-        (basis)[((*dquot) + i)*nvars+k] = (new_basis)[i*nvars+k];
-      }
-    }
+  (*dquot) = sc.len;
+  return basis;
+}
 
-    update_indices(ind, basis, *dquot, new_length, nvars);
-    (*dquot) += new_length;
+static inline void free_staircase_cache(staircase_cache_t *cache){
+  free(cache->bexp_lm);
+  free(cache->basis);
+  cache->bexp_lm = NULL;
+  cache->basis   = NULL;
+}
 
-#ifdef DEBUGHILBERT
-    fprintf(ERRSTREAM, "Update indices\n");
-    for(long i = 0; i < nvars; i++) fprintf(ERRSTREAM, "%ld ", ind[i]);
-    fprintf(ERRSTREAM, "\n");
-    fprintf(ERRSTREAM, "new = %ld \n", sum(ind, nvars) + nvars);
-#endif
+/** length is the length of the GB
+    nvars is the number of variables
+    bexp_lm encodes the leading monomials
+    dquot is a pointer to an integer that will be the dimension of the quotient
+    cache, if not NULL, holds the last staircase computed by the caller,
+    it is reused if bexp_lm is the same and replaced otherwise
 
-    int32_t *new_basis2 = realloc(new_basis,
-                                 sizeof(int32_t) * nvars * (sum(ind, nvars) + nvars));
-    if(new_basis2==NULL){
-      fprintf(ERRSTREAM, "Issue with realloc\n");
-      exit(1);
-    }
-    new_basis=new_basis2;
-    new_length = generate_new_elts_basis(nvars, ind, (*dquot),
-                                         basis, new_basis,
-                                         length, bexp_lm);
-#ifdef DEBUGHILBERT
-    fprintf(ERRSTREAM, "%ld new elements.\n", new_length);
-#endif
-  }
+    assumes bexp_lm is for grevlex ordering
+ */
+static inline int32_t *monomial_basis(long length, long nvars,
+                                      int32_t *bexp_lm, long *dquot,
+                                      staircase_cache_t *cache){
+  int32_t *basis;
+
+  if(cache != NULL && cache->basis != NULL && cache->length == length
+     && cache->nvars == nvars
+     && !memcmp(cache->bexp_lm, bexp_lm, sizeof(int32_t) * length * nvars)){
+    (*dquot) = cache->dquot;
+    basis = malloc(sizeof(int32_t) * (*dquot) * nvars);
+    memcpy(basis, cache->basis, sizeof(int32_t) * (*dquot) * nvars);
+    return basis;
+  }
+  basis = staircase_drl(length, nvars, bexp_lm, -1, dquot);
+  if(basis == NULL || cache == NULL){
+    return basis;
+  }
+  free_staircase_cache(cache);
+  cache->length  = length;
+  cache->nvars   = nvars;
+  cache->dquot   = *dquot;
+  cache->bexp_lm = malloc(sizeof(int32_t) * length * nvars);
+  memcpy(cache->bexp_lm, bexp_lm, sizeof(int32_t) * length * nvars);
+  cache->basis = malloc(sizeof(int32_t) * (*dquot) * nvars);
+  memcpy(cache->basis, basis, sizeof(int32_t) * (*dquot) * nvars);
 
-  free(new_basis);
-  free(ind);
   return basis;
 }
 
@@ -311,75 +505,10 @@ static inline int32_t *monomial_basis(long length, long nvars,
 static inline int32_t *monomial_basis_colon(long length, long nvars,
 					    int32_t *bexp_lm, long *dquot,
 					    const long maxdeg){
-  int32_t *basis = calloc(nvars, sizeof(int32_t));
-  (*dquot) = 0;
-
-  if(is_divisible_lexp(nvars, length, (basis), bexp_lm)){
+  int32_t *basis = staircase_drl(length, nvars, bexp_lm, maxdeg, dquot);
+  if(basis == NULL){
     fprintf(ERRSTREAM, "Stop\n");
-    free(basis);
-    return NULL;
-  }
-  else{
-    (*dquot)++;
   }
-  int32_t *ind = calloc(nvars, sizeof(int32_t));
-
-#ifdef DEBUGHILBERT
-  fprintf(ERRSTREAM, "new = %ld \n", sum(ind, nvars) + nvars);
-#endif
-
-
-  int32_t *new_basis = malloc(sizeof(int32_t) * nvars * (sum(ind, nvars) + nvars));
-  long new_length = generate_new_elts_basis(nvars, ind, (*dquot),
-                                            basis, new_basis,
-                                            length, bexp_lm);
-#ifdef DEBUGHILBERT
-  display_monomials_from_array(ERRSTREAM, new_length, new_basis, gens);
-  fprintf(ERRSTREAM, "%ld new elements.\n", new_length);
-#endif
-  long deg = 1;
-  while(new_length>0 && deg <= maxdeg){
-    int32_t *basis2 = realloc(basis, ((*dquot) + new_length) * nvars * sizeof(int32_t));
-    if(basis2==NULL){
-      fprintf(ERRSTREAM, "Issue with realloc\n");
-      exit(1);
-    }
-
-    basis = basis2;
-    for(long i = 0; i < new_length; i++){
-      for(long k = 0; k < nvars; k++){
-        (basis)[((*dquot) + i)*nvars+k] = (new_basis)[i*nvars+k];
-      }
-    }
-
-    update_indices(ind, basis, *dquot, new_length, nvars);
-    (*dquot) += new_length;
-
-#ifdef DEBUGHILBERT
-    fprintf(ERRSTREAM, "Update indices\n");
-    for(long i = 0; i < nvars; i++) fprintf(ERRSTREAM, "%ld ", ind[i]);
-    fprintf(ERRSTREAM, "\n");
-    fprintf(ERRSTREAM, "new = %ld \n", sum(ind, nvars) + nvars);
-#endif
-
-    int32_t *new_basis2 = realloc(new_basis,
-                                 sizeof(int32_t) * nvars * (sum(ind, nvars) + nvars));
-    if(new_basis==NULL){
-      fprintf(ERRSTREAM, "Issue with realloc\n");
-      exit(1);
-    }
-    new_basis=new_basis2;
-    new_length = generate_new_elts_basis(nvars, ind, (*dquot),
-                                         basis, new_basis,
-                                         length, bexp_lm);
-#ifdef DEBUGHILBERT
-    fprintf(ERRSTREAM, "%ld new elements.\n", new_length);
-#endif
-    deg++;
-  }
-
-  free(new_basis);
-  free(ind);
   return basis;
 }
 
@@ -392,73 +521,11 @@ static inline int32_t *monomial_basis_colon(long length, long nvars,
 static inline int32_t *monomial_basis_colon_no_zero(long length, long nvars,
 						    int32_t *bexp_lm, long *dquot,
 						    const long maxdeg){
-  int32_t *basis = calloc(nvars, sizeof(int32_t));
-  (*dquot) = 0;
-
-  if(is_divisible_lexp(nvars, length, (basis), bexp_lm)){
+  int32_t *basis = staircase_drl(length, nvars, bexp_lm, maxdeg, dquot);
+  if(basis == NULL){
     fprintf(ERRSTREAM, "Stop\n");
-    free(basis);
     return NULL;
   }
-  else{
-    (*dquot)++;
-  }
-  int32_t *ind = calloc(nvars, sizeof(int32_t));
-
-#ifdef DEBUGHILBERT
-  fprintf(ERRSTREAM, "new = %ld \n", sum(ind, nvars) + nvars);
-#endif
-
-  int32_t *new_basis = malloc(sizeof(int32_t) * nvars * (sum(ind, nvars) + nvars));
-  long new_length = generate_new_elts_basis(nvars, ind, (*dquot),
-                                            basis, new_basis,
-                                            length, bexp_lm);
-#ifdef DEBUGHILBERT
-  display_monomials_from_array(ERRSTREAM, new_length, new_basis, gens);
-  fprintf(ERRSTREAM, "%ld new elements.\n", new_length);
-#endif
-  long deg = 1;
-  while(new_length>0 && deg <= maxdeg){
-    int32_t *basis2 = realloc(basis, ((*dquot) + new_length) * nvars * sizeof(int32_t));
-    if(basis2==NULL){
-      fprintf(ERRSTREAM, "Issue with realloc\n");
-      exit(1);
-    }
-
-    basis = basis2;
-    for(long i = 0; i < new_length; i++){
-      for(long k = 0; k < nvars; k++){
-        (basis)[((*dquot) + i)*nvars+k] = (new_basis)[i*nvars+k];
-      }
-    }
-
-    update_indices(ind, basis, *dquot, new_length, nvars);
-    (*dquot) += new_length;
-
-#ifdef DEBUGHILBERT
-    fprintf(ERRSTREAM, "Update indices\n");
-    for(long i = 0; i < nvars; i++) fprintf(ERRSTREAM, "%ld ", ind[i]);
-    fprintf(ERRSTREAM, "\n");
-    fprintf(ERRSTREAM, "new = %ld \n", sum(ind, nvars) + nvars);
-#endif
-
-    int32_t *new_basis2 = realloc(new_basis,
-                                 sizeof(int32_t) * nvars * (sum(ind, nvars) + nvars));
-    if(new_basis==NULL){
-      fprintf(ERRSTREAM, "Issue with realloc\n");
-      exit(1);
-    }
-    new_basis=new_basis2;
-    new_length = generate_new_elts_basis(nvars, ind, (*dquot),
-                                         basis, new_basis,
-                                         length, bexp_lm);
-#ifdef DEBUGHILBERT
-    fprintf(ERRSTREAM, "%ld new elements.\n", new_length);
-#endif
-    deg++;
-  }
-  free(new_basis);
-  free(ind);
 
   /* cleanup by removing monomials that will be sent to 0 after
      iterative multiplication by xn */
@@ -656,17 +723,6 @@ static inline int is_divisible_exponent_xxn(int32_t *exp1, int32_t *exp2,
   return ((exp1[nvars-1]+1) >= exp2[nvars-1]);
 }
 
-static inline int member_xxn(int32_t *exp, int32_t *bexp_lm, int len,
-                             long *pos, const int nv){
-  for(long i=1; i < len; i++){
-    if(is_equal_exponent_xxn(exp, bexp_lm + (i*nv), nv)){
-      *pos = i;
-      return 1;
-    }
-  }
-  return 0;
-}
-
 static inline void copy_poly_in_matrix_old(data_gens_ff_t *gens,
                                        sp_matfglm_t* matrix,
                                        long nrows,
@@ -731,6 +787,7 @@ static inline void copy_poly_in_matrix(sp_matfglm_t* matrix,
                                        int32_t *bcf, int32_t **bexp,
                                        int32_t **blen, long start, long pos,
                                        int32_t *lmb,
+                                       const lmb_index_t *lidx,
                                        const int nv,
                                        const long fc){
   int32_t j;
@@ -764,17 +821,11 @@ static inline void copy_poly_in_matrix(sp_matfglm_t* matrix,
       }
     }
     else{
-      long i;
-
       long N = nrows * matrix->ncols ;
-      long k = 0;
-      for(i = 0; i < matrix->ncols; i++){
-
-          if(is_equal_exponent((*bexp) + (end - 1 - k) * nv,
-                      lmb + i * nv,
-                      nv)){
-            matrix->dense_mat[N + i] = fc - bcf[end - 1 -  k];
-            k++;
+      for(j = start + 1; j < end; j++){
+        const long i = lmb_index_find(lidx, (*bexp) + j * nv, 0);
+        if(i >= 0){
+          matrix->dense_mat[N + i] = fc - bcf[j];
         }
       }
     }
@@ -785,6 +836,7 @@ static inline void
 copy_poly_in_matrixcol(sp_matfglmcol_t* matrix, long nrows,
 		       int32_t *bcf, int32_t **bexp, int32_t **blen,
 		       long start, long pos, int32_t *lmb,
+		       const lmb_index_t *lidx,
 		       const int nv, const long fc){
   int32_t j;
   long end = start + pos;//(*blen)[pos];
@@ -816,15 +868,11 @@ copy_poly_in_matrixcol(sp_matfglmcol_t* matrix, long nrows,
       }
     }
     else{
-      long i;
-
       long N = nrows * matrix->ncols ;
-      long k = 0;
-      for(i = 0; i < matrix->ncols; i++){
-	if(is_equal_exponent((*bexp) + (end - 1 - k) * nv,
-			     lmb + i * nv, nv)){
-	  matrix->dense_mat[N + i] = fc - bcf[end - 1 -  k];
-	  k++;
+      for(j = start + 1; j < end; j++){
+        const long i = lmb_index_find(lidx, (*bexp) + j * nv, 0);
+        if(i >= 0){
+          matrix->dense_mat[N + i] = fc - bcf[j];
         }
       }
     }
@@ -1030,49 +1078,32 @@ static inline void copy_poly_in_matrix_from_bs_8(sp_matfglm_t* matrix,
                                                long idx, long len,
                                                long start, long pos,
                                                int32_t *lmb,
+                                               const lmb_index_t *lidx,
                                                const int nv,
                                                const long fc){
   int32_t j;
   long end = start + pos;
 
-  long N = nrows * (matrix->ncols) - (start + 1);
+  CF_t *row = sp_matfglm_row(matrix, nrows);
   if((len) == matrix->ncols + 1){
     const bl_t bi = bs->lmps[idx];
     long k = 0;
     for(j = start + 1; j < end; j++){
       long ctmp  = bs->cf_8[bs->hm[bi][COEFFS]][len - k - 1];
       k++;
-      matrix->dense_mat[N + j] = fc - ctmp;
+      row[j - (start + 1)] = fc - ctmp;
     }
   }
   else{
-    if(1==0 && is_equal_exponent_dm(bs, ht, idx, 1,
-                            lmb+((end-start-2)*nv),
-                            nv)){
-      const bl_t bi = bs->lmps[idx];
-      long k = 0;
-      for(j = start + 1; j < end; j++){
-        long ctmp  = bs->cf_8[bs->hm[bi][COEFFS]][len - k];
-        k++;
-        matrix->dense_mat[N + j] = fc - ctmp; //bcf[(end + start) - j];
-      }
-    }
-    else{
-      long i;
-      long N = nrows * matrix->ncols ;
-      long k = 0;
-
-      const bl_t bi = bs->lmps[idx];
-
-      for(i = 0; i < matrix->ncols; i++){
-        int boo = is_equal_exponent_dm(bs, ht, idx, len - k - 1, //pos-1-k,
-                                       lmb + i * nv,
-                                       nv);
-        if(boo){
-            long ctmp  = bs->cf_8[bs->hm[bi][COEFFS]][len - k - 1];
-            matrix->dense_mat[N + i] = fc - ctmp; //fc - bcf[end - 1 -  k];
-            k++;
-        }
+    const bl_t bi = bs->lmps[idx];
+    const hm_t *dt = bs->hm[bi] + OFFSET;
+
+    /* the leading term is not in lmb, the other ones are */
+    for(long k = 1; k < len; k++){
+      const long i = lmb_index_find_ev(lidx, ht->ev[dt[k]], lidx->evi);
+      if(i >= 0){
+        long ctmp  = bs->cf_8[bs->hm[bi][COEFFS]][k];
+        row[i] = fc - ctmp;
       }
     }
   }
@@ -1093,49 +1124,32 @@ static inline void copy_poly_in_matrix_from_bs_16(sp_matfglm_t* matrix,
                                                long idx, long len,
                                                long start, long pos,
                                                int32_t *lmb,
+                                               const lmb_index_t *lidx,
                                                const int nv,
                                                const long fc){
   int32_t j;
   long end = start + pos;
 
-  long N = nrows * (matrix->ncols) - (start + 1);
+  CF_t *row = sp_matfglm_row(matrix, nrows);
   if((len) == matrix->ncols + 1){
     const bl_t bi = bs->lmps[idx];
     long k = 0;
     for(j = start + 1; j < end; j++){
       long ctmp  = bs->cf_16[bs->hm[bi][COEFFS]][len - k - 1];
       k++;
-      matrix->dense_mat[N + j] = fc - ctmp;
+      row[j - (start + 1)] = fc - ctmp;
     }
   }
   else{
-    if(1==0 && is_equal_exponent_dm(bs, ht, idx, 1,
-                            lmb+((end-start-2)*nv),
-                            nv)){
-      const bl_t bi = bs->lmps[idx];
-      long k = 0;
-      for(j = start + 1; j < end; j++){
-        long ctmp  = bs->cf_16[bs->hm[bi][COEFFS]][len - k];
-        k++;
-        matrix->dense_mat[N + j] = fc - ctmp; //bcf[(end + start) - j];
-      }
-    }
-    else{
-      long i;
-      long N = nrows * matrix->ncols ;
-      long k = 0;
-
-      const bl_t bi = bs->lmps[idx];
-
-      for(i = 0; i < matrix->ncols; i++){
-        int boo = is_equal_exponent_dm(bs, ht, idx, len - k - 1, //pos-1-k,
-                                       lmb + i * nv,
-                                       nv);
-        if(boo){
-            long ctmp  = bs->cf_16[bs->hm[bi][COEFFS]][len - k - 1];
-            matrix->dense_mat[N + i] = fc - ctmp; //fc - bcf[end - 1 -  k];
-            k++;
-        }
+    const bl_t bi = bs->lmps[idx];
+    const hm_t *dt = bs->hm[bi] + OFFSET;
+
+    /* the leading term is not in lmb, the other ones are */
+    for(long k = 1; k < len; k++){
+      const long i = lmb_index_find_ev(lidx, ht->ev[dt[k]], lidx->evi);
+      if(i >= 0){
+        long ctmp  = bs->cf_16[bs->hm[bi][COEFFS]][k];
+        row[i] = fc - ctmp;
       }
     }
   }
@@ -1156,49 +1170,32 @@ static inline void copy_poly_in_matrix_from_bs_32(sp_matfglm_t* matrix,
                                                long idx, long len,
                                                long start, long pos,
                                                int32_t *lmb,
+                                               const lmb_index_t *lidx,
                                                const int nv,
                                                const long fc){
   int32_t j;
   long end = start + pos;
 
-  long N = nrows * (matrix->ncols) - (start + 1);
+  CF_t *row = sp_matfglm_row(matrix, nrows);
   if((len) == matrix->ncols + 1){
     const bl_t bi = bs->lmps[idx];
     long k = 0;
     for(j = start + 1; j < end; j++){
       long ctmp  = bs->cf_32[bs->hm[bi][COEFFS]][len - k - 1];
       k++;
-      matrix->dense_mat[N + j] = fc - ctmp;
+      row[j - (start + 1)] = fc - ctmp;
     }
   }
   else{
-    if(1==0 && is_equal_exponent_dm(bs, ht, idx, 1,
-                            lmb+((end-start-2)*nv),
-                            nv)){
-      const bl_t bi = bs->lmps[idx];
-      long k = 0;
-      for(j = start + 1; j < end; j++){
-        long ctmp  = bs->cf_32[bs->hm[bi][COEFFS]][len - k];
-        k++;
-        matrix->dense_mat[N + j] = fc - ctmp; //bcf[(end + start) - j];
-      }
-    }
-    else{
-      long i;
-      long N = nrows * matrix->ncols ;
-      long k = 0;
-
-      const bl_t bi = bs->lmps[idx];
-
-      for(i = 0; i < matrix->ncols; i++){
-        int boo = is_equal_exponent_dm(bs, ht, idx, len - k - 1, //pos-1-k,
-                                       lmb + i * nv,
-                                       nv);
-        if(boo){
-            long ctmp  = bs->cf_32[bs->hm[bi][COEFFS]][len - k - 1];
-            matrix->dense_mat[N + i] = fc - ctmp; //fc - bcf[end - 1 -  k];
-            k++;
-        }
+    const bl_t bi = bs->lmps[idx];
+    const hm_t *dt = bs->hm[bi] + OFFSET;
+
+    /* the leading term is not in lmb, the other ones are */
+    for(long k = 1; k < len; k++){
+      const long i = lmb_index_find_ev(lidx, ht->ev[dt[k]], lidx->evi);
+      if(i >= 0){
+        long ctmp  = bs->cf_32[bs->hm[bi][COEFFS]][k];
+        row[i] = fc - ctmp;
       }
     }
   }
@@ -1208,6 +1205,7 @@ static inline void copy_nf_in_matrix_from_bs_8(sp_matfglm_t* matrix,
                                                long nrows,
                                                long pos,
                                                int32_t *lmb,
+                                               const lmb_index_t *lidx,
 					       const bs_t * const tbr,
 					       const ht_t * const bht,
 					       int32_t * evi,
@@ -1217,15 +1215,11 @@ static inline void copy_nf_in_matrix_from_bs_8(sp_matfglm_t* matrix,
   if (tbr->hm[idx] != NULL) { /* copy only for a nonzero polynomial */
     len_t * hm = tbr->hm[idx]+OFFSET;
     len_t len = tbr->hm[idx][LENGTH];
-    long N = nrows * matrix->ncols ;
-    long i = 0;
-    long k = 0;
-    while(k < len) {
-      if(is_equal_exponent_bs(bht,hm[len-1-k],evi,lmb + i * nv,nv)){
-	matrix->dense_mat[N + i] = tbr->cf_8[tbr->hm[idx][COEFFS]][len-1-k];
-	k++;
-      }
-      i++;
+    CF_t *row = sp_matfglm_row(matrix, nrows);
+    for(long k = 0; k < len; k++){
+      const long i = lmb_index_find_ev(lidx, bht->ev[hm[k]], evi);
+      if(i >= 0)
+        row[i] = tbr->cf_8[tbr->hm[idx][COEFFS]][k];
     }
   }
 }
@@ -1234,6 +1228,7 @@ static inline void copy_nf_in_matrix_from_bs_16(sp_matfglm_t* matrix,
 						long nrows,
 						long pos,
 						int32_t *lmb,
+						const lmb_index_t *lidx,
 						const bs_t * const tbr,
 						const ht_t * const bht,
 						int32_t * evi,
@@ -1243,15 +1238,11 @@ static inline void copy_nf_in_matrix_from_bs_16(sp_matfglm_t* matrix,
   if (tbr->hm[idx] != NULL) { /* copy only for a nonzero polynomial */
     len_t * hm = tbr->hm[idx]+OFFSET;
     len_t len = tbr->hm[idx][LENGTH];
-    long N = nrows * matrix->ncols ;
-    long i = 0;
-    long k = 0;
-    while(k < len) {
-      if(is_equal_exponent_bs(bht,hm[len-1-k],evi,lmb + i * nv,nv)){
-	matrix->dense_mat[N + i] = tbr->cf_16[tbr->hm[idx][COEFFS]][len-1-k];
-	k++;
-      }
-      i++;
+    CF_t *row = sp_matfglm_row(matrix, nrows);
+    for(long k = 0; k < len; k++){
+      const long i = lmb_index_find_ev(lidx, bht->ev[hm[k]], evi);
+      if(i >= 0)
+        row[i] = tbr->cf_16[tbr->hm[idx][COEFFS]][k];
     }
   }
 }
@@ -1260,6 +1251,7 @@ static inline void copy_nf_in_matrix_from_bs_32(sp_matfglm_t* matrix,
 						long nrows,
 						long pos,
 						int32_t *lmb,
+						const lmb_index_t *lidx,
 						const bs_t * const tbr,
 						const ht_t * const bht,
 						int32_t * evi,
@@ -1269,15 +1261,11 @@ static inline void copy_nf_in_matrix_from_bs_32(sp_matfglm_t* matrix,
   if (tbr->hm[idx] != NULL) { /* copy only for a nonzero polynomial */
     len_t * hm = tbr->hm[idx]+OFFSET;
     len_t len = tbr->hm[idx][LENGTH];
-    long N = nrows * matrix->ncols ;
-    long i = 0;
-    long k = 0;
-    while(k < len) {
-      if(is_equal_exponent_bs(bht,hm[len-1-k],evi,lmb + i * nv,nv)){
-	matrix->dense_mat[N + i] = tbr->cf_32[tbr->hm[idx][COEFFS]][len-1-k];
-	k++;
-      }
-      i++;
+    CF_t *row = sp_matfglm_row(matrix, nrows);
+    for(long k = 0; k < len; k++){
+      const long i = lmb_index_find_ev(lidx, bht->ev[hm[k]], evi);
+      if(i >= 0)
+        row[i] = tbr->cf_32[tbr->hm[idx][COEFFS]][k];
     }
   }
 }
@@ -1300,89 +1288,7 @@ static inline int32_t *monomial_basis_enlarged(long length, long nvars,
 
   int32_t maxdeg = sum(bexp_lm+(length-1)*(nvars), nvars);
 
-  /* basis will contain the monomial basis */
-  int32_t *basis = calloc(nvars, sizeof(int32_t));
-  (*dquot) = 0;
-
-  int32_t deg = 0;
-
-  if(is_divisible_lexp(nvars, length, basis, bexp_lm)){
-    free(basis);
-    return NULL;
-  }
-  else{
-    (*dquot)++;
-  }
-
-  int32_t *ind = calloc(nvars, sizeof(int32_t));
-
-#ifdef DEBUGHILBERT
-  fprintf(ERRSTREAM, "new = %ld \n", sum(ind, nvars) + nvars);
-#endif
-  uint64_t len_newbs = nvars * (sum(ind, nvars) + nvars);
-
-  int32_t *new_basis = malloc(sizeof(int32_t) * len_newbs);
-  /* generates monomial basis candidates of degree 1 */
-  int32_t new_length = generate_new_elts_basis(nvars, ind, (*dquot),
-                                               basis, new_basis, length, bexp_lm);
-
-  deg++;
-#ifdef DEBUGHILBERT
-  //  display_monomials_from_array(ERRSTREAM, new_length, new_basis, gens);
-  fprintf(ERRSTREAM, "%ld new elements.\n", new_length);
-#endif
-
-  while(new_length>0 && deg <= maxdeg){
-    int32_t *basis2 = realloc(basis,
-                              ((*dquot) + new_length) * (nvars) * sizeof(int32_t));
-    if(basis2==NULL){
-      fprintf(ERRSTREAM, "Issue with realloc\n");
-      exit(1);
-    }
-
-    basis = basis2;
-
-    for(long i = 0; i < new_length; i++){
-      for(long k = 0; k < nvars; k++){
-        (basis)[((*dquot) + i)*(nvars)+k] = (new_basis)[i*(nvars)+k];
-      }
-    }
-
-    update_indices(ind, basis, *dquot, new_length, nvars);
-
-
-    (*dquot) += new_length;
-
-#ifdef DEBUGHILBERT
-    fprintf(ERRSTREAM, "Update indices\n");
-    for(long i = 0; i < nvars; i++) fprintf(ERRSTREAM, "%ld ", ind[i]);
-    fprintf(ERRSTREAM, "\n");
-    fprintf(ERRSTREAM, "new = %ld \n", sum(ind, nvars) + nvars);
-#endif
-
-    len_newbs = nvars * (sum(ind, nvars) + nvars);
-
-    int32_t *new_basis2 = realloc(new_basis,
-                                  sizeof(int32_t) * len_newbs);
-    if(new_basis==NULL){
-      fprintf(ERRSTREAM, "Issue with realloc\n");
-      exit(1);
-    }
-    new_basis=new_basis2;
-
-    new_length = generate_new_elts_basis(nvars, ind, (*dquot),
-                                         basis, new_basis,
-                                         length, bexp_lm);
-    deg++;
-
-#ifdef DEBUGHILBERT
-    fprintf(ERRSTREAM, "%ld new elements.\n", new_length);
-#endif
-  }
-
-  free(new_basis);
-  free(ind);
-  return basis;
+  return staircase_drl(length, nvars, bexp_lm, maxdeg, dquot);
 }
 
 /**
@@ -1401,6 +1307,9 @@ static inline sp_matfglm_t * build_matrixn(int32_t *lmb, long dquot, int32_t bld
                                            int32_t *bcf,
                                            int32_t *bexp_lm,
                                            const int nv, const long fc){
+  lmb_index_t lidx;
+  lmb_index_init(&lidx, lmb, dquot, nv, NULL);
+
 
 
   /* takes monomials in bexp_lm which are reducible by xn */
@@ -1507,7 +1416,7 @@ static inline sp_matfglm_t * build_matrixn(int32_t *lmb, long dquot, int32_t bld
 #if DEBUGBUILDMATRIX > 0
     display_monomial_full(ERRSTREAM, nv, NULL, 0, exp);
 #endif
-    if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
+    if(member_xxn_index(&lidx, i, &pos)){
 #if DEBUGBUILDMATRIX > 0
       fprintf(ERRSTREAM, " => remains in monomial basis\n");
 #endif
@@ -1527,7 +1436,7 @@ static inline sp_matfglm_t * build_matrixn(int32_t *lmb, long dquot, int32_t bld
       if(is_equal_exponent_xxn(exp, bexp_lm+(div_xn[count])*nv, nv)){
         copy_poly_in_matrix(matrix, nrows, bcf, bexp, blen,
                             start_cf_gb_xn[count], len_gb_xn[count], lmb,
-                            nv, fc);
+                            &lidx, nv, fc);
         nrows++;
         count++;
         if(len_xn < count && i < dquot){
@@ -1541,6 +1450,7 @@ static inline sp_matfglm_t * build_matrixn(int32_t *lmb, long dquot, int32_t bld
           free(len_gb_xn);
           free(start_cf_gb_xn);
           free(div_xn);
+          lmb_index_clear(&lidx);
           return NULL;
         }
       }
@@ -1560,6 +1470,7 @@ static inline sp_matfglm_t * build_matrixn(int32_t *lmb, long dquot, int32_t bld
         free(len_gb_xn);
         free(start_cf_gb_xn);
         free(div_xn);
+        lmb_index_clear(&lidx);
         return matrix;
       }
     }
@@ -1581,6 +1492,7 @@ static inline sp_matfglm_t * build_matrixn(int32_t *lmb, long dquot, int32_t bld
   free(start_cf_gb_xn);
   free(div_xn);
 
+  lmb_index_clear(&lidx);
   return matrix;
 }
 
@@ -1605,6 +1517,9 @@ build_matrixn_colon(int32_t *lmb, long dquot, int32_t bld,
 		    const data_gens_ff_t *gens,
 		    uint32_t * leftvector,
 		    uint32_t ** leftvectorsparam, long suppsize){
+  lmb_index_t lidx;
+  lmb_index_init(&lidx, lmb, dquot, nv, bht);
+
 
   const len_t ebl = bht->ebl;
   const len_t evl = bht->evl;
@@ -1665,7 +1580,7 @@ build_matrixn_colon(int32_t *lmb, long dquot, int32_t bld,
   for (long i = 0; i < dquot; i++) {
         long pos = -1;
 	int32_t *exp = lmb + (i * nv);
-	if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
+	if(member_xxn_index(&lidx, i, &pos)){
 #if DEBUGBUILDMATRIX>0
 	  display_monomial_full(ERRSTREAM, nv, NULL, 0, exp);
 	  fprintf(ERRSTREAM, " => remains in monomial basis\n");
@@ -1872,7 +1787,7 @@ build_matrixn_colon(int32_t *lmb, long dquot, int32_t bld,
     long pos = -1;
     int32_t *exp = lmb + (i * nv);
     /* display_monomial_full(ERRSTREAM, nv, NULL, 0, exp); */
-    if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
+    if(member_xxn_index(&lidx, i, &pos)){
 #if DEBUGBUILDMATRIX > 0
       display_monomial_full(ERRSTREAM, nv, NULL, 0, exp);
       fprintf(ERRSTREAM, " => remains in monomial basis\n");
@@ -1906,7 +1821,7 @@ build_matrixn_colon(int32_t *lmb, long dquot, int32_t bld,
 #endif
 	  copy_poly_in_matrixcol(matrix, nrows, bcf, bexp, blen,
 				 start_cf_gb_xn[count], len_gb_xn[count], lmb,
-				 nv, fc);
+				 &lidx, nv, fc);
 	  nrows++;
 	  count++;
 	  if(len_xn < count && i < dquot){
@@ -1926,6 +1841,7 @@ build_matrixn_colon(int32_t *lmb, long dquot, int32_t bld,
 	    free(start_cf_gb_xn);
 	    free(div_xn);
 	    free(div_not_xn);
+	    lmb_index_clear(&lidx);
 	    return NULL;
 	  }
 	}
@@ -2019,6 +1935,7 @@ build_matrixn_colon(int32_t *lmb, long dquot, int32_t bld,
   free(start_cf_gb_xn);
   free(div_xn);
   free(div_not_xn);
+  lmb_index_clear(&lidx);
   return matrix;
 }
 
@@ -2044,6 +1961,9 @@ build_matrixn_colon_no_zero(int32_t *lmb, long dquot, int32_t bld,
 			    const data_gens_ff_t *gens,
 			    uint32_t * leftvector,
 			    uint32_t ** leftvectorsparam, long suppsize){
+  lmb_index_t lidx;
+  lmb_index_init(&lidx, lmb, dquot, nv, bht);
+
 
   const len_t ebl = bht->ebl;
   const len_t evl = bht->evl;
@@ -2115,7 +2035,7 @@ build_matrixn_colon_no_zero(int32_t *lmb, long dquot, int32_t bld,
   for (long i = 0; i < dquot; i++) {
         long pos = -1;
 	int32_t *exp = lmb + (i * nv);
-	if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
+	if(member_xxn_index(&lidx, i, &pos)){
 #if DEBUGBUILDMATRIX > 0
 	  display_monomial_full(ERRSTREAM, nv, NULL, 0, exp);
 	  fprintf(ERRSTREAM, " => remains in monomial basis\n");
@@ -2330,7 +2250,7 @@ build_matrixn_colon_no_zero(int32_t *lmb, long dquot, int32_t bld,
     long pos = -1;
     int32_t *exp = lmb + (i * nv);
     /* display_monomial_full(ERRSTREAM, nv, NULL, 0, exp); */
-    if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
+    if(member_xxn_index(&lidx, i, &pos)){
 #if DEBUGBUILDMATRIX > 0
       display_monomial_full(ERRSTREAM, nv, NULL, 0, exp);
       fprintf(ERRSTREAM, " => remains in monomial basis\n");
@@ -2384,6 +2304,7 @@ build_matrixn_colon_no_zero(int32_t *lmb, long dquot, int32_t bld,
 	    free(start_cf_gb_xn);
 	    free(div_xn);
 	    free(div_not_xn);
+	    lmb_index_clear(&lidx);
 	    return NULL;
 	  }
 	}
@@ -2434,6 +2355,7 @@ build_matrixn_colon_no_zero(int32_t *lmb, long dquot, int32_t bld,
   free(start_cf_gb_xn);
   free(div_xn);
   free(div_not_xn);
+  lmb_index_clear(&lidx);
   return matrix;
 }
 
@@ -2457,6 +2379,9 @@ static inline sp_matfglm_t * build_matrixn_trace(int32_t **bdiv_xn,
                                                  int32_t *bcf,
                                                  int32_t *bexp_lm,
                                                  const int nv, const long fc){
+  lmb_index_t lidx;
+  lmb_index_init(&lidx, lmb, dquot, nv, NULL);
+
 
 
   *bdiv_xn = calloc((unsigned long)bld, sizeof(int32_t));
@@ -2565,7 +2490,7 @@ static inline sp_matfglm_t * build_matrixn_trace(int32_t **bdiv_xn,
     display_monomial_full(ERRSTREAM, nv, NULL, 0, exp);
     //    fprintf(ERRSTREAM, "\n");
 #endif
-    if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
+    if(member_xxn_index(&lidx, i, &pos)){
 #if DEBUGBUILDMATRIX > 0
       fprintf(ERRSTREAM, " => remains in monomial basis\n");
 #endif
@@ -2585,7 +2510,7 @@ static inline sp_matfglm_t * build_matrixn_trace(int32_t **bdiv_xn,
       if(is_equal_exponent_xxn(exp, bexp_lm+(div_xn[count])*nv, nv)){
         copy_poly_in_matrix(matrix, nrows, bcf, bexp, blen,
                             start_cf_gb_xn[count], len_gb_xn[count], lmb,
-                            nv, fc);
+                            &lidx, nv, fc);
         nrows++;
         count++;
         if(len_xn < count && i < dquot){
@@ -2600,6 +2525,7 @@ static inline sp_matfglm_t * build_matrixn_trace(int32_t **bdiv_xn,
           free(len_gb_xn);
           free(start_cf_gb_xn);
           free(div_xn);
+          lmb_index_clear(&lidx);
           return NULL;
         }
       }
@@ -2618,6 +2544,7 @@ static inline sp_matfglm_t * build_matrixn_trace(int32_t **bdiv_xn,
         free(len_gb_xn);
         free(start_cf_gb_xn);
         free(div_xn);
+        lmb_index_clear(&lidx);
         return NULL;
       }
     }
@@ -2634,6 +2561,7 @@ static inline sp_matfglm_t * build_matrixn_trace(int32_t **bdiv_xn,
     }
   }
 
+  lmb_index_clear(&lidx);
   return matrix;
 }
 
@@ -2657,6 +2585,9 @@ static inline sp_matfglm_t * build_matrixn_from_bs(int32_t *lmb, long dquot,
                                                    ht_t *ht,
                                                    int32_t *bexp_lm,
                                                    const int nv, const long fc){
+  lmb_index_t lidx;
+  lmb_index_init(&lidx, lmb, dquot, nv, ht);
+
 
 
   int32_t *div_xn = calloc(bs->lml, sizeof(int32_t));
@@ -2761,7 +2692,7 @@ static inline sp_matfglm_t * build_matrixn_from_bs(int32_t *lmb, long dquot,
     display_monomial_full(ERRSTREAM, nv, NULL, 0, exp);
     //    fprintf(ERRSTREAM, "\n");
 #endif
-    if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
+    if(member_xxn_index(&lidx, i, &pos)){
 #if DEBUGBUILDMATRIX > 0
       fprintf(ERRSTREAM, " => remains in monomial basis\n");
 #endif
@@ -2782,7 +2713,7 @@ static inline sp_matfglm_t * build_matrixn_from_bs(int32_t *lmb, long dquot,
         copy_poly_in_matrix_from_bs(matrix, nrows, bs, ht, //bcf, bexp, blen,
                                     div_xn[count], len_gb_xn[count],
                                     start_cf_gb_xn[count], len_gb_xn[count], lmb,
-                                    nv, fc);
+                                    &lidx, nv, fc);
         nrows++;
         count++;
         if(len_xn < count && i < dquot){
@@ -2797,6 +2728,7 @@ static inline sp_matfglm_t * build_matrixn_from_bs(int32_t *lmb, long dquot,
           free(len_gb_xn);
           free(start_cf_gb_xn);
           free(div_xn);
+          lmb_index_clear(&lidx);
           return NULL;
         }
       }
@@ -2815,6 +2747,7 @@ static inline sp_matfglm_t * build_matrixn_from_bs(int32_t *lmb, long dquot,
         free(len_gb_xn);
         free(start_cf_gb_xn);
         free(div_xn);
+        lmb_index_clear(&lidx);
         return NULL;
       }
     }
@@ -2835,6 +2768,7 @@ static inline sp_matfglm_t * build_matrixn_from_bs(int32_t *lmb, long dquot,
   free(start_cf_gb_xn);
   free(div_xn);
 
+  lmb_index_clear(&lidx);
   return matrix;
 }
 
@@ -2907,14 +2841,19 @@ static inline void build_matrixn_from_bs_trace_application(sp_matfglm_t *matrix,
                                                            int32_t *bexp_lm,
 							   const int nv,
                                                            const long fc){
+  lmb_index_t lidx;
+  lmb_index_init(&lidx, lmb, dquot, nv, ht);
+
 
   uint32_t len_xn = matrix->nrows;
   matrix->charac = fc;
   uint64_t len1 = dquot * matrix->nrows;
   int32_t len2 = dquot - matrix->nrows;
 
-  for(uint64_t i = 0; i < len1; i++){
-    matrix->dense_mat[i] = 0;
+  if(!sp_matfglm_is_compressed(matrix)){
+    for(uint64_t i = 0; i < len1; i++){
+      matrix->dense_mat[i] = 0;
+    }
   }
   for(int32_t i = 0; i < (dquot-len_xn); i++){
     matrix->triv_idx[i] = 0;
@@ -2954,7 +2893,7 @@ static inline void build_matrixn_from_bs_trace_application(sp_matfglm_t *matrix,
 #if DEBUGBUILDMATRIX > 0
     display_monomial_full(ERRSTREAM, nv, NULL, 0, exp);
 #endif
-    if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
+    if(member_xxn_index(&lidx, i, &pos)){
 #if DEBUGBUILDMATRIX > 0
       fprintf(ERRSTREAM, " => remains in monomial basis\n");
 #endif
@@ -2975,7 +2914,10 @@ static inline void build_matrixn_from_bs_trace_application(sp_matfglm_t *matrix,
         copy_poly_in_matrix_from_bs(matrix, nrows, bs, ht, //bcf, bexp, blen,
                                     div_xn[count], len_gb_xn[count],
                                     start_cf_gb_xn[count], len_gb_xn[count], lmb,
-                                    nv, fc);
+                                    &lidx, nv, fc);
+        if(sp_matfglm_is_compressed(matrix)){
+          sp_matfglm_compress_row(matrix, nrows, matrix->cmp_buf);
+        }
         nrows++;
         count++;
         if(len_xn < count && i < dquot){
@@ -3008,13 +2950,15 @@ static inline void build_matrixn_from_bs_trace_application(sp_matfglm_t *matrix,
         free(len_gb_xn);
         free(start_cf_gb_xn);
         free(div_xn);
+        lmb_index_clear(&lidx);
         return ;
         //        exit(1);
       }
     }
   }
   //Ici on support que les entres de matrix->dst sont initialisees a 0
-  for(uint32_t i = 0; i < matrix->nrows; i++){
+  //(dst est deja calcule par sp_matfglm_compress_row sinon)
+  for(uint32_t i = 0; i < matrix->nrows && !sp_matfglm_is_compressed(matrix); i++){
     for(int32_t j = matrix->ncols - 1; j >= 0; j--){
       if(matrix->dense_mat[i*matrix->ncols + j] == 0){
         matrix->dst[i]++;
@@ -3024,6 +2968,140 @@ static inline void build_matrixn_from_bs_trace_application(sp_matfglm_t *matrix,
       }
     }
   }
+  lmb_index_clear(&lidx);
+}
+
+/* fills the rows of matrix once their sources are known: row r is the
+ * tail of the element div_xn[row_src[r]] of bs if row_src[r] >= 0, and the
+ * normal form -row_src[r]-1 of tbr otherwise. Rows are independent, so
+ * they are filled in parallel. For compressed storage, consecutive rows are
+ * compressed by chunks in buffers of their own, which are then copied one
+ * after the other to cmp_data. nzcfs gets the number of nonzero entries of
+ * both kinds of rows. */
+static inline void fill_matrix_rows_from_bs(sp_matfglm_t *matrix,
+                                            const long *row_src,
+                                            const long nrows,
+                                            const int32_t *div_xn,
+                                            const int32_t *len_gb_xn,
+                                            const int32_t *start_cf_gb_xn,
+                                            bs_t *bs, ht_t *ht,
+                                            const bs_t *tbr, int32_t *evi,
+                                            int32_t *lmb,
+                                            const lmb_index_t *lidx,
+                                            const md_t *st, const int nv,
+                                            const long fc, long *nzcfs){
+  const long ncols = matrix->ncols;
+  long nzfree = 0, nznonfree = 0;
+
+  if(sp_matfglm_is_compressed(matrix)){
+    long nchunks = 4 * st->nthrds;
+    if(nchunks > nrows){
+      nchunks = nrows > 0 ? nrows : 1;
+    }
+    CF_t **cdata = (CF_t **)calloc(nchunks, sizeof(CF_t *));
+    uint64_t *clen = (uint64_t *)calloc(nchunks + 1, sizeof(uint64_t));
+#pragma omp parallel for num_threads(st->nthrds) schedule(dynamic, 1) \
+  reduction(+:nzfree, nznonfree)
+    for(long t = 0; t < nchunks; t++){
+      /* same matrix with a work row of its own for the copy functions */
+      sp_matfglm_t tmat = *matrix;
+      tmat.cmp_buf = (CF_t *)calloc(ncols, sizeof(CF_t));
+      uint64_t alloc = 0;
+      for(long r = t * nrows / nchunks; r < (t + 1) * nrows / nchunks; r++){
+        const long c = row_src[r];
+        if(c >= 0){
+          copy_poly_in_matrix_from_bs(&tmat, r, bs, ht,
+                                      div_xn[c], len_gb_xn[c],
+                                      start_cf_gb_xn[c], len_gb_xn[c], lmb,
+                                      lidx, nv, fc);
+        }
+        else{
+          copy_nf_in_matrix_from_bs(&tmat, r, -c - 1, lmb, lidx,
+                                    tbr, ht, evi, st, nv);
+        }
+        long nz = 0;
+        for(long j = 0; j < ncols; j++){
+          nz += (tmat.cmp_buf[j] != 0);
+        }
+        if(c >= 0){
+          nzfree += nz;
+        }
+        else{
+          nznonfree += nz;
+        }
+        /* offset within the chunk, shifted below */
+        matrix->cmp_off[r] = clen[t + 1];
+        sp_matfglm_append_row(cdata + t, &alloc, clen + t + 1,
+                              matrix->cmp_nnz + r, matrix->dst + r,
+                              ncols, tmat.cmp_buf);
+      }
+      free(tmat.cmp_buf);
+    }
+    for(long t = 0; t < nchunks; t++){
+      clen[t + 1] += clen[t];
+    }
+    if(clen[nchunks] + 1 > matrix->cmp_alloc){
+      CF_t *tmp = (CF_t *)realloc(matrix->cmp_data,
+                                  (clen[nchunks] + 1) * sizeof(CF_t));
+      if(tmp == NULL){
+        fprintf(ERRSTREAM, "Problem when allocating compressed matrix (amount = %lu)\n",
+                (unsigned long)(clen[nchunks] + 1));
+        exit(1);
+      }
+      matrix->cmp_data  = tmp;
+      matrix->cmp_alloc = clen[nchunks] + 1;
+    }
+#pragma omp parallel for num_threads(st->nthrds) schedule(dynamic, 1)
+    for(long t = 0; t < nchunks; t++){
+      for(long r = t * nrows / nchunks; r < (t + 1) * nrows / nchunks; r++){
+        matrix->cmp_off[r] += clen[t];
+      }
+      if(cdata[t] != NULL){
+        memcpy(matrix->cmp_data + clen[t], cdata[t],
+               (clen[t + 1] - clen[t]) * sizeof(CF_t));
+      }
+      free(cdata[t]);
+    }
+    matrix->cmp_len = clen[nchunks];
+    free(cdata);
+    free(clen);
+    nzcfs[0] = nzfree;
+    nzcfs[1] = nznonfree;
+    return;
+  }
+#pragma omp parallel for num_threads(st->nthrds) schedule(dynamic, 16) \
+  reduction(+:nzfree, nznonfree)
+  for(long r = 0; r < nrows; r++){
+    const long c = row_src[r];
+    CF_t *row = matrix->dense_mat + r * ncols;
+    if(c >= 0){
+      copy_poly_in_matrix_from_bs(matrix, r, bs, ht,
+                                  div_xn[c], len_gb_xn[c],
+                                  start_cf_gb_xn[c], len_gb_xn[c], lmb,
+                                  lidx, nv, fc);
+    }
+    else{
+      copy_nf_in_matrix_from_bs(matrix, r, -c - 1, lmb, lidx,
+                                tbr, ht, evi, st, nv);
+    }
+    long nz = 0;
+    for(long j = 0; j < ncols; j++){
+      nz += (row[j] != 0);
+    }
+    if(c >= 0){
+      nzfree += nz;
+    }
+    else{
+      nznonfree += nz;
+    }
+    long d = 0;
+    for(long j = ncols - 1; j >= 0 && row[j] == 0; j--){
+      d++;
+    }
+    matrix->dst[r] = d;
+  }
+  nzcfs[0] = nzfree;
+  nzcfs[1] = nznonfree;
 }
 
 static inline void build_matrixn_unstable_from_bs_trace_application(sp_matfglm_t *matrix,
@@ -3042,6 +3120,9 @@ static inline void build_matrixn_unstable_from_bs_trace_application(sp_matfglm_t
 								    const int nv,
 								    const long fc,
 								    const int thread_number){
+  lmb_index_t lidx;
+  lmb_index_init(&lidx, lmb, dquot, nv, ht);
+
   const len_t ebl = ht->ebl;
   const len_t evl = ht->evl;
   int32_t *evi    =  (int *)malloc((unsigned long)nv * sizeof(int));
@@ -3057,7 +3138,7 @@ static inline void build_matrixn_unstable_from_bs_trace_application(sp_matfglm_t
       evi[i-2]    =   i;
     }
   }
-  bs_t *tbr;
+  bs_t *tbr = NULL;
   long count_not_lm = matrix->nnfs;
   if (count_not_lm) {
     md_t *md = copy_meta_data(st,fc);
@@ -3086,8 +3167,10 @@ static inline void build_matrixn_unstable_from_bs_trace_application(sp_matfglm_t
   long len1 = dquot * len0;
   long len2 = dquot - len0;
 
-  for(long i = 0; i < len1; i++){
-    matrix->dense_mat[i] = 0;
+  if(!sp_matfglm_is_compressed(matrix)){
+    for(long i = 0; i < len1; i++){
+      matrix->dense_mat[i] = 0;
+    }
   }
   for(long i = 0; i < len2; i++){
     matrix->triv_idx[i] = 0;
@@ -3121,6 +3204,8 @@ static inline void build_matrixn_unstable_from_bs_trace_application(sp_matfglm_t
   long nrows = 0;
   long count = 0;
   long count_nf = 0;
+  /* source of each dense row, see fill_matrix_rows_from_bs */
+  long *row_src = malloc(sizeof(long) * (len0 + 1));
 
   for(long i = 0; i < dquot; i++){
     long pos = -1;
@@ -3128,7 +3213,7 @@ static inline void build_matrixn_unstable_from_bs_trace_application(sp_matfglm_t
 #if DEBUGBUILDMATRIX > 0
     display_monomial_full(ERRSTREAM, nv, NULL, 0, exp);
 #endif
-    if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
+    if(member_xxn_index(&lidx, i, &pos)){
 #if DEBUGBUILDMATRIX > 0
       fprintf(ERRSTREAM, " => remains in monomial basis\n");
 #endif
@@ -3146,10 +3231,7 @@ static inline void build_matrixn_unstable_from_bs_trace_application(sp_matfglm_t
       matrix->dense_idx[l_dens] = i;
       l_dens++;
       if(is_equal_exponent_xxn(exp, bexp_lm+(div_xn[count])*nv, nv)){
-        copy_poly_in_matrix_from_bs(matrix, nrows, bs, ht, //bcf, bexp, blen,
-                                    div_xn[count], len_gb_xn[count],
-                                    start_cf_gb_xn[count], len_gb_xn[count], lmb,
-                                    nv, fc);
+        row_src[nrows] = count;
         nrows++;
         count++;
         if(len_xn < count && i < dquot){
@@ -3177,8 +3259,7 @@ static inline void build_matrixn_unstable_from_bs_trace_application(sp_matfglm_t
 #if DEBUGBUILDMATRIX > 0
 	fprintf(ERRSTREAM, " => lands on a MULTIPLE of a leading monomial\n");
 #endif
-	copy_nf_in_matrix_from_bs(matrix, nrows, count_nf, lmb,
-				  tbr, ht, evi, st, nv);
+	row_src[nrows] = -count_nf - 1;
 	nrows++;
 	count_nf++;
 	if (count_not_lm < count_nf && i < dquot) {
@@ -3223,26 +3304,23 @@ static inline void build_matrixn_unstable_from_bs_trace_application(sp_matfglm_t
         free(start_cf_gb_xn);
         free(div_xn);
 	free(evi);
+        free(row_src);
+        lmb_index_clear(&lidx);
         return ;
         //        exit(1);
       }
     }
   }
-  //Ici on suppose que les entres de matrix->dst sont initialisees a 0
-  for(long i = 0; i < matrix->nrows; i++){
-    for(long j = matrix->ncols - 1; j >= 0; j--){
-      if(matrix->dense_mat[i*matrix->ncols + j] == 0){
-        matrix->dst[i]++;
-      }
-      else{
-        break;
-      }
-    }
-  }
+  long nzcfs[2];
+  fill_matrix_rows_from_bs(matrix, row_src, nrows, div_xn, len_gb_xn,
+                           start_cf_gb_xn, bs, ht, tbr, evi, lmb, &lidx,
+                           st, nv, fc, nzcfs);
+  free(row_src);
   if (count_not_lm) {
     free_basis_without_hash_table(&tbr);
   }
   free(evi);
+  lmb_index_clear(&lidx);
   /* if(st->info_level){ */
   /*   fprintf(ERRSTREAM, "[%lu, %lu], Free / Dense = %.2f%%\n", */
   /*           len0, len_xn, */
@@ -3261,6 +3339,9 @@ static inline sp_matfglm_t * build_matrixn_from_bs_trace(int32_t **bdiv_xn,
                                                          const int nv,
                                                          const long fc,
                                                          const int info_level){
+  lmb_index_t lidx;
+  lmb_index_init(&lidx, lmb, dquot, nv, ht);
+
 
 
   *bdiv_xn = calloc((unsigned long)bs->lml, sizeof(int32_t));
@@ -3370,7 +3451,7 @@ static inline sp_matfglm_t * build_matrixn_from_bs_trace(int32_t **bdiv_xn,
     display_monomial_full(ERRSTREAM, nv, NULL, 0, exp);
     //    fprintf(ERRSTREAM, "\n");
 #endif
-    if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
+    if(member_xxn_index(&lidx, i, &pos)){
 #if DEBUGBUILDMATRIX > 0
       fprintf(ERRSTREAM, " => remains in monomial basis\n");
 #endif
@@ -3394,7 +3475,7 @@ static inline sp_matfglm_t * build_matrixn_from_bs_trace(int32_t **bdiv_xn,
         copy_poly_in_matrix_from_bs(matrix, nrows, bs, ht,
                                     div_xn[count], len_gb_xn[count],
                                     start_cf_gb_xn[count], len_gb_xn[count], lmb,
-                                    nv, fc);
+                                    &lidx, nv, fc);
         nrows++;
         count++;
 
@@ -3402,6 +3483,7 @@ static inline sp_matfglm_t * build_matrixn_from_bs_trace(int32_t **bdiv_xn,
           if(info_level){
             fprintf(VERBSTREAM, "Staircase is not generic (1 => explain better)\n");
           }
+          lmb_index_clear(&lidx);
           return NULL;
         }
       }
@@ -3412,6 +3494,7 @@ static inline sp_matfglm_t * build_matrixn_from_bs_trace(int32_t **bdiv_xn,
           display_monomial_full(VERBSTREAM, nv, NULL, 0, exp);
           fprintf(VERBSTREAM, " gets outside the staircase\n");
         }
+        lmb_index_clear(&lidx);
         return NULL;
       }
     }
@@ -3428,6 +3511,7 @@ static inline sp_matfglm_t * build_matrixn_from_bs_trace(int32_t **bdiv_xn,
     }
   }
 
+  lmb_index_clear(&lidx);
   return matrix;
 }
 
@@ -3448,6 +3532,9 @@ static inline sp_matfglm_t * build_matrixn_unstable_from_bs_trace(int32_t **bdiv
 								  const int32_t unstable_staircase,
 								  const int info_level,
                                   files_gb* files){
+  lmb_index_t lidx;
+  lmb_index_init(&lidx, lmb, dquot, nv, ht);
+
   double st_fglm = realtime();
   double cst_fglm = cputime();
   *bdiv_xn = calloc((unsigned long)bs->lml, sizeof(int32_t));
@@ -3503,7 +3590,7 @@ static inline sp_matfglm_t * build_matrixn_unstable_from_bs_trace(int32_t **bdiv
   for (long i = 0; i < dquot; i++) {
     long pos = -1;
     int32_t *exp = lmb + (i * nv);
-    if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
+    if(member_xxn_index(&lidx, i, &pos)){
 #if DEBUGBUILDMATRIX>0
       display_monomial_full(ERRSTREAM, nv, NULL, 0, exp);
       fprintf(ERRSTREAM, " => remains in monomial basis\n");
@@ -3572,6 +3659,7 @@ static inline sp_matfglm_t * build_matrixn_unstable_from_bs_trace(int32_t **bdiv
       fprintf(VERBSTREAM, "Staircase is not generic\n");
       fprintf(VERBSTREAM, "and too many normal forms need to be computed\n");
     }
+    lmb_index_clear(&lidx);
     return NULL;
   }
 
@@ -3607,7 +3695,7 @@ static inline sp_matfglm_t * build_matrixn_unstable_from_bs_trace(int32_t **bdiv
     exps_extra_nf[i*nv+nv-1]=lmb[j*nv+nv-1]+1;
     cfs_extra_nf[i]=1;
   }
-  bs_t *tbr;
+  bs_t *tbr = NULL;
   if (count_not_lm) {
     md_t *md = copy_meta_data(st,fc);
     tbr = initialize_basis(md, ht);
@@ -3691,8 +3779,8 @@ static inline sp_matfglm_t * build_matrixn_unstable_from_bs_trace(int32_t **bdiv
   long count = 0;
   long count_nf = 0;
 
-  long nzcfs_freepart = 0;
-  long nzcfs_nonfreepart = 0;
+  /* source of each dense row, see fill_matrix_rows_from_bs */
+  long *row_src = malloc(sizeof(long) * (len0 + 1));
 
   for(long i = 0; i < dquot; i++){
     long pos = -1;
@@ -3701,7 +3789,7 @@ static inline sp_matfglm_t * build_matrixn_unstable_from_bs_trace(int32_t **bdiv
     display_monomial_full(ERRSTREAM, nv, NULL, 0, exp);
     //    fprintf(ERRSTREAM, "\n");
 #endif
-    if(member_xxn(exp, lmb + (i * nv), dquot - i, &pos, nv)){
+    if(member_xxn_index(&lidx, i, &pos)){
 #if DEBUGBUILDMATRIX > 0
       fprintf(ERRSTREAM, " => remains in monomial basis\n");
 #endif
@@ -3721,15 +3809,7 @@ static inline sp_matfglm_t * build_matrixn_unstable_from_bs_trace(int32_t **bdiv
 #if DEBUGBUILDMATRIX > 0
 	fprintf(ERRSTREAM, " => lands on a leading monomial\n");
 #endif
-        copy_poly_in_matrix_from_bs(matrix, nrows, bs, ht, //bcf, bexp, blen,
-                                    div_xn[count], len_gb_xn[count],
-                                    start_cf_gb_xn[count], len_gb_xn[count], lmb,
-                                    nv, fc);
-	for (long j = 0; j < dquot; j++) {
-	  if (matrix->dense_mat[nrows*matrix->ncols + j] != 0) {
-	    nzcfs_freepart++;
-	  }
-	}
+        row_src[nrows] = count;
         nrows++;
         count++;
         if(len_xn < count && i < dquot){
@@ -3737,6 +3817,8 @@ static inline sp_matfglm_t * build_matrixn_unstable_from_bs_trace(int32_t **bdiv
 	    fprintf(VERBSTREAM, "Staircase is not generic (1 => explain better)\n");
 	  }
 	  free(evi);
+          free(row_src);
+          lmb_index_clear(&lidx);
           return NULL;
         }
       }
@@ -3744,13 +3826,7 @@ static inline sp_matfglm_t * build_matrixn_unstable_from_bs_trace(int32_t **bdiv
 #if DEBUGBUILDMATRIX > 0
 	fprintf(ERRSTREAM, " => lands on a MULTIPLE of a leading monomial\n");
 #endif
-	copy_nf_in_matrix_from_bs(matrix, nrows, count_nf, lmb,
-				  tbr, ht, evi, st, nv);
-	for (long j = 0; j < dquot; j++) {
-	  if (matrix->dense_mat[nrows*matrix->ncols + j] != 0) {
-	    nzcfs_nonfreepart++;
-	  }
-	}
+	row_src[nrows] = -count_nf - 1;
 	nrows++;
 	count_nf++;
         if(count_not_lm < count_nf && i < dquot){
@@ -3758,6 +3834,8 @@ static inline sp_matfglm_t * build_matrixn_unstable_from_bs_trace(int32_t **bdiv
 	    fprintf(VERBSTREAM, "Staircase is not generic (1 => explain better)\n");
 	  }
 	  free(evi);
+          free(row_src);
+          lmb_index_clear(&lidx);
           return NULL;
         }
       }
@@ -3767,20 +3845,19 @@ static inline sp_matfglm_t * build_matrixn_unstable_from_bs_trace(int32_t **bdiv
 	display_monomial_full(ERRSTREAM, nv, NULL, 0, exp);
 	fprintf(ERRSTREAM, " gets outside the staircase\n");
 	free(evi);
+        free(row_src);
+        lmb_index_clear(&lidx);
         return NULL;
       }
     }
   }
-  for(long i = 0; i < matrix->nrows; i++){
-    for(long j = matrix->ncols - 1; j >= 0; j--){
-      if(matrix->dense_mat[i*matrix->ncols + j] == 0){
-        matrix->dst[i]++;
-      }
-      else{
-        break;
-      }
-    }
-  }
+  long nzcfs[2];
+  fill_matrix_rows_from_bs(matrix, row_src, nrows, div_xn, len_gb_xn,
+                           start_cf_gb_xn, bs, ht, tbr, evi, lmb, &lidx,
+                           st, nv, fc, nzcfs);
+  free(row_src);
+  const long nzcfs_freepart = nzcfs[0];
+  const long nzcfs_nonfreepart = nzcfs[1];
   if (count_not_lm) {
     matrix->nonfreepartdensity = ((double)nzcfs_nonfreepart) / ((double)dquot * count_not_lm);
     free_basis_without_hash_table(&tbr);
@@ -3796,6 +3873,7 @@ static inline sp_matfglm_t * build_matrixn_unstable_from_bs_trace(int32_t **bdiv
     fprintf (VERBSTREAM,"%15.2f | %-13.2f\n",rt_fglm,crt_fglm);
   }
   free(evi);
+  lmb_index_clear(&lidx);
   return matrix;
 }
 
@@ -330,6 +330,116 @@ static void print_msolve_polynomials_ff(
     free(evi);
 }
 
+/* prints the Hilbert series of R/L where L is generated by the nm monomials
+ * lm in nv variables as [dim, deg, [h_0, ..., h_k]] where dim is the Krull
+ * dimension of R/L, h(t) = h_0 + ... + h_k t^k is the numerator of the
+ * series h(t)/(1-t)^dim and deg = h(1) is the degree of L. For L = R we
+ * print [-1, 0, [0]]. */
+static void print_hilbert_series_data(
+        FILE *file,
+        const int32_t *lm,
+        const len_t nm,
+        const len_t nv
+        )
+{
+    len_t i;
+    deg_t d = 0;
+
+    /* the coefficients are computed modulo 2^64, read them as signed
+     * integers */
+    int64_t *h  = (int64_t *)hilbert_series_numerator_of_monomials(
+            lm, nm, nv, &d);
+    while (d > 0 && h[d] == 0) {
+        --d;
+    }
+
+    int32_t dim = nv;
+    int64_t deg = 0;
+    if (d == 0 && h[0] == 0) {
+        dim = -1;
+    } else {
+        for (i = 0; i <= d; ++i) {
+            deg +=  h[i];
+        }
+        /* h(1) = 0, divide by (1-t) */
+        while (deg == 0 && dim > 0) {
+            for (i = 1; i < d; ++i) {
+                h[i]  +=  h[i-1];
+            }
+            --d;
+            --dim;
+            for (i = 0; i <= d; ++i) {
+                deg +=  h[i];
+            }
+        }
+    }
+    fprintf(file, "[%d, %ld, [", dim, (long)deg);
+    for (i = 0; i < d; ++i) {
+        fprintf(file, "%ld, ", (long)h[i]);
+    }
+    fprintf(file, "%ld]]:\n", (long)h[d]);
+    free(h);
+}
+
+/* Hilbert series of the leading ideal of bs, for elimination orders only
+ * the elements of the elimination ideal are taken into account */
+static void print_msolve_hilbert_series_ff(
+        FILE *file,
+        const bs_t * const bs,
+        const ht_t * const ht,
+        const md_t *st,
+        char **vnames
+        )
+{
+    len_t i, j, k;
+
+    const len_t nev = st->nev;
+    const len_t nv  = ht->nv - nev;
+    const len_t ebl = ht->ebl;
+
+    fprintf(file, "#Hilbert series data\n");
+    fprintf(file, "#---\n");
+    fprintf(file, "#field characteristic: %u\n", st->gfc);
+    fprintf(file, "#variable order:       ");
+    for (i = nev; i < ht->nv-1; ++i) {
+        fprintf(file, "%s, ", vnames[i]);
+    }
+    fprintf(file, "%s\n", vnames[ht->nv-1]);
+    fprintf(file, "#monomial order:       graded reverse lexicographical\n");
+    if (nev == 1) {
+        fprintf(file, "#leading ideal of:     elimination ideal of first variable\n");
+    } else {
+        if (nev > 1) {
+            fprintf(file, "#leading ideal of:     elimination ideal of first %d variables\n", nev);
+        }
+    }
+    fprintf(file, "#Hilbert series:       h(t)/(1-t)^dim, printed as [dim, degree, [coefficients of h]]\n");
+    fprintf(file, "#---\n");
+
+    /* exponents of the non-eliminated variables */
+    const len_t off = ebl == 0 ? 1 : ebl + 1;
+
+    int32_t *lm = (int32_t *)malloc(
+            ((unsigned long)bs->lml + 1) * nv * sizeof(int32_t));
+    for (i = 0, j = 0; i < bs->lml; ++i) {
+        const hm_t * const hm = bs->hm[bs->lmps[i]];
+        if (hm == NULL) {
+            continue;
+        }
+        const exp_t * const ev = ht->ev[hm[OFFSET]];
+        /* first block degree */
+        if (nev > 0 && ev[0] != 0) {
+            continue;
+        }
+        for (k = 0; k < nv; ++k) {
+            lm[(unsigned long)j * nv + k] = ev[off + k];
+        }
+        ++j;
+    }
+    print_hilbert_series_data(file, lm, j, nv);
+    free(lm);
+}
+
 static void print_ff_nf_data(
         const char *fn,
         const char *mode,
@@ -364,6 +474,18 @@ static void print_ff_basis_data(
         const data_gens_ff_t *gens,
         const int32_t print_gb)
 {
+    if (print_gb == 3) {
+        if(fn != NULL){
+            FILE *ofile = fopen(fn, mode);
+            print_msolve_hilbert_series_ff(ofile, bs, ht, st, gens->vnames);
+            fclose(ofile);
+        }
+        else{
+            print_msolve_hilbert_series_ff(OUTSTREAM, bs, ht, st,
+                    gens->vnames);
+        }
+        return;
+    }
     if (print_gb > 0) {
         if(fn != NULL){
             FILE *ofile = fopen(fn, mode);
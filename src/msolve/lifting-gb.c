@@ -1360,7 +1360,8 @@ restart:
                                                  0,
                                                  maxbitsize,
                                                  &success);
-    if(is_empty == 1 || print_gb == 1 || (*modgbsp)->ld == 0){
+    /* leading ideal and Hilbert series only need the first prime */
+    if(is_empty == 1 || print_gb == 1 || print_gb == 3 || (*modgbsp)->ld == 0){
       if(dlinit){
         data_lift_clear(dlift);
       }
@@ -1430,35 +1431,38 @@ restart:
     if(info_level){
         fprintf(VERBSTREAM, "New prime = %d\n", prime);
     }
+    /* stream of primes filtered in batches against the input coefficients */
+    prime_stream_t ps[1];
+    prime_stream_init(ps, prime, 1<<30, lprime, st->nthrds);
+    if(fc == 0){
+      mpz_t prod;
+      mpz_init(prod);
+      lucky_primes_product_of_input(prod, bs);
+      prime_stream_mul_product(ps, prod);
+      mpz_clear(prod);
+    }
+
     while(apply){
 
-      prime = next_prime(prime);
-      if(prime >= lprime){
-        prime = next_prime(1<<30);
-      }
       /* generate lucky prime numbers */
-      msd->lp->p[0] = prime;
-      while(is_lucky_prime_ui(prime, bs) || prime==primeinit){
-        prime = next_prime(prime);
-        if(prime >= lprime){
-          prime = next_prime(1<<30);
-        }
-        msd->lp->p[0] = prime;
-      }
       int nthrds = 1; /* mono-threaded mult-mid comp */
-      for(len_t i = 1; i < nthrds/* st->nthrds */; i++){
-        prime = next_prime(prime);
-        if(prime >= lprime){
-          prime = next_prime(1<<30);
-        }
+      for(len_t i = 0; i < nthrds/* st->nthrds */; i++){
+        do{
+          prime = prime_stream_next(ps);
+        } while(prime != 0 && prime==primeinit);
         msd->lp->p[i] = prime;
-        while(is_lucky_prime_ui(prime, bs) || prime==primeinit){
-          prime = next_prime(prime);
-          if(prime >= lprime){
-            prime = next_prime(1<<30);
-          }
-          msd->lp->p[i] = prime;
+      }
+      if(prime == 0){
+        fprintf(ERRSTREAM, "All primes have been used, no further prime available\n");
+        if(dlinit){
+          data_lift_clear(dlift);
         }
+        free_rrec_data(recdata1);
+        free_rrec_data(recdata2);
+        st->info_level = info_level;
+        prime_stream_clear(ps);
+        *errp = 2;
+        return modgbsp;
       }
       prime = msd->lp->p[nthrds /* st->nthrds */ - 1];
 
@@ -1551,6 +1555,7 @@ restart:
         free_rrec_data(recdata2);
         /* reset info_level to previous setting */
         st->info_level = info_level;
+        prime_stream_clear(ps);
         /* return core_groebner_qq(modgbsp, bs, msd, st, errp, fc, print_gb); */
         goto restart;
 
@@ -1596,6 +1601,7 @@ restart:
       /* this is where learn could be reset to 1 */
       /* but then duplicated datas and others should be free-ed */
     }
+    prime_stream_clear(ps);
     if (info_level){
       fprintf(VERBSTREAM, " \n-------------------------------------------------\
 -----------------------------------------------------\n");
@@ -1831,6 +1837,8 @@ void print_msolve_gbtrace_qq(data_gens_ff_t *gens,
   }
   if (flags->print_gb == 1) {
     fprintf(ofile, "#Leading ideal data\n");
+  } else if (flags->print_gb == 3) {
+    fprintf(ofile, "#Hilbert series data\n");
   } else {
     if (flags->print_gb > 1) {
       if(flags->truncate_lifting>0){
@@ -1849,7 +1857,9 @@ void print_msolve_gbtrace_qq(data_gens_ff_t *gens,
   }
   fprintf(ofile, "%s\n", gens->vnames[gens->nvars-1]);
   fprintf(ofile, "#monomial order:       graded reverse lexicographical\n");
-  if ((*modgbsp)->ld == 1) {
+  if (flags->print_gb == 3) {
+    fprintf(ofile, "#Hilbert series:       h(t)/(1-t)^dim, printed as [dim, degree, [coefficients of h]]\n");
+  } else if ((*modgbsp)->ld == 1) {
     fprintf(ofile, "#length of basis:      1 element\n");
   } else {
     fprintf(ofile, "#length of basis:      %u elements sorted by increasing leading monomials\n", (*modgbsp)->ld);
@@ -1859,7 +1869,7 @@ void print_msolve_gbtrace_qq(data_gens_ff_t *gens,
     fclose(ofile);
   }
 
-  if(flags->print_gb > 1){
+  if(flags->print_gb == 2){
 
     if(flags->files->out_file != NULL){
       FILE *ofile = fopen(flags->files->out_file, "ab+");
@@ -1880,6 +1890,18 @@ void print_msolve_gbtrace_qq(data_gens_ff_t *gens,
       display_lm_gbmodpoly_cf_qq(OUTSTREAM, (*modgbsp), gens);
     }
   }
+  if(flags->print_gb == 3){
+    if(flags->files->out_file != NULL){
+      FILE *ofile = fopen(flags->files->out_file, "ab+");
+      print_hilbert_series_data(ofile, (*modgbsp)->ldm, (*modgbsp)->ld,
+                                (*modgbsp)->nv);
+      fclose(ofile);
+    }
+    else{
+      print_hilbert_series_data(OUTSTREAM, (*modgbsp)->ldm, (*modgbsp)->ld,
+                                (*modgbsp)->nv);
+    }
+  }
   gb_modpoly_clear((*modgbsp));
   free(modgbsp);
 }
@@ -299,7 +299,7 @@ static inline void trace_det_initset(trace_det_fglm_mat_t trace_det,
       trace_det->matmul_indices[i] = 0;
       uint64_t tmp = i*((*mod_mat)->ncols);
       for(uint32_t j = 0; j < (*mod_mat)->ncols; j++){
-          if((*mod_mat)->dense_mat[tmp+j] != 0){
+          if(sp_matfglm_entry(*mod_mat, tmp+j) != 0){
               trace_det->matmul_indices[i] = tmp + j;
               break;
           }
@@ -307,7 +307,7 @@ static inline void trace_det_initset(trace_det_fglm_mat_t trace_det,
   }
   trace_det->matmul_wcrt = (mpz_t *)malloc(nrows * sizeof(mpz_t));
   for(uint32_t i = 0; i < nrows; i++){
-      mpz_init_set_ui(trace_det->matmul_wcrt[i], (*mod_mat)->dense_mat[trace_det->matmul_indices[i]]);
+      mpz_init_set_ui(trace_det->matmul_wcrt[i], sp_matfglm_entry(*mod_mat, trace_det->matmul_indices[i]));
   }
   trace_det->matmul_wqq = (mpz_t *)malloc(2 * nrows * sizeof(mpz_t));
   for(uint32_t i = 0; i < 2 * nrows; i++){
@@ -443,7 +443,7 @@ static inline void crt_lift_trace_det(trace_det_fglm_mat_t trace_det,
 
   for(uint32_t i = trace_det->w_checked; i < mod_mat->nrows; i++){
       mpz_CRT_ui(trace_det->matmul_wcrt[i], trace_det->matmul_wcrt[i], modulus,
-                 mod_mat->dense_mat[trace_det->matmul_indices[i]], prime, prod,
+                 sp_matfglm_entry(mod_mat, trace_det->matmul_indices[i]), prime, prod,
                  trace_det->tmp, 0);
   }
 }
@@ -524,14 +524,27 @@ static inline int old_rat_recon_trace_det(trace_det_fglm_mat_t trace_det,
   return 1;
 }
 
+/* the denominators found so far are multiplied into the remaining
+ * coefficients, so that these usually reconstruct as integers */
 static inline int rat_recon_array(mpz_t *res, mpz_t *crt, int32_t sz,
                                   mpz_t modulus, rrec_data_t rdata) {
+  int b = 1;
+  mpz_t gden, gcd;
+  mpz_init_set_ui(gden, 1);
+  mpz_init(gcd);
   for (int i = 0; i < sz; i++) {
-    int b = ratrecon(res[2 * i], res[2 * i + 1], crt[i], modulus, rdata);
+    b = ratreconwden(res[2 * i], res[2 * i + 1], crt[i], modulus, gden, rdata);
     if (b == 0)
-      return 0;
+      break;
+    mpz_mul(gden, gden, res[2 * i + 1]);
+    mpz_set(res[2 * i + 1], gden);
+    mpz_gcd(gcd, res[2 * i], res[2 * i + 1]);
+    mpz_divexact(res[2 * i], res[2 * i], gcd);
+    mpz_divexact(res[2 * i + 1], res[2 * i + 1], gcd);
   }
-  return 1;
+  mpz_clear(gcd);
+  mpz_clear(gden);
+  return b;
 }
 
 static inline int rat_recon_trace_det(trace_det_fglm_mat_t trace_det,
@@ -1002,6 +1015,7 @@ void initialize_rrec_data(rrec_data_t recdata) {
   mpz_set_ui(recdata->N2, 0);
   mpz_init(recdata->D2);
   mpz_set_ui(recdata->D2, 0);
+  recdata->hgcd_min = ratrecon_hgcd_min();
 }
 
 void free_rrec_data(rrec_data_t recdata) {
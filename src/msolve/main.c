@@ -107,6 +107,11 @@ static inline void display_help(char *str){
   display_option_help_noopt("0 - Nothing is printed. (default)\n");
   display_option_help_noopt("1 - Leading ideal is printed.\n");
   display_option_help_noopt("2 - Full reduced Groebner basis is printed.\n");
+  display_option_help_noopt("3 - Hilbert series, dimension and degree of the\n");
+  display_option_help_noopt("    leading ideal are printed, no solving is done.\n");
+  display_option_help(0, "block-wiedemann", "BWD", "Minimal dimension of the quotient from which\n");
+  display_option_help_noopt("parametrizations are computed with block\n");
+  display_option_help_noopt("Wiedemann sequences, 1024 (default).\n");
   display_option_help('c',"", "GEN", "Handling genericity: If the staircase is not generic\n");
   display_option_help_noopt("enough, msolve can automatically try to fix this\n");
   display_option_help_noopt("situation via first trying a change of the order of\n");
@@ -116,6 +121,11 @@ static inline void display_help(char *str){
   display_option_help_noopt("1 - Change order of variables.\n");
   display_option_help_noopt("2 - Change order of variables, then try adding a\n");
   display_option_help_noopt("    random linear form. (default)\n");
+  display_option_help(0, "checkpoint", "FILE", "Periodically saves the state of the multi-modular\n");
+  display_option_help_noopt("computation over the rationals to FILE.\n");
+  display_option_help_noopt("Not available when lifting multiplication matrices.\n");
+  display_option_help(0, "checkpoint-period", "SEC", "Minimal time in seconds between two saves\n");
+  display_option_help_noopt("of the state given by --checkpoint, 600 (default).\n");
   display_option_help('d', "", "GEN", "Handling genericity further: If the staircase is not generic\n");
   display_option_help_noopt("enough, msolve can still try to perform the full computation\n");
   display_option_help_noopt("by computing some normal forms and build the multiplication matrix,\n");
@@ -143,8 +153,10 @@ static inline void display_help(char *str){
   display_option_help('l', "linear-algebra", "LIN", "Linear algebra variant to be applied:\n");
   display_option_help_noopt(" 1 - exact sparse / dense\n");
   display_option_help_noopt(" 2 - exact sparse (default)\n");
+  display_option_help_noopt(" 3 - automatic choice of 1 or 2 for each matrix\n");
   display_option_help_noopt("42 - sparse / dense linearization (probabilistic)\n");
   display_option_help_noopt("44 - sparse linearization (probabilistic)\n");
+  display_option_help_noopt("45 - automatic choice of 1, 2, 42 or 44 for each matrix\n");
   display_option_help('m', "", "MPR", "Maximal number of pairs used per matrix.\n");
   display_option_help_noopt("0 - unlimited (default).\n");
   display_option_help('n', "normal-form", "NF", "Given n input generators compute normal form of the last NF\n");
@@ -176,6 +188,9 @@ static inline void display_help(char *str){
   display_option_help('r', "reduce-gb", "RED", "Reduce Groebner basis.\n");
   display_option_help_noopt("0 - no.\n");
   display_option_help_noopt("1 - yes (default).\n");
+  display_option_help(0, "resume", "", "Continues the computation from the state saved in\n");
+  display_option_help_noopt("the file given by --checkpoint. The input system and\n");
+  display_option_help_noopt("options, including the random seed, must be the same.\n");
   /* display_option_help('R', "", "REF", "Refinement fo real roots.\n"); */
   /* display_option_help_noopt("(not implemented yet).\n"); */
   display_option_help('s', "", "HTS", "Initial hash table size given\n");
@@ -192,6 +207,24 @@ static inline void display_help(char *str){
   display_option_help_noopt("hash table is newly generated.\n");
   display_option_help_noopt("0 - no update (default).\n");
   display_option_help('V', "version", "", "Prints msolve's version\n");
+  display_option_help(0, "learning-primes", "LRN", "Number of primes on which the learning phase\n");
+  display_option_help_noopt("is run concurrently over the rationals, the\n");
+  display_option_help_noopt("threads are split among them. The trace of\n");
+  display_option_help_noopt("the first run to finish is kept once a second\n");
+  display_option_help_noopt("run confirms its leading ideal, the other runs\n");
+  display_option_help_noopt("are cancelled. On a mismatch the learning is\n");
+  display_option_help_noopt("restarted on new primes.\n");
+  display_option_help_noopt("1 - learn on one prime (default).\n");
+  display_option_help(0, "workers", "WRK", "Number of worker processes computing modular\n");
+  display_option_help_noopt("images over the rationals, each worker uses one\n");
+  display_option_help_noopt("thread. Not available when lifting multiplication\n");
+  display_option_help_noopt("matrices.\n");
+  display_option_help_noopt("0 - no worker processes (default).\n");
+  display_option_help(0, "hilbert-driven", "", "For homogeneous input over the rationals,\n");
+  display_option_help_noopt("prune pairs of degrees in which the Hilbert\n");
+  display_option_help_noopt("function learned on the first prime is met,\n");
+  display_option_help_noopt("once a second prime has confirmed it. Needs\n");
+  display_option_help_noopt("a linear algebra option >= 40, off by default.\n");
 }
 
 static void getoptions(
@@ -228,6 +261,13 @@ static void getoptions(
   char *bin_filename = NULL;
   char *out_fname = NULL;
   char *bin_out_fname = NULL;
+  char *checkpoint_fname = NULL;
+  int32_t checkpoint_period = CHECKPOINT_PERIOD;
+  int resume = 0;
+  int32_t nworkers = 0;
+  int32_t nlearn = 1;
+  int32_t bw_min_dim = BLOCKWIED_MIN_DIM;
+  int32_t hilbert_driven = 0;
   opterr = 1;
   char short_options[] = "c:Cd:e:f:F:g:hiI:l:L:m:M:n:N:o:O:p:P:q:r:R:s:St:u:v:V";
 
@@ -236,16 +276,28 @@ static void getoptions(
      see https://cgit.git.savannah.gnu.org/cgit/coreutils.git/tree/src/ls.c */
   enum {
     RANDOM_SEED_OPTION = CHAR_MAX + 1,
+    CHECKPOINT_OPTION,
+    CHECKPOINT_PERIOD_OPTION,
+    RESUME_OPTION,
+    WORKERS_OPTION,
+    LEARNING_PRIMES_OPTION,
+    BLOCK_WIEDEMANN_OPTION,
+    HILBERT_DRIVEN_OPTION,
     /* Below is the template for the next long option with
      * no equivalent short option */
     /* NEXT_OPTION */
   };
   struct option long_options[] = {
+    {"block-wiedemann", required_argument, NULL, BLOCK_WIEDEMANN_OPTION},
+    {"checkpoint", required_argument, NULL, CHECKPOINT_OPTION},
+    {"checkpoint-period", required_argument, NULL, CHECKPOINT_PERIOD_OPTION},
     {"elimination", required_argument, NULL, 'e'},
     {"file", required_argument, NULL, 'f'},
     {"groebner-basis", required_argument, NULL, 'g'},
     {"help", no_argument, NULL, 'h'},
+    {"hilbert-driven", no_argument, NULL, HILBERT_DRIVEN_OPTION},
     {"isolate", required_argument, NULL, 'I'},
+    {"learning-primes", required_argument, NULL, LEARNING_PRIMES_OPTION},
     {"linear-algebra", required_argument, NULL, 'l'},
     {"lifting-mulmat", required_argument, NULL, 'L'},
     {"normal-form", required_argument, NULL, 'n'},
@@ -254,9 +306,11 @@ static void getoptions(
     {"parametrization", required_argument, NULL, 'P'},
     {"random-seed", required_argument, NULL, RANDOM_SEED_OPTION},
     {"reduce-gb", required_argument, NULL, 'r'},
+    {"resume", no_argument, NULL, RESUME_OPTION},
     {"threads", required_argument, NULL, 't'},
     {"verbose", required_argument, NULL, 'v'},
     {"version", no_argument, NULL, 'V'},
+    {"workers", required_argument, NULL, WORKERS_OPTION},
     /* Below is the template for the next long option with
      * no equivalent short option,
      * adapt the 2nd field accordingly */
@@ -373,8 +427,8 @@ static void getoptions(
       if (*print_gb < 0) {
           *print_gb = 0;
       }
-      if (*print_gb > 2) {
-          *print_gb = 2;
+      if (*print_gb > 3) {
+          *print_gb = 3;
       }
       break;
     case 'c':
@@ -410,6 +464,39 @@ static void getoptions(
     case RANDOM_SEED_OPTION:
       *seed = strtoll(optarg, NULL, 10);
       break;
+    case CHECKPOINT_OPTION:
+      checkpoint_fname = optarg;
+      break;
+    case CHECKPOINT_PERIOD_OPTION:
+      checkpoint_period = strtol(optarg, NULL, 10);
+      if (checkpoint_period < 0) {
+          checkpoint_period = 0;
+      }
+      break;
+    case RESUME_OPTION:
+      resume = 1;
+      break;
+    case WORKERS_OPTION:
+      nworkers = strtol(optarg, NULL, 10);
+      if (nworkers < 0) {
+          nworkers = 0;
+      }
+      break;
+    case LEARNING_PRIMES_OPTION:
+      nlearn = strtol(optarg, NULL, 10);
+      if (nlearn < 1) {
+          nlearn = 1;
+      }
+      break;
+    case BLOCK_WIEDEMANN_OPTION:
+      bw_min_dim = strtol(optarg, NULL, 10);
+      if (bw_min_dim < 1) {
+          bw_min_dim = 1;
+      }
+      break;
+    case HILBERT_DRIVEN_OPTION:
+      hilbert_driven = 1;
+      break;
     /* Below is the template for the next long option with
      * no equivalent short option */
     /* case NEXT_OPTION: */
@@ -424,6 +511,10 @@ static void getoptions(
     display_help(argv[0]);
     exit(1);
   }
+  if(resume && checkpoint_fname == NULL){
+    fprintf(ERRSTREAM,"--resume requires a checkpoint file (--checkpoint)\n");
+    errflag++;
+  }
   if(errflag){
     fprintf(ERRSTREAM, "Invalid usage\n");
     display_help(argv[0]);
@@ -433,6 +524,13 @@ static void getoptions(
   files->bin_file = bin_filename;
   files->out_file = out_fname;
   files->bin_out_file = bin_out_fname;
+  files->checkpoint_file = checkpoint_fname;
+  files->checkpoint_period = checkpoint_period;
+  files->resume = resume;
+  files->nworkers = nworkers;
+  files->nlearn = nlearn;
+  files->bw_min_dim = bw_min_dim;
+  files->hilbert_driven = hilbert_driven;
 }
 
 
@@ -477,6 +575,13 @@ int main(int argc, char **argv){
     files->bin_file = NULL;
     files->out_file = NULL;
     files->bin_out_file = NULL;
+    files->checkpoint_file = NULL;
+    files->checkpoint_period = CHECKPOINT_PERIOD;
+    files->resume = 0;
+    files->nworkers = 0;
+    files->nlearn = 1;
+    files->bw_min_dim = BLOCKWIED_MIN_DIM;
+    files->hilbert_driven = 0;
     getoptions(argc, argv, &initial_hts, &nr_threads, &max_pairs,
                &elim_block_len, &la_option, &use_signatures, &update_ht,
                &reduce_gb, &print_gb, &truncate_lifting, &genericity_handling,
@@ -547,7 +652,7 @@ int main(int argc, char **argv){
     gens->random_linear_form = malloc(sizeof(int32_t)*(nr_vars));
     gens->elim = elim_block_len;
 
-    if(0 < field_char && field_char < pow(2, 15) && la_option > 2){
+    if(0 < field_char && field_char < pow(2, 15) && (la_option == 42 || la_option == 44)){
         if(info_level){
             fprintf(ERRSTREAM, "Warning: characteristic is too low for choosing \nprobabilistic linear algebra\n");
             fprintf(ERRSTREAM, "\t linear algebra option set to 2\n");
@@ -51,6 +51,14 @@ typedef int32_t nvars_t;
 typedef int64_t bits_t;
 
 
+/* last leading ideal given to monomial_basis and its staircase */
+typedef struct{
+  long length;
+  long nvars;
+  int32_t *bexp_lm;
+  int32_t *basis;
+  long dquot;
+} staircase_cache_t;
 
 typedef struct{
   nvars_t nvars;
@@ -76,6 +84,10 @@ typedef struct{
   int32_t *exps;
   int32_t *cfs;    /* int32_t coeffs */
   mpz_t **mpz_cfs; /* mpz_t coeffs */
+  /* staircase of the last run, it is reused when the next run on this
+   * system, e.g. with another random linear form, has the same leading
+   * ideal */
+  staircase_cache_t staircase;
 } data_gens_ff_t;
 
 typedef uint32_t szmat_t;
@@ -118,11 +130,23 @@ typedef struct{
   szmat_t *dense_idx; //position des lignes non triviales (qui constituent donc
                       //dense_mat)
   szmat_t *dst; //pour la gestion des lignes "denses" mais avec un bloc de zero a la fin
+  /* stockage compresse (utilise a la place de dense_mat si cmp_off != NULL) */
+  CF_t *cmp_data; //lignes compressees mises bout a bout
+  uint64_t *cmp_off; //debut de chaque ligne dans cmp_data
+  szmat_t *cmp_nnz; //SP_MATFGLM_PACKED ou nombre d'entrees non nulles (CSR)
+  uint64_t cmp_len; //longueur utilisee de cmp_data
+  uint64_t cmp_alloc; //longueur allouee de cmp_data
+  CF_t *cmp_buf; //ligne dense de travail (ncols entrees nulles)
   double totaldensity;
   double freepartdensity;
   double nonfreepartdensity;
 } sp_matfglm_t;
 
+/* row class of a compressed sp_matfglm_t: the ncols - dst[i] first entries
+ * of a packed row are stored as they are, a sparse row stores its nnz column
+ * indices followed by its nnz values */
+#define SP_MATFGLM_PACKED UINT32_MAX
+
 #ifndef ALIGNED32
 #define ALIGNED32 __attribute__((aligned(32)))
 #endif
@@ -188,10 +212,49 @@ typedef struct{
   mpz_t D1;
   mpz_t N2;
   mpz_t D2;
+  size_t hgcd_min; /* moduli of at least that many bits use half-gcd */
 } rrec_data_struct_t;
 
 typedef rrec_data_struct_t rrec_data_t[1];
 
+/* images of a parametrization modulo a batch of primes which are combined
+ * via a subproduct tree before being merged into the lifted one */
+typedef struct{
+  mp_limb_t *primes; /* primes of the current batch */
+  uint32_t *res;     /* images, ncf consecutive coefficients per prime */
+  int32_t np;        /* number of primes in the batch */
+  int32_t alloc;     /* maximal number of primes in a batch */
+  int64_t ncf;       /* number of coefficients of the parametrization */
+  uint8_t *stable;   /* per coefficient: set once it was reconstructed
+                      * and verified modulo a further prime, then frozen */
+  mpz_t mod;         /* modulus of the lifted parametrization */
+} crt_batch_struct_t;
+
+typedef crt_batch_struct_t crt_batch_t[1];
+
+/* header of a checkpoint of the multi-modular computation of a
+ * parametrization, followed by the primes dividing the modulus, the
+ * modulus, the CRT accumulators of the parametrization, trace, determinant
+ * and witness coefficients and the state of the rational reconstruction,
+ * see write_checkpoint */
+typedef struct{
+  uint64_t magic;
+  uint64_t input;      /* digest of the input system */
+  uint32_t primeinit;  /* prime used for learning */
+  uint32_t last_prime; /* last prime taken from the prime stream */
+  int32_t nprimes;     /* number of primes used so far */
+  int32_t nmod;        /* number of primes dividing the modulus */
+  int32_t nbdoit;      /* number of primes between two reconstructions */
+  int32_t rerun;       /* parametrization not yet reconstructed */
+  int64_t nbadprimes;  /* number of bad primes so far */
+  int64_t rrec_bits;   /* predicted bit size of the modulus needed */
+  int64_t maxrec;
+  int32_t nvars;
+  uint32_t nrows;      /* number of witness coefficients */
+  int64_t nsols;
+  int64_t ncf;         /* number of coefficients of the parametrization */
+} checkpoint_header_t;
+
 
 typedef struct{
   deg_t length;
@@ -325,12 +388,26 @@ typedef struct{
 } real_point_struct;
 typedef real_point_struct real_point_t[1];
 
+/* default minimal time in seconds between two checkpoints */
+#define CHECKPOINT_PERIOD 600
+
+/* default minimal dimension of the quotient from which block Wiedemann
+ * sequences are used in FGLM */
+#define BLOCKWIED_MIN_DIM 1024
+
 typedef struct{
   char *in_file;
   char *bin_file;
   char *out_file;
   char *bin_out_file;
   char *verb_file;
+  char *checkpoint_file; /* state of the multi-modular loop is saved here */
+  int32_t checkpoint_period; /* minimal time in seconds between two saves */
+  int resume; /* continue from the state saved in checkpoint_file */
+  int32_t nworkers; /* number of worker processes for multi-modular steps */
+  int32_t nlearn; /* number of primes raced in the learning phase */
+  int32_t bw_min_dim; /* block Wiedemann is used from this dimension on */
+  int32_t hilbert_driven; /* prune pairs via the learned Hilbert function */
 } files_gb;
 
 /* data structure for tracing algorithms */
@@ -18,12 +18,15 @@
  * Christian Eder
  * Mohab Safey El Din */
 
+#include <omp.h>
+#include <fcntl.h>
 #include "msolve.h"
 #include "streams.h"
 #include "duplicate.c"
 #include "linear.c"
 #include "lifting.c"
 #include "lifting-gb.c"
+#include "farm.c"
 #include "streams.h"
 
 #ifndef MAX
@@ -301,6 +304,8 @@ data_gens_ff_t *allocate_data_gens() {
   gens->cfs = NULL;
   gens->mpz_cfs = NULL;
   gens->random_linear_form = NULL;
+  gens->staircase.bexp_lm = NULL;
+  gens->staircase.basis = NULL;
 
   gens->elim = 0;
   return gens;
@@ -322,6 +327,7 @@ void free_data_gens(data_gens_ff_t *gens) {
   free(gens->cfs);
   free(gens->exps);
   free(gens->random_linear_form);
+  free_staircase_cache(&(gens->staircase));
   free(gens);
 }
 
@@ -963,31 +969,581 @@ static inline void set_mpz_param_nmod(mpz_param_t mpz_param,
   }
 }
 
-static inline void crt_lift_mpz_upoly(mpz_upoly_t pol, nmod_poly_t nmod_pol,
-                                      mpz_t modulus, int32_t prime, mpz_t prod,
-                                      mpz_t tmp, int nthrds) {
-  len_t i;
-  /* #pragma omp parallel for num_threads(nthrds)    \ */
-  /*   private(i) schedule(static) */
-  for (i = 0; i < pol->length; i++) {
-    mpz_CRT_ui(pol->coeffs[i], pol->coeffs[i], modulus, nmod_pol->coeffs[i],
-               prime, prod, tmp, 0);
-  }
+#define CRT_BATCH_SIZE 64
+
+static inline void crt_batch_init(crt_batch_t cb, mpz_param_t mpz_param,
+                                  mpz_t modulus) {
+  cb->ncf = mpz_param->elim->length;
+  for (len_t i = 0; i < mpz_param->nvars - 1; i++) {
+    cb->ncf += mpz_param->coords[i]->length;
+  }
+  cb->alloc = CRT_BATCH_SIZE;
+  cb->np = 0;
+  cb->primes = (mp_limb_t *)malloc(cb->alloc * sizeof(mp_limb_t));
+  cb->res = (uint32_t *)malloc(cb->alloc * cb->ncf * sizeof(uint32_t));
+  cb->stable = (uint8_t *)calloc(cb->ncf, sizeof(uint8_t));
+  mpz_init_set(cb->mod, modulus);
 }
 
-/* assumes that all degrees are the same */
-static inline void crt_lift_mpz_param(mpz_param_t mpz_param,
-                                      param_t *nmod_param, mpz_t modulus,
-                                      mpz_t prod_crt, const int32_t prime,
-                                      mpz_t tmp, const int nthrds) {
+static inline void crt_batch_clear(crt_batch_t cb) {
+  free(cb->primes);
+  free(cb->res);
+  free(cb->stable);
+  mpz_clear(cb->mod);
+}
 
-  /*assumes prod_crt = modulus * prime */
-  crt_lift_mpz_upoly(mpz_param->elim, nmod_param->elim, modulus, prime,
-                     prod_crt, tmp, nthrds);
+/* stores the image of the parametrization modulo prime */
+static inline void crt_batch_add(crt_batch_t cb, mpz_param_t mpz_param,
+                                 param_t *nmod_param, const int32_t prime) {
+  uint32_t *res = cb->res + cb->np * cb->ncf;
+  for (len_t j = 0; j < mpz_param->elim->length; j++) {
+    *(res++) = nmod_param->elim->coeffs[j];
+  }
   for (len_t i = 0; i < mpz_param->nvars - 1; i++) {
-    crt_lift_mpz_upoly(mpz_param->coords[i], nmod_param->coords[i], modulus,
-                       prime, prod_crt, tmp, nthrds);
+    for (len_t j = 0; j < mpz_param->coords[i]->length; j++) {
+      *(res++) = nmod_param->coords[i]->coeffs[j];
+    }
+  }
+  cb->primes[cb->np++] = prime;
+}
+
+/* merges the images of the batch into the lifted parametrization which is
+ * known modulo cb->mod, afterwards it is known modulo modulus, i.e. cb->mod
+ * times the product P of the primes of the batch: the images are first
+ * combined into one residue modulo P via a subproduct tree, then a single
+ * CRT step with the large moduli cb->mod and P is done per coefficient */
+static void crt_batch_flush(crt_batch_t cb, mpz_param_t mpz_param,
+                                   mpz_t modulus, const int nthrds) {
+  const int32_t np = cb->np;
+  const int64_t ncf = cb->ncf;
+
+  if (np == 0) {
+    return;
+  }
+  mpz_ptr *cf = (mpz_ptr *)malloc(ncf * sizeof(mpz_ptr));
+  int64_t k = 0;
+  for (len_t j = 0; j < mpz_param->elim->length; j++) {
+    cf[k++] = mpz_param->elim->coeffs[j];
+  }
+  for (len_t i = 0; i < mpz_param->nvars - 1; i++) {
+    for (len_t j = 0; j < mpz_param->coords[i]->length; j++) {
+      cf[k++] = mpz_param->coords[i]->coeffs[j];
+    }
+  }
+
+  if (np == 1) {
+    const mp_limb_t prime = cb->primes[0];
+    const mp_limb_t c = n_invmod(mpz_fdiv_ui(cb->mod, prime), prime);
+    const mp_limb_t pinv = n_preinvert_limb(prime);
+#pragma omp parallel for num_threads(nthrds) schedule(dynamic, 64)
+    for (k = 0; k < ncf; k++) {
+      if (cb->stable[k] != 0) {
+        continue;
+      }
+      _mpz_CRT_ui_precomp(cf[k], cf[k], cb->mod, cb->res[k], prime, pinv,
+                          modulus, c, 0);
+    }
+  } else {
+    fmpz_comb_t comb;
+    fmpz_comb_init(comb, cb->primes, np);
+    mpz_t P, minv;
+    mpz_init_set_ui(P, 1);
+    for (int32_t i = 0; i < np; i++) {
+      mpz_mul_ui(P, P, cb->primes[i]);
+    }
+    mpz_init(minv);
+    mpz_invert(minv, cb->mod, P);
+
+#pragma omp parallel num_threads(nthrds)
+    {
+      fmpz_comb_temp_t comb_temp;
+      fmpz_comb_temp_init(comb_temp, comb);
+      mp_limb_t *residues = flint_malloc(np * sizeof(mp_limb_t));
+      fmpz_t y;
+      fmpz_init(y);
+      mpz_t z, w;
+      mpz_init(z);
+      mpz_init(w);
+#pragma omp for schedule(dynamic, 64)
+      for (int64_t l = 0; l < ncf; l++) {
+        if (cb->stable[l] != 0) {
+          continue;
+        }
+        for (int32_t i = 0; i < np; i++) {
+          residues[i] = cb->res[i * ncf + l];
+        }
+        fmpz_multi_CRT_ui(y, residues, comb, comb_temp, 0);
+        fmpz_get_mpz(z, y);
+        /* cf[l] + cb->mod * ((z - cf[l]) / cb->mod mod P) */
+        mpz_mod(w, cf[l], P);
+        mpz_sub(z, z, w);
+        mpz_mul(z, z, minv);
+        mpz_mod(z, z, P);
+        mpz_mod(cf[l], cf[l], cb->mod);
+        mpz_addmul(cf[l], cb->mod, z);
+      }
+      mpz_clear(w);
+      mpz_clear(z);
+      fmpz_clear(y);
+      flint_free(residues);
+      fmpz_comb_temp_clear(comb_temp);
+    }
+    mpz_clear(minv);
+    mpz_clear(P);
+    fmpz_comb_clear(comb);
+  }
+  free(cf);
+  mpz_set(cb->mod, modulus);
+  cb->np = 0;
+}
+
+/* denominator of the k-th polynomial of mpz_param, i.e. the leading
+ * coefficient of the eliminating polynomial for k = 0 resp.
+ * lc(elim) * cfs[k-1] * deg(elim) else */
+static inline void param_poly_den(mpz_t den, mpz_param_t mpz_param,
+                                  const int k) {
+  const deg_t nsols = mpz_param->elim->length - 1;
+  mpz_set(den, mpz_param->elim->coeffs[nsols]);
+  if (k > 0) {
+    mpz_mul(den, den, mpz_param->cfs[k - 1]);
+    mpz_mul_ui(den, den, nsols);
+  }
+}
+
+/* Once a polynomial of the parametrization is reconstructed its
+ * coefficients are verified modulo each new prime. Coefficients surviving
+ * such a check are frozen: they are not lifted by CRT anymore and their
+ * accumulators are released. If a check fails later on, or the polynomial
+ * is marked as not lifted by other checks, the accumulators are recovered
+ * from the reconstructed values which are correct modulo all primes used
+ * so far. The value of the i-th coefficient of the polynomial k is
+ * num[i] / den where num are the coefficients of the polynomial in
+ * mpz_param and den is given by param_poly_den. */
+static inline void crt_batch_check_lifted(crt_batch_t cb,
+                                          mpz_param_t tmp_mpz_param,
+                                          mpz_param_t mpz_param,
+                                          param_t *nmod_param,
+                                          const int32_t prime, int *is_lifted,
+                                          mpz_t modulus, const int nthrds) {
+  const int nc = mpz_param->nvars - 1;
+  int64_t off = 0;
+  mpz_t den, inv;
+  mpz_init(den);
+  mpz_init(inv);
+
+  for (int k = 0; k <= nc; k++) {
+    mpz_upoly_struct *acc = k == 0 ? tmp_mpz_param->elim : tmp_mpz_param->coords[k - 1];
+    mpz_upoly_struct *val = k == 0 ? mpz_param->elim : mpz_param->coords[k - 1];
+    mp_limb_t *img = k == 0 ? nmod_param->elim->coeffs : nmod_param->coords[k - 1]->coeffs;
+    const int64_t len = acc->length;
+    const int frozen = len > 0 && cb->stable[off] != 0;
+    int lifted = is_lifted[0] > 0 && is_lifted[k] > 0 && len <= val->length;
+
+    if (!lifted && !frozen) {
+      off += len;
+      continue;
+    }
+    param_poly_den(den, mpz_param, k);
+    int ok = lifted;
+    if (ok) {
+      const uint32_t dp = mpz_fdiv_ui(den, prime);
+      if (dp == 0) {
+        ok = 0;
+      } else {
+        const uint64_t ip = mod_p_inverse_32(dp, prime);
+        for (int64_t i = 0; i < len; i++) {
+          uint64_t c = mpz_fdiv_ui(val->coeffs[i], prime);
+          if ((c * ip) % prime != img[i] % prime) {
+            ok = 0;
+            break;
+          }
+        }
+      }
+    }
+    if (ok) {
+      if (!frozen) {
+        /* den must stay invertible to recover the accumulators */
+        mpz_gcd(inv, den, cb->mod);
+        if (mpz_cmp_ui(inv, 1) == 0) {
+          for (int64_t i = 0; i < len; i++) {
+            cb->stable[off + i] = 1;
+            mpz_set_ui(acc->coeffs[i], 0);
+            mpz_realloc2(acc->coeffs[i], 64);
+          }
+        }
+      }
+    } else {
+      if (frozen) {
+        /* images of batched primes are needed for all coefficients */
+        crt_batch_flush(cb, tmp_mpz_param, modulus, nthrds);
+        mpz_invert(inv, den, cb->mod);
+        for (int64_t i = 0; i < len; i++) {
+          mpz_mul(acc->coeffs[i], val->coeffs[i], inv);
+          mpz_mod(acc->coeffs[i], acc->coeffs[i], cb->mod);
+          cb->stable[off + i] = 0;
+        }
+      }
+      if (lifted) {
+        is_lifted[k] = 0;
+        if (k == 0) {
+          /* coordinates depend on the eliminating polynomial */
+          for (int j = 1; j <= nc; j++) {
+            is_lifted[j] = 0;
+          }
+        }
+      }
+    }
+    off += len;
+  }
+  mpz_clear(inv);
+  mpz_clear(den);
+}
+
+#define CHECKPOINT_MAGIC 0x324b43564c4f534dULL /* "MSOLVCK2" */
+
+/* digest of the input system, a checkpoint is only used for the system it
+ * was written for */
+static uint64_t input_system_digest(const data_gens_ff_t *gens) {
+  /* 64-bit FNV-1a */
+  uint64_t h = 0xcbf29ce484222325ULL;
+#define DIGEST(x) do { uint64_t _v = (uint64_t)(x);                   \
+    for (int _i = 0; _i < 8; _i++) {                                    \
+      h = (h ^ ((_v >> (8 * _i)) & 0xff)) * 0x100000001b3ULL; } } while (0)
+  DIGEST(gens->nvars);
+  DIGEST(gens->elim);
+  DIGEST(gens->ngens);
+  DIGEST(gens->nterms);
+  DIGEST(gens->field_char);
+  DIGEST(gens->change_var_order);
+  DIGEST(gens->linear_form_base_coef);
+  for (int32_t i = 0; i < gens->ngens; i++) {
+    DIGEST(gens->lens[i]);
+  }
+  for (int64_t i = 0; i < (int64_t)gens->nterms * gens->nvars; i++) {
+    DIGEST(gens->exps[i]);
+  }
+  for (int64_t i = 0; i < 2 * (int64_t)gens->nterms; i++) {
+    const mpz_srcptr c = *(gens->mpz_cfs[i]);
+    DIGEST(mpz_sgn(c));
+    for (size_t j = 0; j < mpz_size(c); j++) {
+      DIGEST(mpz_getlimbn(c, j));
+    }
+  }
+#undef DIGEST
+  return h;
+}
+
+/* Returns the mpz data stored in a checkpoint after the accumulators, i.e.
+ * the partially reconstructed eliminating polynomial, the reconstructed
+ * trace, determinant and witness coefficients and the reconstructed
+ * parametrization, in dst if dst is not NULL. Returns the number of mpz. */
+static int64_t reconstruction_data(mpz_ptr *dst, mpz_param_t mpz_param,
+                                   trace_det_fglm_mat_t trace_det,
+                                   mpz_upoly_t numer, mpz_upoly_t denom) {
+  int64_t k = 0;
+#define REC(x) do { if (dst != NULL) { dst[k] = (x); } k++; } while (0)
+  for (deg_t i = 0; i <= mpz_param->nsols; i++) {
+    REC(numer->coeffs[i]);
+    REC(denom->coeffs[i]);
+  }
+  REC(trace_det->trace_num);
+  REC(trace_det->trace_den);
+  REC(trace_det->det_num);
+  REC(trace_det->det_den);
+  for (uint32_t i = 0; i < 2 * trace_det->nrows; i++) {
+    REC(trace_det->matmul_wqq[i]);
+  }
+  for (deg_t i = 0; i < mpz_param->elim->length; i++) {
+    REC(mpz_param->elim->coeffs[i]);
+  }
+  for (nvars_t i = 0; i < mpz_param->nvars - 1; i++) {
+    for (deg_t j = 0; j < mpz_param->coords[i]->length; j++) {
+      REC(mpz_param->coords[i]->coeffs[j]);
+    }
+    REC(mpz_param->cfs[i]);
+  }
+#undef REC
+  return k;
+}
+
+/* makes a rename in the directory of file persistent */
+static int sync_directory(const char *file) {
+  const char *s = strrchr(file, '/');
+  char *dir = s == NULL ? strdup(".") : strndup(file, s == file ? 1 : s - file);
+  const int fd = open(dir, O_RDONLY);
+  free(dir);
+  if (fd < 0) {
+    return -1;
+  }
+  const int err = fsync(fd) != 0;
+  close(fd);
+  return err ? -1 : 0;
+}
+
+/* Writes the state of the multi-modular loop of msolve_trace_qq to file.
+ * The CRT batch must be flushed, i.e. the parametrization is known modulo
+ * modulus, the product of the primes in mod_primes. Frozen coefficients
+ * have no accumulator, their residues are recovered from the reconstructed
+ * values. The data is written to file.tmp and synced to disk before it
+ * replaces file, so that being interrupted or a crash of the system while
+ * writing does not destroy the previous checkpoint. Returns 0 on success. */
+static int write_checkpoint(const char *file, checkpoint_header_t *hdr,
+                            const uint32_t *mod_primes,
+                            mpz_t modulus, crt_batch_t cb,
+                            mpz_param_t tmp_mpz_param, mpz_param_t mpz_param,
+                            trace_det_fglm_mat_t trace_det,
+                            const int *is_lifted, const int16_t *check_lift,
+                            mpz_upoly_t numer, mpz_upoly_t denom) {
+  char *tmpfile = (char *)malloc(strlen(file) + 5);
+  sprintf(tmpfile, "%s.tmp", file);
+  FILE *f = fopen(tmpfile, "wb");
+  if (f == NULL) {
+    free(tmpfile);
+    return -1;
+  }
+  int err = fwrite(hdr, sizeof(checkpoint_header_t), 1, f) != 1;
+  err |= fwrite(mod_primes, sizeof(uint32_t), hdr->nmod, f) != (size_t)hdr->nmod;
+  err |= mpz_out_raw(f, modulus) == 0;
+
+  mpz_t den, c;
+  mpz_init(den);
+  mpz_init(c);
+  int64_t off = 0;
+  for (int k = 0; k < tmp_mpz_param->nvars; k++) {
+    mpz_upoly_struct *acc = k == 0 ? tmp_mpz_param->elim : tmp_mpz_param->coords[k - 1];
+    mpz_upoly_struct *val = k == 0 ? mpz_param->elim : mpz_param->coords[k - 1];
+    const int frozen = acc->length > 0 && cb->stable[off] != 0;
+    if (frozen) {
+      param_poly_den(den, mpz_param, k);
+      mpz_invert(den, den, modulus);
+    }
+    for (int64_t i = 0; i < acc->length; i++) {
+      if (frozen) {
+        mpz_mul(c, val->coeffs[i], den);
+        mpz_mod(c, c, modulus);
+        err |= mpz_out_raw(f, c) == 0;
+      } else {
+        err |= mpz_out_raw(f, acc->coeffs[i]) == 0;
+      }
+    }
+    off += acc->length;
+  }
+  mpz_clear(c);
+  mpz_clear(den);
+
+  err |= mpz_out_raw(f, trace_det->trace_crt) == 0;
+  err |= mpz_out_raw(f, trace_det->det_crt) == 0;
+  for (uint32_t i = 0; i < trace_det->nrows; i++) {
+    err |= mpz_out_raw(f, trace_det->matmul_wcrt[i]) == 0;
+  }
+
+  /* state of the rational reconstruction */
+  for (int k = 0; k < hdr->nvars; k++) {
+    const int32_t l = is_lifted[k];
+    err |= fwrite(&l, sizeof(int32_t), 1, f) != 1;
+  }
+  err |= fwrite(check_lift, sizeof(int16_t), hdr->nsols + 1, f) !=
+    (size_t)hdr->nsols + 1;
+  err |= fwrite(cb->stable, sizeof(uint8_t), cb->ncf, f) != (size_t)cb->ncf;
+  const int16_t td[4] = {trace_det->done_trace, trace_det->done_det,
+                         trace_det->check_trace, trace_det->check_det};
+  const uint32_t wd[2] = {trace_det->nlifted, trace_det->w_checked};
+  err |= fwrite(td, sizeof(int16_t), 4, f) != 4;
+  err |= fwrite(wd, sizeof(uint32_t), 2, f) != 2;
+  err |= fwrite(trace_det->done_coeffs, sizeof(int16_t), trace_det->nrows, f) !=
+    trace_det->nrows;
+  err |= fwrite(trace_det->check_coeffs, sizeof(int16_t), trace_det->nrows, f) !=
+    trace_det->nrows;
+  const int64_t nr = reconstruction_data(NULL, mpz_param, trace_det, numer, denom);
+  mpz_ptr *rd = (mpz_ptr *)malloc(nr * sizeof(mpz_ptr));
+  reconstruction_data(rd, mpz_param, trace_det, numer, denom);
+  for (int64_t k = 0; k < nr; k++) {
+    err |= mpz_out_raw(f, rd[k]) == 0;
+  }
+  free(rd);
+
+  err |= fflush(f) != 0;
+  err |= fsync(fileno(f)) != 0;
+  err |= fclose(f) != 0;
+  if (err == 0) {
+    err = rename(tmpfile, file) != 0;
+  }
+  if (err == 0) {
+    err = sync_directory(file) != 0;
+  } else {
+    remove(tmpfile);
+  }
+  free(tmpfile);
+  return err ? -1 : 0;
+}
+
+/* reads the header of the checkpoint in file, returns 0 on success */
+static int read_checkpoint_header(const char *file, checkpoint_header_t *hdr) {
+  FILE *f = fopen(file, "rb");
+  if (f == NULL) {
+    return -1;
+  }
+  int err = fread(hdr, sizeof(checkpoint_header_t), 1, f) != 1;
+  fclose(f);
+  return (err || hdr->magic != CHECKPOINT_MAGIC) ? -1 : 0;
+}
+
+static int cmp_uint32(const void *a, const void *b) {
+  const uint32_t ua = *((const uint32_t *)a);
+  const uint32_t ub = *((const uint32_t *)b);
+  return (ua > ub) - (ua < ub);
+}
+
+/* Restores the primes dividing the modulus, the modulus, the accumulators
+ * and the state of the rational reconstruction saved in file. The header
+ * has to be validated against the input system by the caller. The primes
+ * must be distinct primes of [pmin, pmax] starting with the learning prime
+ * and their product must be the modulus. The current run knows the
+ * accumulators modulo the learning prime only, the saved values must
+ * coincide with them modulo this prime. Otherwise the checkpoint belongs
+ * to another computation, e.g. with other options, and nothing is
+ * restored. Returns 0 on success. */
+static int load_checkpoint(const char *file, const checkpoint_header_t *hdr,
+                           const uint32_t pmin, const uint32_t pmax,
+                           uint32_t **mod_primes, int32_t *mod_alloc,
+                           mpz_t modulus, crt_batch_t cb,
+                           mpz_param_t tmp_mpz_param, mpz_param_t mpz_param,
+                           trace_det_fglm_mat_t trace_det, int *is_lifted,
+                           int16_t *check_lift, mpz_upoly_t numer,
+                           mpz_upoly_t denom) {
+  if (hdr->nvars != tmp_mpz_param->nvars || hdr->ncf != cb->ncf ||
+      hdr->nrows != trace_det->nrows || hdr->nsols != tmp_mpz_param->nsols ||
+      hdr->nmod < 1 || hdr->nmod > hdr->nprimes ||
+      hdr->last_prime < pmin || hdr->last_prime > pmax ||
+      !is_prime(hdr->last_prime)) {
+    return -1;
+  }
+  FILE *f = fopen(file, "rb");
+  if (f == NULL) {
+    return -1;
+  }
+  int err = fseek(f, sizeof(checkpoint_header_t), SEEK_SET) != 0;
+
+  const uint32_t p = hdr->primeinit;
+  uint32_t *primes = (uint32_t *)malloc(hdr->nmod * sizeof(uint32_t));
+  uint32_t *sorted = (uint32_t *)malloc(hdr->nmod * sizeof(uint32_t));
+  err = err || fread(primes, sizeof(uint32_t), hdr->nmod, f) != (size_t)hdr->nmod;
+  if (err == 0) {
+    err = primes[0] != p;
+    memcpy(sorted, primes, hdr->nmod * sizeof(uint32_t));
+    qsort(sorted, hdr->nmod, sizeof(uint32_t), cmp_uint32);
+    for (int32_t i = 0; i < hdr->nmod && err == 0; i++) {
+      err = sorted[i] < pmin || sorted[i] > pmax || !is_prime(sorted[i]) ||
+        (i > 0 && sorted[i] == sorted[i - 1]);
+    }
+  }
+  free(sorted);
+
+  /* same order as in write_checkpoint */
+  const int64_t nacc = 1 + cb->ncf + 2 + trace_det->nrows;
+  const int64_t nrec = reconstruction_data(NULL, mpz_param, trace_det, numer, denom);
+  const int64_t n = nacc + nrec;
+  mpz_ptr *dst = (mpz_ptr *)malloc(n * sizeof(mpz_ptr));
+  int64_t k = 0;
+  dst[k++] = modulus;
+  for (len_t j = 0; j < tmp_mpz_param->elim->length; j++) {
+    dst[k++] = tmp_mpz_param->elim->coeffs[j];
+  }
+  for (len_t i = 0; i < tmp_mpz_param->nvars - 1; i++) {
+    for (len_t j = 0; j < tmp_mpz_param->coords[i]->length; j++) {
+      dst[k++] = tmp_mpz_param->coords[i]->coeffs[j];
+    }
+  }
+  dst[k++] = trace_det->trace_crt;
+  dst[k++] = trace_det->det_crt;
+  for (uint32_t i = 0; i < trace_det->nrows; i++) {
+    dst[k++] = trace_det->matmul_wcrt[i];
+  }
+  reconstruction_data(dst + nacc, mpz_param, trace_det, numer, denom);
+
+  mpz_t *v = (mpz_t *)malloc(n * sizeof(mpz_t));
+  for (k = 0; k < nacc; k++) {
+    mpz_init(v[k]);
+    if (err == 0) {
+      err = mpz_inp_raw(v[k], f) == 0;
+    }
+    if (err == 0) {
+      if (k == 0) {
+        /* the modulus is the product of the primes */
+        mpz_t m;
+        mpz_init_set_ui(m, 1);
+        for (int32_t i = 0; i < hdr->nmod; i++) {
+          mpz_mul_ui(m, m, primes[i]);
+        }
+        err = mpz_cmp(m, v[k]) != 0;
+        mpz_clear(m);
+      } else {
+        err = mpz_fdiv_ui(v[k], p) != mpz_fdiv_ui(dst[k], p);
+      }
+    }
   }
+
+  int32_t *il = (int32_t *)malloc(hdr->nvars * sizeof(int32_t));
+  int16_t *cl = (int16_t *)malloc((hdr->nsols + 1) * sizeof(int16_t));
+  uint8_t *sb = (uint8_t *)malloc(cb->ncf * sizeof(uint8_t));
+  int16_t *dc = (int16_t *)malloc(2 * trace_det->nrows * sizeof(int16_t));
+  int16_t td[4];
+  uint32_t wd[2];
+  err = err || fread(il, sizeof(int32_t), hdr->nvars, f) != (size_t)hdr->nvars;
+  err = err || fread(cl, sizeof(int16_t), hdr->nsols + 1, f) !=
+    (size_t)hdr->nsols + 1;
+  err = err || fread(sb, sizeof(uint8_t), cb->ncf, f) != (size_t)cb->ncf;
+  err = err || fread(td, sizeof(int16_t), 4, f) != 4;
+  err = err || fread(wd, sizeof(uint32_t), 2, f) != 2;
+  err = err || fread(dc, sizeof(int16_t), 2 * trace_det->nrows, f) !=
+    2 * trace_det->nrows;
+  for (int32_t i = 0; i < hdr->nvars && err == 0; i++) {
+    err = il[i] < 0 || il[i] > 1;
+  }
+  for (k = nacc; k < n; k++) {
+    mpz_init(v[k]);
+    if (err == 0) {
+      err = mpz_inp_raw(v[k], f) == 0;
+    }
+  }
+  fclose(f);
+
+  for (k = 0; k < n; k++) {
+    if (err == 0) {
+      mpz_swap(dst[k], v[k]);
+    }
+    mpz_clear(v[k]);
+  }
+  if (err == 0) {
+    if (*mod_alloc < hdr->nmod) {
+      *mod_alloc = hdr->nmod;
+      *mod_primes = (uint32_t *)realloc(*mod_primes,
+                                        *mod_alloc * sizeof(uint32_t));
+    }
+    memcpy(*mod_primes, primes, hdr->nmod * sizeof(uint32_t));
+    for (int32_t i = 0; i < hdr->nvars; i++) {
+      is_lifted[i] = il[i];
+    }
+    memcpy(check_lift, cl, (hdr->nsols + 1) * sizeof(int16_t));
+    memcpy(cb->stable, sb, cb->ncf * sizeof(uint8_t));
+    trace_det->done_trace = td[0];
+    trace_det->done_det = td[1];
+    trace_det->check_trace = td[2];
+    trace_det->check_det = td[3];
+    trace_det->nlifted = wd[0];
+    trace_det->w_checked = wd[1];
+    memcpy(trace_det->done_coeffs, dc, trace_det->nrows * sizeof(int16_t));
+    memcpy(trace_det->check_coeffs, dc + trace_det->nrows,
+           trace_det->nrows * sizeof(int16_t));
+  }
+  free(dc);
+  free(sb);
+  free(cl);
+  free(il);
+  free(v);
+  free(dst);
+  free(primes);
+  return err ? -1 : 0;
 }
 
 /**
@@ -1160,11 +1716,68 @@ static inline void lift_coordinate(mpz_param_t mpz_param, mpz_param_t tmp_mpz_pa
 }
 
 
+/* lifts the coordinates which are not yet lifted in parallel, each thread
+ * works on its own copy of the temporary data, only the bounds N and D of
+ * recdata are shared */
+static inline void lift_coordinates(mpz_param_t mpz_param, mpz_param_t tmp_mpz_param,
+        param_t *nmod_param, int16_t *check_lift,
+        mpz_t modulus, mpz_t prod_crt, int32_t prime, mpq_t *coef,
+        rrec_data_t recdata, mpz_t guessed_den, deg_t *maxrec,
+        int *is_lifted, const int nthrds, const int info_level){
+
+    const int nc = mpz_param->nvars - 1;
+    const long nsols = mpz_param->nsols;
+
+#pragma omp parallel num_threads(nthrds)
+  {
+    mpz_upoly_t numer, denom;
+    mpz_upoly_init2(numer, nsols + 1, 0);
+    numer->length = nsols + 1;
+    mpz_upoly_init2(denom, nsols + 1, 0);
+    denom->length = nsols + 1;
+    mpz_t rnum, rden, denominator, lcm, gnum;
+    mpz_init(rnum);
+    mpz_init(rden);
+    mpz_init_set_ui(denominator, 1);
+    mpz_init(lcm);
+    mpz_init(gnum);
+    mpq_t c;
+    mpq_init(c);
+    rrec_data_t rdata;
+    initialize_rrec_data(rdata);
+    mpz_set(rdata->N, recdata->N);
+    mpz_set(rdata->D, recdata->D);
+
+#pragma omp for schedule(dynamic, 1)
+    for(int i = 0; i < nc; i++){
+        mpz_set_ui(mpq_numref(c), 1);
+        mpz_set_ui(mpq_denref(c), 1);
+        lift_coordinate(mpz_param, tmp_mpz_param,
+        nmod_param, numer, denom, check_lift,
+        modulus, prod_crt, prime, coef, rnum, rden,
+        rdata, gnum, guessed_den, maxrec,
+        is_lifted, denominator, lcm, c, i, info_level);
+    }
+
+    free_rrec_data(rdata);
+    mpq_clear(c);
+    mpz_clear(gnum);
+    mpz_clear(lcm);
+    mpz_clear(denominator);
+    mpz_clear(rden);
+    mpz_clear(rnum);
+    mpz_upoly_clear(denom);
+    mpz_upoly_clear(numer);
+  }
+}
+
+
 static inline int lift_parametrization(mpz_param_t mpz_param, mpz_param_t tmp_mpz_param,
         param_t *nmod_param, mpz_upoly_t numer, mpz_upoly_t denom, int16_t *check_lift,
         mpz_t modulus, mpz_t prod_crt, int32_t prime, mpq_t *coef, mpz_t rnum, mpz_t rden,
         rrec_data_t recdata, mpz_t guessed_num, mpz_t guessed_den, deg_t *maxrec,
-        int *is_lifted, mpz_t denominator, mpz_t lcm, const int info_level){
+        int *is_lifted, mpz_t denominator, mpz_t lcm, const int nthrds,
+        const int info_level){
     mpz_set_ui(lcm, 1);
     mpz_set_ui(denominator, 1);
 
@@ -1194,10 +1807,6 @@ static inline int lift_parametrization(mpz_param_t mpz_param, mpz_param_t tmp_mp
     mpz_init(lc);
     mpz_set(lc, mpz_param->elim->coeffs[nsols]);
     mpz_mul_ui(lc, lc, nsols);
-    mpq_t c;
-    mpq_init(c);
-    mpz_set_ui(mpq_numref(c), 1);
-    mpz_set_ui(mpq_denref(c), 1);
     int nc = mpz_param->nvars - 1;
 
     mpz_set(guessed_den, lc);
@@ -1217,34 +1826,14 @@ static inline int lift_parametrization(mpz_param_t mpz_param, mpz_param_t tmp_mp
     else{
           mpz_set_ui(lcm, 1);
     }
-    for(int i = 0; i < nc; i++){
-        lift_coordinate(mpz_param, tmp_mpz_param,
-        nmod_param, numer, denom, check_lift,
-        modulus, prod_crt, prime, coef, rnum, rden,
-        recdata, guessed_num, guessed_den, maxrec,
-        is_lifted, denominator, lcm, c, i, info_level);
-        if(mpz_sizeinbase(guessed_den, 2) <= mpz_sizeinbase(modulus, 2)){
-            mpz_set(lcm, guessed_den);
-        }
-        else{
-            mpz_set_ui(lcm, 1);
-        }
-    }
+    lift_coordinates(mpz_param, tmp_mpz_param, nmod_param, check_lift,
+        modulus, prod_crt, prime, coef, recdata, guessed_den, maxrec,
+        is_lifted, nthrds, info_level);
     mpz_swap(recdata->N, recdata->N2);
     mpz_swap(recdata->D, recdata->D2);
-    for(int i = 0; i < nc; i++){
-        lift_coordinate(mpz_param, tmp_mpz_param,
-        nmod_param, numer, denom, check_lift,
-        modulus, prod_crt, prime, coef, rnum, rden,
-        recdata, guessed_num, guessed_den, maxrec,
-        is_lifted, denominator, lcm, c, i, info_level);
-        if(mpz_sizeinbase(guessed_den, 2) <= mpz_sizeinbase(modulus, 2)){
-            mpz_set(lcm, guessed_den);
-        }
-        else{
-            mpz_set_ui(lcm, 1);
-        }
-    }
+    lift_coordinates(mpz_param, tmp_mpz_param, nmod_param, check_lift,
+        modulus, prod_crt, prime, coef, recdata, guessed_den, maxrec,
+        is_lifted, nthrds, info_level);
     b = 1;
     for(int i = 0; i < nc; i++){
         if(is_lifted[i + 1] == 0){
@@ -1261,19 +1850,9 @@ static inline int lift_parametrization(mpz_param_t mpz_param, mpz_param_t tmp_mp
     mpz_swap(recdata->N, recdata->N1);
     mpz_swap(recdata->D, recdata->D1);
     mpz_swap(recdata->N, recdata->D);
-    for(int i = 0; i < nc; i++){
-        lift_coordinate(mpz_param, tmp_mpz_param,
-        nmod_param, numer, denom, check_lift,
-        modulus, prod_crt, prime, coef, rnum, rden,
-        recdata, guessed_num, guessed_den, maxrec,
-        is_lifted, denominator, lcm, c, i, info_level);
-        if(mpz_sizeinbase(guessed_den, 2) <= mpz_sizeinbase(modulus, 2)){
-            mpz_set(lcm, guessed_den);
-        }
-        else{
-            mpz_set_ui(lcm, 1);
-        }
-    }
+    lift_coordinates(mpz_param, tmp_mpz_param, nmod_param, check_lift,
+        modulus, prod_crt, prime, coef, recdata, guessed_den, maxrec,
+        is_lifted, nthrds, info_level);
     b = 1;
     for(int i = 0; i < nc; i++){
         if(is_lifted[i + 1] == 0){
@@ -1298,7 +1877,7 @@ returns 0 if rational reconstruction failed
 
 static inline int rational_reconstruction_param(
     mpz_param_t mpz_param, mpz_param_t tmp_mpz_param, param_t *nmod_param,
-    nvars_t nlins, nvars_t *linvars, uint32_t *lineqs,
+    crt_batch_t cb, nvars_t nlins, nvars_t *linvars, uint32_t *lineqs,
     trace_det_fglm_mat_t trace_det, sp_matfglm_t *mat, mpz_upoly_t numer,
     mpz_upoly_t denom, int16_t *check_lift, mpz_t modulus, mpz_t prod_crt, int32_t prime,
     mpq_t *coef, mpz_t rnum, mpz_t rden, rrec_data_t recdata,
@@ -1327,8 +1906,9 @@ static inline int rational_reconstruction_param(
   }
 
   /**    CRT PART            **/
-  crt_lift_mpz_param(tmp_mpz_param, nmod_param, modulus, prod_crt, prime,
-                     trace_det->tmp, nthrds);
+  crt_batch_check_lifted(cb, tmp_mpz_param, mpz_param, nmod_param, prime,
+                         is_lifted, modulus, nthrds);
+  crt_batch_add(cb, tmp_mpz_param, nmod_param, prime);
 
   crt_lift_trace_det(trace_det, trace_mod, det_mod, mat,
           lineqs, nmod_param,
@@ -1338,6 +1918,12 @@ static inline int rational_reconstruction_param(
 
   mpz_mul_ui(modulus, modulus, prime);
 
+  /* images of the parametrization are combined batchwise, they are needed
+   * once the batch is full or before rational reconstruction */
+  if (cb->np == cb->alloc || doit != 0) {
+    crt_batch_flush(cb, tmp_mpz_param, modulus, nthrds);
+  }
+
   if (doit == 0) {
     return 0;
   }
@@ -1389,7 +1975,7 @@ static inline int rational_reconstruction_param(
         nmod_param, numer, denom, check_lift,
         modulus, prod_crt, prime, coef, rnum, rden,
         recdata, guessed_num, guessed_den, maxrec,
-        is_lifted, denominator, lcm, info_level);
+        is_lifted, denominator, lcm, nthrds, info_level);
 
     mpz_clear(denominator);
     mpz_clear(lcm);
@@ -1443,6 +2029,50 @@ static inline void check_elim_poly(const nmod_poly_t nmod_poly,
     }
 }
 
+/* Predicts the bit size of the modulus needed to reconstruct the
+ * eliminating polynomial after a failed attempt. The coefficients are
+ * reconstructed from the highest degree downwards, for those which succeeded
+ * we know bit size of numerator plus denominator, which grows roughly
+ * linearly towards the lower degrees. We extrapolate this by a least squares
+ * fit down to degree 0. Returns 0 if there is not enough data. */
+static long predicted_reconstruction_bits(const mpz_upoly_t numer,
+                                          const mpz_upoly_t denom,
+                                          const int16_t *check_lift,
+                                          const deg_t len) {
+  deg_t i, j;
+  for (i = len - 1; i >= 0; i--) {
+    if (check_lift[i] == 0) {
+      break;
+    }
+  }
+  /* eliminating polynomial is lifted or too few coefficients to predict */
+  const deg_t np = len - 1 - i;
+  if (i < 0 || np < 4) {
+    return 0;
+  }
+  double sx = 0, sy = 0, sxx = 0, sxy = 0, ymax = 0;
+  for (j = i + 1; j < len; j++) {
+    const double x = (double)(len - 1 - j);
+    const double y = (double)(mpz_sizeinbase(numer->coeffs[j], 2) +
+                              mpz_sizeinbase(denom->coeffs[j], 2));
+    sx += x;
+    sy += y;
+    sxx += x * x;
+    sxy += x * y;
+    ymax = y > ymax ? y : ymax;
+  }
+  const double dt = np * sxx - sx * sx;
+  if (dt <= 0) {
+    return 0;
+  }
+  const double a = (np * sxy - sx * sy) / dt;
+  const double b = (sy - a * sx) / np;
+  double pred = a * (len - 1) + b;
+  pred = pred > ymax ? pred : ymax;
+  /* the fit is not exact, keep some slack not to miss an early success */
+  return (long)(0.9 * pred);
+}
+
 static inline int
 check_param_nmod_poly(const long len, const mpz_upoly_t mpz_pol,
                       const mpz_t den, const mpz_t lcelim, const long nbsol,
@@ -1591,6 +2221,33 @@ static int equal_param(param_t *param, param_t *test_param){
   return 1;
 }
 
+/* records which elements of the reduced Groebner basis are read by
+ * FGLM in the application phase, i.e. the rows of the multiplication
+ * matrix by the last variable and the linear forms, so that the final
+ * reduction of the other elements is skipped for the next primes. Not
+ * done when the Groebner basis itself is returned, as it is then read
+ * as a reduced basis. */
+static void set_needed_normal_forms(md_t *st, const sp_matfglm_t *matrix,
+                                    const int32_t *div_xn,
+                                    const nvars_t *linvars,
+                                    const int32_t num_gb){
+  if(st->nev > 0 || st->print_gb != 0){
+    /* the positions of div_xn refer to the eliminated basis */
+    return;
+  }
+  free(st->fglm_nf_needed);
+  st->fglm_nf_needed = (int8_t *)calloc(num_gb, sizeof(int8_t));
+  st->fglm_nf_needed_len = num_gb;
+  for(szmat_t i = 0; i < matrix->nrows - matrix->nnfs; i++){
+    st->fglm_nf_needed[div_xn[i]] = 1;
+  }
+  for(nvars_t i = 0; i < st->nvars; i++){
+    if(linvars[i] != 0){
+      st->fglm_nf_needed[linvars[i] - 1] = 1;
+    }
+  }
+}
+
 static int32_t *initial_modular_step(
                                      sp_matfglm_t **bmatrix,
                                      int32_t **bdiv_xn,
@@ -1611,6 +2268,7 @@ static int32_t *initial_modular_step(
                                      uint64_t *bsz,
                                      param_t **bparam,
                                      bs_t *gbg,
+                                     bs_t *lbs,
                                      md_t *md,
                                      const uint32_t fc,
                                      const int32_t unstable_staircase,
@@ -1629,15 +2287,26 @@ static int32_t *initial_modular_step(
 
     int32_t error = 0;
     int32_t empty_solution_set = 1;
-    bs_t *bs = core_gba(gbg, md, &error, fc);
-
-    md->learning_rtime = realtime()-rt;
+    /* lbs is the basis learned in race_learning_primes, if any */
+    bs_t *bs = lbs;
+    if (bs == NULL) {
+        bs = core_gba(gbg, md, &error, fc);
+        md->learning_rtime = realtime()-rt;
+    }
     print_tracer_statistics(VERBSTREAM, rt, md);
 
     get_leading_ideal_information(num_gb, leadmons, 0, bs);
 
     print_groebner_basis(files, gens, bs, md, fc);
 
+    /* Hilbert series of the leading ideal only, neither the staircase
+     * nor the multiplication matrices are needed */
+    if (print_gb == 3) {
+        free_basis_without_hash_table(&(bs));
+        free(bs);
+        return NULL;
+    }
+
     empty_solution_set = check_for_single_element_groebner_basis(dim, dquot_ori,
                                                                  bs, leadmons, 0,
                                                                  md);
@@ -1653,7 +2322,8 @@ static int32_t *initial_modular_step(
                               leadmons[0], bs);
     if (has_dimension_zero(bs->lml, bs->ht->nv, leadmons[0])) {
         long dquot = 0;
-        int32_t *lmb = monomial_basis(bs->lml, bs->ht->nv, leadmons[0], &dquot);
+        int32_t *lmb = monomial_basis(bs->lml, bs->ht->nv, leadmons[0], &dquot,
+                                      &(gens->staircase));
 
         /* if(md->info_level){ */
         /*     fprintf(ERRSTREAM, "Dimension of quotient: %ld\n", dquot); */
@@ -1817,6 +2487,10 @@ static void secondary_modular_steps(sp_matfglm_t **bmatrix,
     for(nvars_t i = 0; i < st->nprimes; i++){
       bad_primes[i] = 0;
     }
+    /* the bases computed here are only read to build the multiplication
+     * matrices and the linear forms */
+    st->nf_needed     = st->fglm_nf_needed;
+    st->nf_needed_len = st->fglm_nf_needed_len;
 #pragma omp parallel for num_threads(nthrds)  \
     private(i) schedule(static)
     for (i = 0; i < st->nprimes; ++i){
@@ -1890,27 +2564,97 @@ static void secondary_modular_steps(sp_matfglm_t **bmatrix,
             bad_primes[i] = 1;
             }
      }
-        if(nmod_fglm_compute_apply_trace_data(bmatrix[i], lp->p[i],
-                                              nmod_params[i],
-                                              bs_qq->ht->nv,
-                                              bsz,
-                                              bnlins[i], blinvars[i], blineqs[i],
-                                              bsquvars[i],
-                                              bdata_fglm[i],
-                                              bdata_bms[i],
-                                              nbsols,
-                                              info_level,
-                                              st)){
-                bad_primes[i] = 1;
-            }
         if (bs[i] != NULL) {
             free_basis_and_only_local_hash_table_data(&(bs[i]));
         }
     }
+  st->nf_needed = NULL;
   st->nthrds = nthrds;
+
+  /* FGLM is run once F4 is done for all primes, one prime per thread */
+  nmod_fglm_compute_apply_trace_data_multi(bmatrix, lp->p, st->nprimes,
+                                           nmod_params, bs_qq->ht->nv, bsz,
+                                           bnlins, blinvars, blineqs,
+                                           bsquvars, bdata_fglm, bdata_bms,
+                                           nbsols, bad_primes, st);
 }
 
 
+/* data of the learning phase, inherited by worker processes to run
+ * secondary_modular_steps on their own */
+typedef struct{
+  sp_matfglm_t **bmatrix;
+  int32_t **bdiv_xn;
+  int32_t **blen_gb_xn;
+  int32_t **bstart_cf_gb_xn;
+  long **bextra_nf;
+  int32_t **blens_extra_nf;
+  int32_t **bexps_extra_nf;
+  int32_t **bcfs_extra_nf;
+  nvars_t *bnlins;
+  nvars_t **blinvars;
+  uint32_t **blineqs;
+  nvars_t **bsquvars;
+  fglm_data_t **bdata_fglm;
+  fglm_bms_data_t **bdata_bms;
+  int32_t *num_gb;
+  int32_t **leadmons_ori;
+  int32_t **leadmons_current;
+  uint64_t bsz;
+  param_t **nmod_params;
+  bs_t *bs_qq;
+  md_t *st;
+  uint32_t fc;
+  int32_t unstable_staircase;
+  bs_t **bs;
+  int32_t *lmb_ori;
+  int32_t dquot_ori;
+  primes_t *lp;
+  data_gens_ff_t *gens;
+  long nbsols;
+  uint32_t *bad_primes;
+  trace_det_fglm_mat_struct *trace_det;
+} multimod_data_t;
+
+/* main loop of a worker process, see farm.c: computes the image of the
+ * parametrization modulo each prime received from rfd using the data of
+ * the first thread and sends it to wfd, failures are sent as bad primes */
+static void multimod_worker(int rfd, int wfd, void *data){
+  multimod_data_t *d = (multimod_data_t *)data;
+  md_t *st = d->st;
+  /* each worker process replaces one thread of the coordinator, with one
+   * thread no parallel region uses the OpenMP thread pool inherited from
+   * the coordinator, which is not usable after fork */
+  st->nthrds  = 1;
+  st->nprimes = 1;
+  param_t *par = d->nmod_params[0];
+  uint32_t prime;
+
+  while (farm_read(rfd, &prime, sizeof(uint32_t)) == 0 && prime != 0) {
+    double stf4 = 0;
+    d->lp->p[0] = prime;
+    secondary_modular_steps(d->bmatrix, d->bdiv_xn, d->blen_gb_xn,
+                            d->bstart_cf_gb_xn, d->bextra_nf,
+                            d->blens_extra_nf, d->bexps_extra_nf,
+                            d->bcfs_extra_nf, d->bnlins, d->blinvars,
+                            d->blineqs, d->bsquvars, d->bdata_fglm,
+                            d->bdata_bms, d->num_gb, d->leadmons_ori,
+                            d->leadmons_current, d->bsz, d->nmod_params,
+                            d->bs_qq, st, d->fc, d->unstable_staircase, 0,
+                            d->bs, d->lmb_ori, d->dquot_ori, d->lp, d->gens,
+                            &stf4, d->nbsols, d->bad_primes, d->trace_det);
+    /* F4 failures drop the parametrization of the thread */
+    if (d->nmod_params[0] == NULL) {
+      d->nmod_params[0] = par;
+    }
+    if (farm_write_image(wfd, prime, d->bad_primes[0], d->nmod_params[0],
+                         d->bmatrix[0], d->trace_det->matmul_indices,
+                         d->trace_det->nrows, stf4)) {
+      break;
+    }
+  }
+}
+
 /* returns 1 if the parametrization can be split, otherwise returns 0*/
 int is_splittable(param_t **nmod_params, const int fc){
     nmod_poly_t gcd;
@@ -1980,20 +2724,6 @@ void set_linear_function_pointer(int32_t fc) {
   }
 }
 
-static inline int is_lucky_matmul_prime_ui(uint32_t prime,
-        trace_det_fglm_mat_t trace_det) {
-  if (trace_det->mat_lifted < 2) {
-    return 0;
-  }
-  for (uint32_t i = 0; i < trace_det->nrows; i++) {
-    if (mpz_fdiv_ui(trace_det->mat_denoms[i], prime) == 0) {
-      return 1;
-    }
-  }
-  return 0;
-}
-
-
 static void free_msolve_trace_qq_secondary_data(mpz_param_t tmp_mpz_param,
         trace_det_fglm_mat_t trace_det, mpz_t modulus, mpz_t prod_crt, mpq_t result,
         mpq_t test, mpz_t rnum, mpz_t rden, mpz_upoly_t numer, mpz_upoly_t denom,
@@ -2060,6 +2790,8 @@ static void free_msolve_trace_qq_initial_data(int *invalid_gens, md_t *st, prime
       }
     }
     free_trace(&(st->tr));
+    free(st->hf);
+    free(st->fglm_nf_needed);
     free(st);
     free(bs);
     free(nmod_params);
@@ -2115,6 +2847,187 @@ int is_member(uint32_t fc, primes_t *init_primes){
     return 0;
 }
 
+/* next prime of the stream usable in the multi-modular loop, 0 if the
+ * stream is exhausted */
+static inline uint32_t next_multimod_prime(prime_stream_t *ps,
+                                           const uint32_t primeinit,
+                                           primes_t *binit_primes){
+  uint32_t prime;
+  do {
+    prime = prime_stream_next(ps);
+  } while (prime != 0 &&
+           (prime == primeinit || is_member(prime, binit_primes)));
+  return prime;
+}
+
+/* Learning phase raced on nlearn primes: *prime and nlearn - 1 further
+ * primes are learned concurrently, each F4 run gets its share of the
+ * threads of st and its own copy of the basis hash table of bs_qq. The
+ * trace of the first run to finish is kept. It is only committed to once
+ * a second run has finished, too, and has the same leading ideal, the
+ * remaining runs are cancelled then. If the leading ideals differ, one of
+ * both primes is unlucky and the race is restarted on new primes.
+ *
+ * On return st and the hash table of bs_qq are those of the kept run,
+ * its prime is stored in *prime and its Groebner basis is returned. The
+ * primes of the other runs are added to binit_primes. If all runs fail
+ * NULL is returned. */
+static bs_t *race_learning_primes(uint32_t *prime, bs_t *bs_qq, md_t *st,
+                                  const int32_t nlearn,
+                                  primes_t **binit_primes){
+  const int32_t nthrds = st->nthrds;
+  const int32_t info_level = st->info_level;
+  const double rt = realtime();
+  /* meta data before learning, restored when restarting */
+  const md_t st0 = *st;
+
+  uint32_t *primes = (uint32_t *)malloc(nlearn * sizeof(uint32_t));
+  md_t **mds = (md_t **)malloc(nlearn * sizeof(md_t *));
+  bs_t **gbs = (bs_t **)malloc(nlearn * sizeof(bs_t *));
+  bs_t **lbs = (bs_t **)calloc(nlearn, sizeof(bs_t *));
+
+  /* run finishing first resp. second */
+  int32_t w, v;
+  int32_t restart = 0;
+  do {
+    primes[0] = *prime;
+    mds[0] = st;
+    gbs[0] = bs_qq;
+    for (int32_t i = restart ? 0 : 1; i < nlearn; i++) {
+      uint32_t p;
+      int used;
+      do {
+        p = next_prime(rand() % (1303905301 - (1 << 30) + 1) + (1 << 30));
+        used = 0;
+        for (int32_t j = 0; j < i; j++) {
+          used |= p == primes[j];
+        }
+      } while (used || is_lucky_prime_ui(p, bs_qq)
+               || is_member(p, *binit_primes));
+      primes[i] = p;
+    }
+    for (int32_t i = 1; i < nlearn; i++) {
+      /* only the generators are shared, they are read only in F4 */
+      mds[i] = (md_t *)malloc(sizeof(md_t));
+      memcpy(mds[i], st, sizeof(md_t));
+      mds[i]->info_level = 0;
+      gbs[i] = (bs_t *)malloc(sizeof(bs_t));
+      memcpy(gbs[i], bs_qq, sizeof(bs_t));
+      gbs[i]->ht = copy_hash_table(bs_qq->ht);
+    }
+    /* number of runs which finished their trace, the second one cancels
+     * the others */
+    int32_t nfinished = 0;
+    int32_t cancel = 0;
+    for (int32_t i = 0; i < nlearn; i++) {
+      mds[i]->nthrds = nthrds / nlearn > 0 ? nthrds / nlearn : 1;
+      mds[i]->print_gb = 0;
+      mds[i]->f4_qq_round = 1;
+      mds[i]->cancel = &cancel;
+    }
+    if (info_level) {
+      fprintf(VERBSTREAM, "Racing learning phase on %d primes:", nlearn);
+      for (int32_t i = 0; i < nlearn; i++) {
+        fprintf(VERBSTREAM, " %u", primes[i]);
+      }
+      fprintf(VERBSTREAM, "\n");
+    }
+
+    /* each run spawns its own team of threads for linear algebra */
+    const int levels = omp_get_max_active_levels();
+    omp_set_max_active_levels(levels > 2 ? levels : 2);
+    w = -1;
+    v = -1;
+#pragma omp parallel for num_threads(nlearn) schedule(static, 1)
+    for (int32_t i = 0; i < nlearn; i++) {
+      int32_t err = 0;
+      lbs[i] = core_gba(gbs[i], mds[i], &err, primes[i]);
+      if (err > 0 || lbs[i] == NULL) {
+        lbs[i] = NULL;
+        continue;
+      }
+      int32_t rank;
+#pragma omp atomic capture
+      rank = nfinished++;
+      if (rank == 0) {
+        w = i;
+      }
+      if (rank == 1) {
+        v = i;
+#pragma omp atomic write
+        cancel = 1;
+      }
+    }
+    omp_set_max_active_levels(levels);
+
+    /* without a second run, e.g. if all others failed, the trace of the
+     * first one is kept as for a single learning prime */
+    restart = w >= 0 && v >= 0 && !basis_lm_is_equal(lbs[w], lbs[v]);
+    if (info_level && w >= 0) {
+      fprintf(VERBSTREAM, "Learning prime %u finished first", primes[w]);
+      if (v >= 0) {
+        fprintf(VERBSTREAM, ", leading ideal %s modulo %u",
+                restart ? "differs" : "confirmed", primes[v]);
+      }
+      fprintf(VERBSTREAM, "\n");
+    }
+
+    /* the kept run takes over the place of st and bs_qq */
+    if (w > 0 && !restart) {
+      md_t tmd = *st;
+      *st = *mds[w];
+      *mds[w] = tmd;
+      ht_t *tht = bs_qq->ht;
+      bs_qq->ht = gbs[w]->ht;
+      gbs[w]->ht = tht;
+    }
+    if (w >= 0 && !restart) {
+      *prime = primes[w];
+    }
+    if (w < 0) {
+      *prime = primes[0];
+    }
+
+    for (int32_t i = 0; i < nlearn; i++) {
+      if ((i != w || restart) && lbs[i] != NULL) {
+        free_basis_without_hash_table(&(lbs[i]));
+        free(lbs[i]);
+      }
+      /* primes which are not kept are not used again */
+      if ((i != w || restart) && !is_member(primes[i], *binit_primes)) {
+        update_initial_primes(binit_primes, primes[i]);
+      }
+      if (i > 0) {
+        free_trace(&(mds[i]->tr));
+        free(mds[i]->hf);
+        free(mds[i]);
+        /* hash table copies share the divisor masks with bs_qq */
+        free_hash_table(&(gbs[i]->ht));
+        free(gbs[i]);
+      }
+    }
+    if (restart) {
+      free_trace(&(st->tr));
+      free(st->hf);
+      *st = st0;
+    }
+  } while (restart);
+
+  st->nthrds = nthrds;
+  st->info_level = info_level;
+  st->cancel = NULL;
+  if (w >= 0) {
+    st->learning_rtime = realtime() - rt;
+  }
+
+  free(primes);
+  bs_t *bs = w >= 0 ? lbs[w] : NULL;
+  free(lbs);
+  free(gbs);
+  free(mds);
+  return bs;
+}
+
 /*
 
   - returns 0 if computation is ok.
@@ -2140,6 +3053,8 @@ int is_member(uint32_t fc, primes_t *init_primes){
   - returns -3 if meta data are not correct
 
   - renvoie -4 if bad prime
+
+  - returns -5 if all primes have been used
 */
 
 int msolve_trace_qq(mpz_param_t *mpz_paramp,
@@ -2212,6 +3127,12 @@ int msolve_trace_qq(mpz_param_t *mpz_paramp,
     free(st);
     return -3;
   }
+  /* for homogeneous input the Hilbert function of the leading ideal
+   * w.r.t. the learning prime is used to prune pairs for other primes */
+  if (files != NULL) {
+      st->bw_min_dim = files->bw_min_dim;
+      st->hilbert_driven = files->hilbert_driven;
+  }
 
   /* lucky primes */
   primes_t *lp = (primes_t *)calloc(st->nthrds, sizeof(primes_t));
@@ -2228,6 +3149,24 @@ int msolve_trace_qq(mpz_param_t *mpz_paramp,
 
   print_initial_statistics(VERBSTREAM, st);
 
+  /* the Hilbert function is only known to bound the pairs degree by
+   * degree w.r.t. the standard grading, weighted degrees are not handled.
+   * traced computations do not select pairs, so there is nothing to prune */
+  if (st->hilbert_driven == 1) {
+    if (st->homogeneous == 0 || st->mo != 0 || st->nev != 0) {
+      fprintf(ERRSTREAM, "Hilbert driven pruning needs homogeneous input ");
+      fprintf(ERRSTREAM, "and no elimination, quasi-homogeneous input is ");
+      fprintf(ERRSTREAM, "not supported, pruning is disabled\n");
+      st->hilbert_driven = 0;
+    } else {
+      if (st->laopt < 40) {
+        fprintf(ERRSTREAM, "Hilbert driven pruning needs a linear algebra ");
+        fprintf(ERRSTREAM, "option >= 40 (no tracer), pruning is disabled\n");
+        st->hilbert_driven = 0;
+      }
+    }
+  }
+
   /* for faster divisibility checks, needs to be done after we have
    * read some input data for applying heuristics */
   calculate_divmask(bs_qq->ht);
@@ -2264,6 +3203,22 @@ int msolve_trace_qq(mpz_param_t *mpz_paramp,
   while (gens->field_char == 0 && (is_lucky_prime_ui(prime, bs_qq) || is_member(prime, (*binit_primes)))) {
     prime = next_prime(rand() % (1303905301 - (1 << 30) + 1) + (1 << 30));
   }
+  /* resuming from a checkpoint requires learning modulo the same prime */
+  checkpoint_header_t ckpt;
+  int resume = files != NULL && files->checkpoint_file != NULL &&
+    files->resume && gens->field_char == 0;
+  if (resume) {
+    resume = read_checkpoint_header(files->checkpoint_file, &ckpt) == 0 &&
+      ckpt.input == input_system_digest(gens) &&
+      !is_lucky_prime_ui(ckpt.primeinit, bs_qq) &&
+      !is_member(ckpt.primeinit, (*binit_primes));
+    if (resume) {
+      prime = ckpt.primeinit;
+    } else {
+      fprintf(ERRSTREAM, "Checkpoint does not match this computation, ");
+      fprintf(ERRSTREAM, "starting from scratch\n");
+    }
+  }
   primeinit = prime;
   lp->p[0] = primeinit;
   if(info_level && gens->field_char == 0){
@@ -2334,6 +3289,18 @@ int msolve_trace_qq(mpz_param_t *mpz_paramp,
   int success = 1;
   int squares = 1;
 
+  /* learning phase on several primes, keep the best trace */
+  bs_t *lbs = NULL;
+  if (files != NULL && files->nlearn > 1 && gens->field_char == 0 &&
+      !resume && print_gb == 0) {
+    lbs = race_learning_primes(&prime, bs_qq, st, files->nlearn, binit_primes);
+    if (prime != primeinit) {
+      primeinit = prime;
+      lp->p[0] = primeinit;
+      update_initial_primes(binit_primes, lp->p[0]);
+    }
+  }
+
   int32_t *lmb_ori = initial_modular_step(bmatrix, bdiv_xn, blen_gb_xn,
 					  bstart_cf_gb_xn,
 					  bextra_nf,
@@ -2349,7 +3316,7 @@ int msolve_trace_qq(mpz_param_t *mpz_paramp,
 					  num_gb, leadmons_ori,
 
 					  &bsz, nmod_params,
-					  bs_qq, st,
+					  bs_qq, lbs, st,
 					  lp->p[0], //prime,
 					  unstable_staircase,
 					  print_gb,
@@ -2462,6 +3429,19 @@ int msolve_trace_qq(mpz_param_t *mpz_paramp,
   }
 
   *to_split_ptr = is_splittable(nmod_params, lp->p[0]);
+  set_needed_normal_forms(st, bmatrix[0], bdiv_xn[0], blinvars[0], num_gb[0]);
+  /* without lifting of the multiplication matrix, only its witness
+   * coefficients are read outside FGLM, large matrices are then compressed
+   * (also those of the other threads, see duplicate_data_mthread_trace) */
+  if(!lift_matrix && (uint64_t)bmatrix[0]->nrows * bmatrix[0]->ncols
+     >= sp_matfglm_compress_min()){
+    sp_matfglm_compress(bmatrix[0]);
+    if(info_level){
+      fprintf(VERBSTREAM, "Compressed multiplication matrix: %.2f%% of dense storage\n",
+              100 * (double)bmatrix[0]->cmp_len
+              / ((double)bmatrix[0]->nrows * bmatrix[0]->ncols));
+    }
+  }
   /* duplicate data for multi-threaded multi-mod computation */
   duplicate_data_mthread_trace(st->nthrds, bs_qq, st, num_gb,
                               leadmons_ori, leadmons_current,
@@ -2518,6 +3498,10 @@ int msolve_trace_qq(mpz_param_t *mpz_paramp,
 
   deg_t nsols = tmp_mpz_param->nsols;
 
+  /* images of the parametrization not yet merged into tmp_mpz_param */
+  crt_batch_t cb;
+  crt_batch_init(cb, tmp_mpz_param, modulus);
+
   mpz_upoly_t numer;
   mpz_upoly_init2(numer, (nsols + 1), 32 * (nsols + 1));
   numer->length = nsols + 1;
@@ -2560,57 +3544,185 @@ int msolve_trace_qq(mpz_param_t *mpz_paramp,
   rrec_data_t recdata;
   initialize_rrec_data(recdata);
 
+  /* checkpoints are not supported when lifting multiplication matrices */
+  const char *ckpt_file = NULL;
+  if (files != NULL && files->checkpoint_file != NULL &&
+      trace_det->lift_matrix == 0) {
+    ckpt_file = files->checkpoint_file;
+  }
+  double ckpt_time = realtime();
+  /* primes dividing the modulus */
+  int32_t nmod = 1;
+  int32_t mod_alloc = 64;
+  uint32_t *mod_primes = (uint32_t *)malloc(mod_alloc * sizeof(uint32_t));
+  mod_primes[0] = primeinit;
+  if (resume && ckpt_file != NULL) {
+    if (load_checkpoint(ckpt_file, &ckpt, 1 << 30, lprime, &mod_primes,
+                        &mod_alloc, modulus, cb, tmp_mpz_param, *mpz_paramp,
+                        trace_det, is_lifted, check_lift, numer, denom) == 0) {
+      mpz_set(prod_crt, modulus);
+      mpz_set(cb->mod, modulus);
+      nmod = ckpt.nmod;
+      nprimes = ckpt.nprimes;
+      nbadprimes = ckpt.nbadprimes;
+      nbdoit = ckpt.nbdoit;
+      rerun = ckpt.rerun;
+      maxrec = ckpt.maxrec;
+      clog = LOG2(nprimes);
+      if (info_level) {
+        fprintf(VERBSTREAM, "Resuming from checkpoint with %d primes\n",
+                nprimes);
+      }
+    } else {
+      fprintf(ERRSTREAM, "Checkpoint does not match this computation, ");
+      fprintf(ERRSTREAM, "starting from scratch\n");
+      resume = 0;
+    }
+  } else {
+    resume = 0;
+  }
+
+  /* stream of primes after primeinit, filtered in batches against the
+   * coefficients of the input system */
+  prime_stream_t ps[1];
+  prime_stream_init(ps, primeinit, 1 << 30, lprime, st->nthrds);
+  mpz_t prod;
+  mpz_init(prod);
+  lucky_primes_product_of_input(prod, bs_qq);
+  prime_stream_mul_product(ps, prod);
+  /* skip the primes already handed out before the checkpoint */
+  if (resume) {
+    uint32_t q;
+    do {
+      q = prime_stream_next(ps);
+    } while (q != 0 && q != ckpt.last_prime);
+  }
+  int denoms_in_stream = 0;
+
+  /* worker processes computing images of the parametrization, not used
+   * when multiplication matrices are lifted as this needs all of their
+   * coefficients */
+  farm_t farm;
+  farm.nw = 0;
+  multimod_data_t mmd;
+  if (files != NULL && files->nworkers > 0 && trace_det->lift_matrix == 0) {
+    mmd.bmatrix = bmatrix;
+    mmd.bdiv_xn = bdiv_xn;
+    mmd.blen_gb_xn = blen_gb_xn;
+    mmd.bstart_cf_gb_xn = bstart_cf_gb_xn;
+    mmd.bextra_nf = bextra_nf;
+    mmd.blens_extra_nf = blens_extra_nf;
+    mmd.bexps_extra_nf = bexps_extra_nf;
+    mmd.bcfs_extra_nf = bcfs_extra_nf;
+    mmd.bnlins = bnlins;
+    mmd.blinvars = blinvars;
+    mmd.blineqs = lineqs_ptr;
+    mmd.bsquvars = bsquvars;
+    mmd.bdata_fglm = bdata_fglm;
+    mmd.bdata_bms = bdata_bms;
+    mmd.num_gb = num_gb;
+    mmd.leadmons_ori = leadmons_ori;
+    mmd.leadmons_current = leadmons_current;
+    mmd.bsz = bsz;
+    mmd.nmod_params = nmod_params;
+    mmd.bs_qq = bs_qq;
+    mmd.st = st;
+    mmd.fc = field_char;
+    mmd.unstable_staircase = unstable_staircase;
+    mmd.bs = bs;
+    mmd.lmb_ori = lmb_ori;
+    mmd.dquot_ori = *dquot_ptr;
+    mmd.lp = lp;
+    mmd.gens = gens;
+    mmd.nbsols = nsols;
+    mmd.bad_primes = bad_primes;
+    mmd.trace_det = trace_det;
+    if (farm_start(&farm, files->nworkers, multimod_worker, &mmd) == 0) {
+      for (int32_t w = 0; w < farm.nw; w++) {
+        const uint32_t q = next_multimod_prime(ps, primeinit, *binit_primes);
+        if (q == 0 || farm_send_prime(&farm, w, q)) {
+          farm_stop(&farm);
+          break;
+        }
+      }
+    }
+    if (info_level && farm.nw > 0) {
+      fprintf(VERBSTREAM, "Using %d worker processes\n", farm.nw);
+    }
+  }
+
   /* measures time spent in rational reconstruction */
   double strat = 0;
 
-  while (rerun == 1 || mcheck == 1) {
-    /* controls call to rational reconstruction */
-    doit = ((prdone % nbdoit) == 0);
+  /* predicted bit size of the modulus needed for rational reconstruction */
+  long rrec_bits = resume ? ckpt.rrec_bits : 0;
 
-    /* generate lucky prime numbers */
-    prime = next_prime(prime);
-    if (prime >= lprime) {
-      prime = next_prime(1 << 30);
-    }
-    lp->p[0] = prime;
-    while (is_lucky_prime_ui(prime, bs_qq) || is_member(prime, (*binit_primes))) {
-      prime = next_prime(prime);
-      if (prime >= lprime) {
-        prime = next_prime(1 << 30);
-      }
-      lp->p[0] = prime;
+  while (rerun == 1 || mcheck == 1) {
+    /* controls call to rational reconstruction, no attempt is made as
+     * long as the modulus is predicted to be too small */
+    doit = ((prdone % nbdoit) == 0) &&
+      ((long)mpz_sizeinbase(modulus, 2) + 32 * st->nthrds >= rrec_bits);
+
+    /* generate lucky prime numbers, once the matrix is lifted its
+     * denominators must not vanish modulo the primes either */
+    if (trace_det->lift_matrix && trace_det->mat_lifted == 2 &&
+        denoms_in_stream == 0) {
+      lucky_primes_product_of_matrix_denominators(prod, trace_det);
+      prime_stream_mul_product(ps, prod);
+      denoms_in_stream = 1;
     }
-    for (len_t i = 1; i < st->nthrds; i++) {
-      prime = next_prime(prime);
-      if (prime >= lprime) {
-        prime = next_prime(1 << 30);
-      }
-      lp->p[i] = prime;
-      if(trace_det->lift_matrix){
-          while (is_lucky_prime_ui(prime, bs_qq) || prime == primeinit ||
-             is_lucky_matmul_prime_ui(prime, trace_det)) {
-              prime = next_prime(prime);
-              if (prime >= lprime) {
-                  prime = next_prime(1 << 30);
-              }
-              lp->p[i] = prime;
-          }
-      }
-      else{
-        while (is_lucky_prime_ui(prime, bs_qq) || prime == primeinit) {
-          prime = next_prime(prime);
-          if (prime >= lprime) {
-            prime = next_prime(1 << 30);
+    double ca0 = realtime();
+    double stf4 = 0;
+    if (farm.nw > 0) {
+      /* images are received in the order the primes were sent, a worker
+       * gets its next prime right away */
+      for (len_t i = 0; i < st->nthrds; i++) {
+        const int32_t w = farm.next;
+        double tf4 = 0;
+        if (farm_read_image(farm.res[w], &lp->p[i], &bad_primes[i],
+                            nmod_params[i], bmatrix[i],
+                            trace_det->matmul_indices, trace_det->nrows,
+                            &tf4)) {
+          fprintf(ERRSTREAM, "Worker process failed, ");
+          fprintf(ERRSTREAM, "continuing without worker processes\n");
+          farm_stop(&farm);
+          break;
+        }
+        /* without further primes the farm is stopped, the exhausted
+         * stream is then detected below */
+        const uint32_t q = next_multimod_prime(ps, primeinit, *binit_primes);
+        if (q == 0 || farm_send_prime(&farm, w, q)) {
+          if (q != 0) {
+            fprintf(ERRSTREAM, "Worker process failed, ");
+            fprintf(ERRSTREAM, "continuing without worker processes\n");
           }
-          lp->p[i] = prime;
+          farm_stop(&farm);
+          break;
         }
+        stf4 = tf4 > stf4 ? tf4 : stf4;
+        farm.next = (w + 1) % farm.nw;
       }
     }
-    prime = lp->p[st->nthrds - 1];
-
-    double ca0 = realtime();
-    double stf4 = 0;
-    secondary_modular_steps(bmatrix,
+    if (farm.nw == 0) {
+      for (len_t i = 0; i < st->nthrds; i++) {
+        lp->p[i] = next_multimod_prime(ps, primeinit, *binit_primes);
+        if (lp->p[i] == 0) {
+          free_msolve_trace_qq_initial_data(invalid_gens, st, lp, bs_qq, bs, nmod_params,
+              bad_primes, bmatrix, bdiv_xn, blen_gb_xn, bstart_cf_gb_xn, bextra_nf,
+              blens_extra_nf, bexps_extra_nf, bcfs_extra_nf, bdata_fglm, bdata_bms,
+              num_gb, leadmons_ori, leadmons_current, bnlins, blinvars, linvars,
+              lineqs_ptr, bsquvars, squvars, lmb_ori, field_char);
+          free_msolve_trace_qq_secondary_data(tmp_mpz_param, trace_det, modulus,
+                  prod_crt, result, test, rnum, rden, numer, denom, check_lift,
+                  guessed_num, guessed_den, is_lifted, recdata);
+          prime_stream_clear(ps);
+          mpz_clear(prod);
+          crt_batch_clear(cb);
+          free(mod_primes);
+          return -5;
+        }
+      }
+      secondary_modular_steps(bmatrix,
 			    bdiv_xn,
 			    blen_gb_xn,
 			    bstart_cf_gb_xn,
@@ -2637,6 +3749,8 @@ int msolve_trace_qq(mpz_param_t *mpz_paramp,
 			    bs, lmb_ori, *dquot_ptr, lp,
 			    gens, &stf4, nsols, bad_primes,
                 trace_det);
+    }
+    prime = lp->p[st->nthrds - 1];
     double ca1 = realtime() - ca0;
 
     if (nprimes == 1) {
@@ -2703,13 +3817,19 @@ int msolve_trace_qq(mpz_param_t *mpz_paramp,
         crr = realtime();
         if (mcheck == 1) {
           br = rational_reconstruction_param(
-              *mpz_paramp, tmp_mpz_param, nmod_params[i],
+              *mpz_paramp, tmp_mpz_param, nmod_params[i], cb,
               bnlins[i], blinvars[i], lineqs_ptr[i],
               trace_det, bmatrix[i], numer,
               denom, check_lift, modulus, prod_crt, lp->p[i], &result, rnum, rden, recdata,
               guessed_num, guessed_den, &maxrec, &matrec, &oldmatrec_checked,
               &matrec_checked, is_lifted,
               &mat_lifted, &lin_lifted, doit, nbdoit, st->nthrds, info_level);
+          if (nmod == mod_alloc) {
+            mod_alloc = 2 * mod_alloc;
+            mod_primes = (uint32_t *)realloc(mod_primes,
+                                             mod_alloc * sizeof(uint32_t));
+          }
+          mod_primes[nmod++] = lp->p[i];
 
           if (br == 1) {
             rerun = 0;
@@ -2734,12 +3854,29 @@ int msolve_trace_qq(mpz_param_t *mpz_paramp,
           free_msolve_trace_qq_secondary_data(tmp_mpz_param, trace_det, modulus,
                   prod_crt, result, test, rnum, rden, numer, denom, check_lift,
                   guessed_num, guessed_den, is_lifted, recdata);
+          if (farm.nw > 0) {
+            farm_stop(&farm);
+          }
+          prime_stream_clear(ps);
+          mpz_clear(prod);
+          crt_batch_clear(cb);
+          free(mod_primes);
           return -4;
         }
       }
     }
     strat += scrr;
 
+    if (doit && rerun == 1) {
+      rrec_bits = predicted_reconstruction_bits(numer, denom, check_lift,
+                                                nsols + 1);
+      if (info_level > 1 && rrec_bits > 0) {
+        fprintf(VERBSTREAM, "<pred:%ld/%lu>", rrec_bits,
+                (unsigned long)mpz_sizeinbase(modulus, 2));
+        fflush(VERBSTREAM);
+      }
+    }
+
     double t = ((double)nbdoit) * ca1;
     if ((t == 0) || (scrr >= 0.2 * t && br == 0)) {
       nbdoit = 2 * nbdoit;
@@ -2761,6 +3898,37 @@ int msolve_trace_qq(mpz_param_t *mpz_paramp,
       clog++;
       lpow2 = 2 * lpow2;
     }
+
+    if (ckpt_file != NULL &&
+        realtime() - ckpt_time >= files->checkpoint_period) {
+      crt_batch_flush(cb, tmp_mpz_param, modulus, st->nthrds);
+      checkpoint_header_t hdr;
+      memset(&hdr, 0, sizeof(checkpoint_header_t));
+      hdr.magic = CHECKPOINT_MAGIC;
+      hdr.primeinit = primeinit;
+      hdr.last_prime = prime;
+      hdr.input = input_system_digest(gens);
+      hdr.nprimes = nprimes;
+      hdr.nmod = nmod;
+      hdr.nbdoit = nbdoit;
+      hdr.rerun = rerun;
+      hdr.nbadprimes = nbadprimes;
+      hdr.rrec_bits = rrec_bits;
+      hdr.maxrec = maxrec;
+      hdr.nvars = tmp_mpz_param->nvars;
+      hdr.nrows = trace_det->nrows;
+      hdr.nsols = tmp_mpz_param->nsols;
+      hdr.ncf = cb->ncf;
+      if (write_checkpoint(ckpt_file, &hdr, mod_primes, modulus, cb,
+                           tmp_mpz_param, *mpz_paramp, trace_det, is_lifted,
+                           check_lift, numer, denom)) {
+        fprintf(ERRSTREAM, "Cannot write checkpoint file %s\n", ckpt_file);
+      } else if (info_level) {
+        fprintf(VERBSTREAM, "<ckpt>");
+        fflush(VERBSTREAM);
+      }
+      ckpt_time = realtime();
+    }
   }
 
   (*mpz_paramp)->denom->length = (*mpz_paramp)->nsols;
@@ -2795,6 +3963,13 @@ int msolve_trace_qq(mpz_param_t *mpz_paramp,
   free_msolve_trace_qq_secondary_data(tmp_mpz_param, trace_det, modulus,
                   prod_crt, result, test, rnum, rden, numer, denom, check_lift,
                   guessed_num, guessed_den, is_lifted, recdata);
+  if (farm.nw > 0) {
+    farm_stop(&farm);
+  }
+  prime_stream_clear(ps);
+  mpz_clear(prod);
+  crt_batch_clear(cb);
+  free(mod_primes);
   return 0;
 }
 
@@ -3751,6 +4926,7 @@ int real_msolve_qq(mpz_param_t *mpz_paramp, param_t **nmod_param, int *dim_ptr,
     -2 if charac is > 0
     -3 if meta data are corrupted
     -4 if bad prime
+    -5 if all primes have been used
   */
 
   double ct0 = cputime();
@@ -3948,6 +5124,10 @@ void manage_output(int b, int dim, int dquot, files_gb *files,
     fprintf(ERRSTREAM, "Problem when checking meta data\n");
     (*mpz_paramp)->dim = -3;
   }
+  if (b == -5) {
+    fprintf(ERRSTREAM, "All primes have been used, no further prime available\n");
+    (*mpz_paramp)->dim = -5;
+  }
 }
 
 int core_msolve(
@@ -5580,6 +6760,7 @@ void msolve_julia(
 
     /* clean up data storage, but do not free data handled by julia */
 
+    free_staircase_cache(&(gens->staircase));
     free(gens);
     gens  = NULL;
 
@@ -38,3 +38,305 @@ uint32_t next_prime(uint32_t n){
   while(!is_prime(cand)) cand++;
   return cand;
 }
+
+/* Stream of 31-bit primes in [min, max) generated by a segmented sieve of
+ * Eratosthenes. The stream starts after a given prime, reaching max it
+ * continues at min and it ends when coming back to where it started, so
+ * no prime is handed out twice. Primes are handed out in batches and each
+ * batch is tested at once for unluckiness: a prime is unlucky if it
+ * divides prod, which is the product of all numbers that must not vanish
+ * modulo the primes used, e.g. the coefficients of the input system. The
+ * test is done via a remainder tree: prod is reduced once modulo the
+ * product of the whole batch, the remainders further down the product
+ * tree of the batch are computed by nthrds threads. */
+#define PRIME_SIEVE_SEGMENT (1 << 16)   /* odd numbers per sieve segment */
+#define PRIME_BATCH 256                 /* primes tested at once */
+#define PRIME_TREE_LEVELS 9             /* levels of the tree of a batch */
+
+typedef struct{
+  uint32_t *bp;       /* odd base primes < 2^16 */
+  uint32_t nbp;
+  uint8_t *seg;       /* sieve of the odd numbers of the current segment */
+  uint32_t *p;        /* current batch of primes */
+  int8_t *unlucky;    /* unlucky[i] == 1 iff p[i] divides prod */
+  uint32_t ld;        /* load of the batch */
+  uint32_t pos;       /* next position in the batch */
+  uint32_t sp;        /* next position in the segment */
+  uint32_t next;      /* first (odd) number of the next segment */
+  uint32_t lo;        /* first (odd) number of the current segment */
+  uint32_t min;       /* the stream continues at min ... */
+  uint32_t max;       /* ... when reaching max ... */
+  uint32_t first;     /* ... and ends when reaching first again */
+  int8_t wrapped;     /* set once the stream continued at min */
+  int8_t exhausted;   /* set once all primes have been handed out */
+  mpz_t *tree[PRIME_TREE_LEVELS]; /* product tree of the current batch */
+  mpz_t *rem[PRIME_TREE_LEVELS];  /* remainders along the tree */
+  uint32_t tlen[PRIME_TREE_LEVELS];
+  uint32_t nl;        /* level of the root */
+  mpz_t prod;
+  int32_t nthrds;
+} prime_stream_t;
+
+static void sieve_next_segment(prime_stream_t *ps){
+  uint32_t i;
+  if(ps->next >= ps->max){
+    if(ps->wrapped){
+      ps->exhausted = 1;
+      return;
+    }
+    ps->wrapped = 1;
+    ps->next = ps->min | 1;
+  }
+  const uint64_t lo = ps->next;
+  const uint64_t hi = lo + 2 * (uint64_t)PRIME_SIEVE_SEGMENT;
+  memset(ps->seg, 1, PRIME_SIEVE_SEGMENT);
+  for(i = 0; i < ps->nbp; i++){
+    const uint64_t q = ps->bp[i];
+    if(q * q >= hi){
+      break;
+    }
+    uint64_t s = q * q;
+    if(s < lo){
+      s = ((lo + q - 1) / q) * q;
+      if((s & 1) == 0){
+        s += q;
+      }
+    }
+    for(; s < hi; s += 2 * q){
+      ps->seg[(s - lo) >> 1] = 0;
+    }
+  }
+  /* 1 is not a prime */
+  if(lo == 1){
+    ps->seg[0] = 0;
+  }
+  ps->lo   = (uint32_t)lo;
+  ps->sp   = 0;
+  ps->next = hi > UINT32_MAX ? UINT32_MAX : (uint32_t)hi;
+}
+
+/* returns the product of v[0], ..., v[n-1] in r, v is overwritten */
+static void mpz_product(mpz_t r, mpz_t *v, const uint64_t n){
+  uint64_t i, m;
+  if(n == 0){
+    mpz_set_ui(r, 1);
+    return;
+  }
+  for(m = n; m > 1; m = (m + 1) / 2){
+    for(i = 0; i + 1 < m; i += 2){
+      mpz_mul(v[i / 2], v[i], v[i + 1]);
+    }
+    if(m & 1){
+      mpz_swap(v[m / 2], v[m - 1]);
+    }
+  }
+  mpz_set(r, v[0]);
+}
+
+/* product tree of the primes of the current batch, level 0 holds the
+ * primes themselves */
+static void prime_stream_build_tree(prime_stream_t *ps){
+  uint32_t i, l;
+  for(i = 0; i < ps->ld; i++){
+    mpz_set_ui(ps->tree[0][i], ps->p[i]);
+  }
+  ps->tlen[0] = ps->ld;
+  for(l = 0; ps->tlen[l] > 1; l++){
+    ps->tlen[l + 1] = (ps->tlen[l] + 1) / 2;
+    for(i = 0; i < ps->tlen[l + 1]; i++){
+      if(2 * i + 1 < ps->tlen[l]){
+        mpz_mul(ps->tree[l + 1][i], ps->tree[l][2 * i], ps->tree[l][2 * i + 1]);
+      }
+      else{
+        mpz_set(ps->tree[l + 1][i], ps->tree[l][2 * i]);
+      }
+    }
+  }
+  ps->nl = l;
+}
+
+/* sets unlucky[i] to 1 for all primes p[i] not yet handed out which
+ * divide a, a is reduced only once modulo the product of the batch */
+static void prime_stream_test_batch(prime_stream_t *ps, const mpz_t a){
+  uint32_t l;
+  if(ps->pos == ps->ld || mpz_cmp_ui(a, 1) == 0){
+    return;
+  }
+  mpz_fdiv_r(ps->rem[ps->nl][0], a, ps->tree[ps->nl][0]);
+  for(l = ps->nl; l > 0; l--){
+    const uint32_t len = ps->tlen[l - 1];
+#pragma omp parallel for num_threads(ps->nthrds) schedule(static)
+    for(uint32_t i = 0; i < len; i++){
+      mpz_fdiv_r(ps->rem[l - 1][i], ps->rem[l][i / 2], ps->tree[l - 1][i]);
+    }
+  }
+  for(uint32_t i = ps->pos; i < ps->ld; i++){
+    if(mpz_sgn(ps->rem[0][i]) == 0){
+      ps->unlucky[i] = 1;
+    }
+  }
+}
+
+static void prime_stream_fill_batch(prime_stream_t *ps){
+  ps->ld  = 0;
+  ps->pos = 0;
+  while(ps->ld < PRIME_BATCH && ps->exhausted == 0){
+    if(ps->sp == PRIME_SIEVE_SEGMENT){
+      sieve_next_segment(ps);
+      continue;
+    }
+    for(; ps->sp < PRIME_SIEVE_SEGMENT && ps->ld < PRIME_BATCH; ps->sp++){
+      if(ps->seg[ps->sp]){
+        const uint32_t q = ps->lo + 2 * ps->sp;
+        if(ps->wrapped && q >= ps->first){
+          ps->exhausted = 1;
+          break;
+        }
+        if(q >= ps->max){
+          ps->sp = PRIME_SIEVE_SEGMENT;
+          ps->next = ps->max;
+          break;
+        }
+        if(q >= ps->min){
+          ps->p[ps->ld++] = q;
+        }
+      }
+    }
+  }
+  if(ps->ld == 0){
+    return;
+  }
+  memset(ps->unlucky, 0, ps->ld * sizeof(int8_t));
+  prime_stream_build_tree(ps);
+  prime_stream_test_batch(ps, ps->prod);
+}
+
+/* the stream starts with the first prime larger than start, primes are
+ * taken from [min, max) with 2 < min < max <= 2^31 */
+void prime_stream_init(prime_stream_t *ps, const uint32_t start,
+                       const uint32_t min, const uint32_t max,
+                       const int32_t nthrds){
+  uint32_t i, j, l;
+  uint8_t *s = (uint8_t *)calloc(1 << 16, sizeof(uint8_t));
+
+  ps->bp  = (uint32_t *)malloc(6542 * sizeof(uint32_t));
+  ps->nbp = 0;
+  for(i = 3; i < (1 << 16); i += 2){
+    if(s[i] == 0){
+      ps->bp[ps->nbp++] = i;
+      for(j = i * i; j < (1 << 16); j += 2 * i){
+        s[j] = 1;
+      }
+    }
+  }
+  free(s);
+  ps->seg     = (uint8_t *)malloc(PRIME_SIEVE_SEGMENT * sizeof(uint8_t));
+  ps->p       = (uint32_t *)malloc(PRIME_BATCH * sizeof(uint32_t));
+  ps->unlucky = (int8_t *)malloc(PRIME_BATCH * sizeof(int8_t));
+  for(l = 0, j = PRIME_BATCH; l < PRIME_TREE_LEVELS; l++, j = (j + 1) / 2){
+    ps->tree[l] = (mpz_t *)malloc(j * sizeof(mpz_t));
+    ps->rem[l]  = (mpz_t *)malloc(j * sizeof(mpz_t));
+    for(i = 0; i < j; i++){
+      mpz_init(ps->tree[l][i]);
+      mpz_init(ps->rem[l][i]);
+    }
+  }
+  ps->min       = min;
+  ps->max       = max;
+  ps->nthrds    = nthrds > 0 ? nthrds : 1;
+  ps->wrapped   = 0;
+  ps->exhausted = 0;
+  mpz_init_set_ui(ps->prod, 1);
+
+  ps->next  = (start + 1) | 1;
+  if(ps->next < min || ps->next >= max){
+    ps->next  = min | 1;
+  }
+  ps->first = ps->next;
+  sieve_next_segment(ps);
+  ps->ld  = 0;
+  ps->pos = 0;
+}
+
+void prime_stream_clear(prime_stream_t *ps){
+  uint32_t i, j, l;
+  free(ps->bp);
+  free(ps->seg);
+  free(ps->p);
+  free(ps->unlucky);
+  for(l = 0, j = PRIME_BATCH; l < PRIME_TREE_LEVELS; l++, j = (j + 1) / 2){
+    for(i = 0; i < j; i++){
+      mpz_clear(ps->tree[l][i]);
+      mpz_clear(ps->rem[l][i]);
+    }
+    free(ps->tree[l]);
+    free(ps->rem[l]);
+  }
+  mpz_clear(ps->prod);
+}
+
+/* multiplies the product the primes must not divide by f, the primes of
+ * the current batch only need to be tested against f */
+void prime_stream_mul_product(prime_stream_t *ps, const mpz_t f){
+  mpz_mul(ps->prod, ps->prod, f);
+  prime_stream_test_batch(ps, f);
+}
+
+/* returns the next lucky prime of the stream, returns 0 once all primes
+ * of the stream have been handed out */
+uint32_t prime_stream_next(prime_stream_t *ps){
+  while(1){
+    if(ps->pos == ps->ld){
+      prime_stream_fill_batch(ps);
+      if(ps->ld == 0){
+        return 0;
+      }
+    }
+    const uint32_t q = ps->p[ps->pos];
+    if(ps->unlucky[ps->pos++] == 0){
+      return q;
+    }
+  }
+}
+
+/* product of all coefficients of the input system, i.e. the primes
+ * dividing it are exactly those detected by is_lucky_prime_ui */
+void lucky_primes_product_of_input(mpz_t prod, const bs_t * const bs){
+  len_t i, j;
+  uint64_t n = 0;
+
+  for(i = 0; i < bs->ld; i++){
+    n += bs->hm[i][LENGTH];
+  }
+  mpz_t *v = (mpz_t *)malloc((n > 0 ? n : 1) * sizeof(mpz_t));
+  n = 0;
+  for(i = 0; i < bs->ld; i++){
+    const mpz_t *cf = bs->cf_qq[bs->hm[i][COEFFS]];
+    for(j = 0; j < bs->hm[i][LENGTH]; j++){
+      mpz_init_set(v[n++], cf[j]);
+    }
+  }
+  mpz_product(prod, v, n);
+  mpz_abs(prod, prod);
+  for(uint64_t k = 0; k < n; k++){
+    mpz_clear(v[k]);
+  }
+  free(v);
+}
+
+/* product of the denominators of the lifted multiplication matrix */
+void lucky_primes_product_of_matrix_denominators(mpz_t prod,
+        const trace_det_fglm_mat_t trace_det){
+  uint32_t i;
+  mpz_t *v = (mpz_t *)malloc((trace_det->nrows > 0 ? trace_det->nrows : 1)
+                             * sizeof(mpz_t));
+  for(i = 0; i < trace_det->nrows; i++){
+    mpz_init_set(v[i], trace_det->mat_denoms[i]);
+  }
+  mpz_product(prod, v, trace_det->nrows);
+  mpz_abs(prod, prod);
+  for(i = 0; i < trace_det->nrows; i++){
+    mpz_clear(v[i]);
+  }
+  free(v);
+}
@@ -191,6 +191,7 @@ static void convert_hashes_to_columns_sat(
     /* compute density of matrix */
     nterms  *=  100; /* for percentage */
     double density = (double)nterms / (double)mnr / (double)mat->nc;
+    mat->density   = density;
 
     /* timings */
     ct1 = cputime();
@@ -415,6 +416,7 @@ static void convert_hashes_to_columns(
     /* compute density of matrix */
     nterms  *=  100; /* for percentage */
     double density = (double)nterms / (double)mnr / (double)ld;
+    mat->density   = density;
 
     /* timings */
     ct1 = cputime();
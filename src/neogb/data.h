@@ -199,6 +199,26 @@ struct bs_t
                        the denominator is 1) */
 };
 
+/* bump allocator for data which only lives as long as the current
+ * matrix, e.g. rows that are not yet fully reduced. Chunks are kept
+ * between rounds, only the loads are reset. */
+#define ARENA_CHUNK_SIZE ((uint64_t)1 << 22)
+
+/* automatic linear algebra choice: matrices with a higher density (in
+ * percent) get their new pivots reduced densely as long as the dense
+ * part has at most LA_AUTO_MAX_DENSE entries */
+#define LA_AUTO_DENSITY 30.0
+#define LA_AUTO_MAX_DENSE ((uint64_t)1 << 28)
+typedef struct arena_t arena_t;
+struct arena_t
+{
+    char **ch;      /* memory chunks */
+    uint64_t *csz;  /* size of each chunk */
+    len_t nch;      /* number of chunks allocated */
+    len_t cc;       /* index of current chunk */
+    uint64_t ld;    /* load of current chunk */
+};
+
 /* matrix stuff */
 typedef struct mat_t mat_t;
 struct mat_t
@@ -229,6 +249,10 @@ struct mat_t
     len_t ncr;          /* number of right columns (in ABCD splicing) */
     len_t rbal;         /* length of reducer binary array */
     deg_t cd;           /* current degree */
+    double density;     /* percentage of nonzero entries */
+    arena_t *ar;        /* one arena per thread for temporary rows */
+    len_t nar;          /* number of arenas */
+    int32_t ua;         /* 1 if new rows are allocated in the arenas */
 };
 
 /* signature matrix stuff, stores information from previous and current step */
@@ -369,6 +393,7 @@ struct md_t
 
     int64_t num_pairsred;
     int64_t num_gb_crit;
+    int64_t num_hilbert_pruned;
     int64_t num_syz_crit;
     int64_t num_rew_crit;
     int64_t num_redundant_old;
@@ -392,6 +417,10 @@ struct md_t
     int32_t nev; /* number of elimination variables */
     int32_t mo; /* monomial ordering: 0=DRL, 1=LEX*/
     int32_t laopt;
+    double la_cost[4];  /* automatic linear algebra choice: last measured
+                         * time per lower row and column for the options
+                         * 1, 2, 42 and 44, 0 if not yet used */
+    double la_zero;     /* ratio of zero reductions in the last matrix */
     int32_t init_hts;
     int32_t nthrds;
     int32_t reset_ht;
@@ -431,6 +460,45 @@ struct md_t
     int32_t print_gb;
     int32_t truncate_lifting;
 
+    /* Hilbert driven pair pruning for homogeneous input: the values
+     * of the Hilbert function of the leading ideal from the first
+     * (learning) computation in degrees 0,...,hf_deg, where hf_deg
+     * is the maximal degree of a lead term */
+    int32_t hilbert_driven;
+    deg_t hf_deg;
+    uint64_t *hf;
+    /* set once a computation modulo another prime, without pruning,
+     * got the same Hilbert function, only then pairs are pruned */
+    int32_t hf_validated;
+    /* Hilbert function of the current leading ideal, recomputed only
+     * if the basis load hf_cur_ld has changed since */
+    uint64_t *hf_cur;
+    len_t hf_cur_ld;
+    /* set if the Hilbert function of a finished degree differs from
+     * the learned one, no more pruning is done then */
+    int32_t hf_mismatch;
+
+    /* elements of the reduced basis read by FGLM in the multi-modular
+     * loop, with fglm_nf_needed_len elements, see set_needed_normal_forms,
+     * never set if print_gb != 0 */
+    int8_t *fglm_nf_needed;
+    len_t fglm_nf_needed_len;
+    /* if not NULL, the final reduction of an application phase only
+     * reduces the tails of the elements at the positions i of the final
+     * basis (sorted by increasing lead terms) for which nf_needed[i] != 0,
+     * the others are kept as they are. It points to fglm_nf_needed only
+     * while secondary_modular_steps runs F4. */
+    int8_t *nf_needed;
+    len_t nf_needed_len;
+
+    /* if not NULL, F4 stops with error 3 before its next round once
+     * *cancel is not zero, e.g. when another run made it obsolete */
+    int32_t *cancel;
+
+    /* minimal dimension of the quotient for block Wiedemann sequences
+     * in FGLM, 0 for the default BLOCKWIED_MIN_DIM */
+    int32_t bw_min_dim;
+
     /* for f4sat */
     uint32_t new_multipliers;
     uint32_t nr_kernel_elts;
@@ -19,6 +19,7 @@
  * Mohab Safey El Din */
 
 
+#include <assert.h>
 #include "f4.h"
 #include "../msolve/streams.h"
 
@@ -132,6 +133,20 @@ static void clear_matrix(
     mat->cf_qq  = NULL;
     free(mat->cf_ab_qq);
     mat->cf_ab_qq  = NULL;
+    /* all temporary rows of this round are gone, keep the arena
+     * chunks for the next round */
+    reset_matrix_arenas(mat);
+}
+
+static void free_matrix(
+        mat_t **matp
+        )
+{
+    mat_t *mat  = *matp;
+    free_matrix_arenas(mat);
+    free(mat);
+    mat = NULL;
+    *matp = mat;
 }
 
 #if 0
@@ -357,6 +372,11 @@ static int32_t initialize_f4(
     md->fc  = fc;
     md->hcm = (hi_t *)malloc(sizeof(hi_t));
 
+    /* a learned Hilbert function some prime disagreed with is not used */
+    if (md->hilbert_driven == 0) {
+        md->hf  = NULL;
+    }
+
     if (gmd->fc != fc) {
         if (gmd->f4_qq_round != 2) {
             reset_function_pointers(fc, md->laopt);
@@ -565,6 +585,281 @@ static void process_redundant_elements(
     }
 }
 
+static int basis_element_lead_cmp(
+        const void *a,
+        const void *b,
+        void *htp
+        )
+{
+    const hm_t ha = ((hm_t **)a)[0][OFFSET];
+    const hm_t hb = ((hm_t **)b)[0][OFFSET];
+
+    return monomial_cmp(ha, hb, (ht_t *)htp);
+}
+
+static int basis_position_lead_cmp(
+        const void *a,
+        const void *b,
+        void *bsp
+        )
+{
+    const bs_t * const bs = (bs_t *)bsp;
+    const hm_t ha = bs->hm[bs->lmps[*((len_t *)a)]][OFFSET];
+    const hm_t hb = bs->hm[bs->lmps[*((len_t *)b)]][OFFSET];
+
+    return monomial_cmp(ha, hb, bs->ht);
+}
+
+/* marks the elements of the basis whose tails need not be reduced,
+ * i.e. the ones which are not requested in md->nf_needed, only done
+ * when applying a trace as the basis is not fully reduced then */
+static int8_t *final_basis_elements_not_needed(
+        const bs_t * const bs,
+        const md_t * const md
+        )
+{
+    const len_t lml = bs->lml;
+
+    assert(md->print_gb == 0 || md->nf_needed == NULL);
+    if (md->nf_needed == NULL || md->nf_needed_len != lml
+            || md->trace_level != APPLY_TRACER || md->print_gb != 0) {
+        return NULL;
+    }
+    len_t *ord = (len_t *)malloc((unsigned long)lml * sizeof(len_t));
+    for (len_t i = 0; i < lml; ++i) {
+        ord[i] = i;
+    }
+    sort_r(ord, (unsigned long)lml, sizeof(len_t),
+            basis_position_lead_cmp, (void *)bs);
+    int8_t *skip = (int8_t *)calloc((unsigned long)lml, sizeof(int8_t));
+    for (len_t i = 0; i < lml; ++i) {
+        skip[ord[i]] = (md->nf_needed[i] == 0);
+    }
+    free(ord);
+
+    return skip;
+}
+
+/* Each element generated by F4 has a tail which is already reduced w.r.t.
+ * the lead terms known at the time it was generated. Thus, only elements
+ * whose tails contain a monomial divisible by the lead term of a newer
+ * non-redundant element have to be reduced (resp. input elements which
+ * are never reduced). We only put these elements into the final matrix,
+ * all other elements enter it only as reducers during symbolic
+ * preprocessing. Finally, all elements are sorted by increasing lead terms, so the
+ * result is the same as for a full reduction of the basis.
+ * Only done over finite fields, there the elements are monic. */
+static void reduce_final_basis_incrementally(
+        bs_t *bs,
+        mat_t *mat,
+        md_t *md
+        )
+{
+    len_t i, j, k;
+
+    ht_t *bht   = bs->ht;
+    ht_t *sht   = md->ht;
+
+    const len_t lml = bs->lml;
+    const bl_t * const lmps = bs->lmps;
+
+    /* lmps is increasing, so the elements newer than lmps[i] are exactly
+     * the ones at positions k > i */
+    for (i = 1; i < lml; ++i) {
+        assert(lmps[i-1] < lmps[i]);
+    }
+
+    /* find elements whose tails are not reduced, skipping the ones
+     * not needed afterwards */
+    int8_t *skip  = final_basis_elements_not_needed(bs, md);
+    int8_t *dirty = (int8_t *)calloc((unsigned long)lml, sizeof(int8_t));
+#pragma omp parallel for num_threads(md->nthrds) \
+    private(i, j, k) schedule(dynamic)
+    for (i = 0; i < lml; ++i) {
+        const hm_t * const b  = bs->hm[lmps[i]];
+        if (skip != NULL && skip[i] == 1) {
+            continue;
+        }
+        if (lmps[i] < (bl_t)md->ngens) {
+            dirty[i]  = 1;
+            continue;
+        }
+        const len_t len = b[LENGTH]+OFFSET;
+        for (j = OFFSET+1; j < len && dirty[i] == 0; ++j) {
+            const sdm_t ns  = ~bht->hd[b[j]].sdm;
+            for (k = i+1; k < lml; ++k) {
+                if (!(bs->lm[k] & ns)
+                        && check_monomial_division(
+                            b[j], bs->hm[lmps[k]][OFFSET], bht)) {
+                    dirty[i]  = 1;
+                    break;
+                }
+            }
+        }
+    }
+    free(skip);
+
+    /* worklist of the positions in lmps of the elements to be reduced */
+    len_t nd  = 0;
+    len_t *dl = (len_t *)malloc((unsigned long)lml * sizeof(len_t));
+    for (i = 0; i < lml; ++i) {
+        if (dirty[i] == 1) {
+            dl[nd++]  = i;
+        }
+    }
+    free(dirty);
+
+    if (md->info_level > 1) {
+        fprintf(VERBSTREAM, "reduce final basis ");
+        fflush(VERBSTREAM);
+    }
+    const len_t bl  = bs->ld;
+    if (nd > 0) {
+        /* add all non-reduced basis elements as matrix rows */
+        mat->tr = (hm_t **)malloc((unsigned long)nd * sizeof(hm_t *));
+        for (i = 0; i < nd; ++i) {
+            mat->tr[i] = poly_to_matrix_row(sht, bht, bs->hm[lmps[dl[i]]]);
+            sht->hd[mat->tr[i][OFFSET]].idx  = 1;
+        }
+        mat->nr = mat->nrl = mat->sz = nd;
+        mat->nc = 0;
+
+        symbolic_preprocessing(mat, bs, md);
+        /* no known pivots, we need mat->ncl = 0, so set all indices to 1 */
+        for (i = 0; i < sht->eld; ++i) {
+            sht->hd[i].idx = 1;
+        }
+        convert_hashes_to_columns(mat, md, sht);
+        mat->nc = mat->ncl + mat->ncr;
+
+        sort_matrix_rows_decreasing(mat->rr, mat->nru);
+        sort_matrix_rows_increasing(mat->tr, mat->nrl);
+
+        exact_linear_algebra(mat, bs, bs, md);
+
+        /* the reducer rows are not reused in the final reduction step,
+         * their coefficients still belong to the basis elements */
+        for (i = 0; i < mat->nru; ++i) {
+            free(mat->rr[i]);
+        }
+
+        /* reduced elements are appended to the basis */
+        convert_sparse_matrix_rows_to_basis_elements(
+            0, mat, bs, bht, sht, md);
+        bs->ld  +=  mat->np;
+        clear_matrix(mat);
+    } else {
+        if (md->info_level > 1) {
+            fprintf(VERBSTREAM, "%60s", "no tails to reduce");
+            fflush(VERBSTREAM);
+        }
+    }
+    /* each dirty element is replaced by exactly one reduced element, the
+     * reduced ones are appended at positions bl, ..., bl+nd-1 */
+    const len_t ld  = bl + nd;
+    assert(bs->ld == ld);
+
+    /* collect the final elements, remove all others, note that
+     * bs->lmps might have been reallocated when adding new elements */
+    int8_t *keep  = (int8_t *)calloc((unsigned long)ld, sizeof(int8_t));
+    for (i = 0; i < lml; ++i) {
+        keep[bs->lmps[i]] = 1;
+    }
+    for (i = 0; i < nd; ++i) {
+        keep[bs->lmps[dl[i]]] = 0;
+    }
+    for (i = bl; i < ld; ++i) {
+        keep[i] = 1;
+    }
+    free(dl);
+    hm_t **hm = (hm_t **)malloc((unsigned long)lml * sizeof(hm_t *));
+    for (i = 0, j = 0; i < ld; ++i) {
+        if (keep[i] == 1) {
+            hm[j++] = bs->hm[i];
+        } else {
+            /* coefficient arrays are indexed via COEFFS */
+            if (bs->hm[i] != NULL) {
+                const len_t ci  = bs->hm[i][COEFFS];
+                switch (md->ff_bits) {
+                    case 8:
+                        free(bs->cf_8[ci]);
+                        bs->cf_8[ci]  = NULL;
+                        break;
+                    case 16:
+                        free(bs->cf_16[ci]);
+                        bs->cf_16[ci] = NULL;
+                        break;
+                    case 32:
+                    default:
+                        free(bs->cf_32[ci]);
+                        bs->cf_32[ci] = NULL;
+                        break;
+                }
+                free(bs->hm[i]);
+            }
+        }
+        bs->hm[i] = NULL;
+    }
+    assert(j == lml);
+    sort_r(hm, (unsigned long)lml, sizeof(hm_t *),
+            basis_element_lead_cmp, bht);
+
+    /* coefficient arrays are indexed via COEFFS */
+    void **cf = (void **)malloc((unsigned long)lml * sizeof(void *));
+    for (i = 0; i < lml; ++i) {
+        switch (md->ff_bits) {
+            case 8:
+                cf[i] = bs->cf_8[hm[i][COEFFS]];
+                break;
+            case 16:
+                cf[i] = bs->cf_16[hm[i][COEFFS]];
+                break;
+            case 32:
+            default:
+                cf[i] = bs->cf_32[hm[i][COEFFS]];
+                break;
+        }
+    }
+    for (i = 0; i < lml; ++i) {
+        switch (md->ff_bits) {
+            case 8:
+                bs->cf_8[i]   = (cf8_t *)cf[i];
+                break;
+            case 16:
+                bs->cf_16[i]  = (cf16_t *)cf[i];
+                break;
+            case 32:
+            default:
+                bs->cf_32[i]  = (cf32_t *)cf[i];
+                break;
+        }
+        bs->hm[i]         = hm[i];
+        bs->hm[i][COEFFS] = i;
+        bs->red[i]        = 0;
+        bs->lmps[i]       = i;
+        bs->lm[i]         = bht->hd[bs->hm[i][OFFSET]].sdm;
+    }
+    for (i = lml; i < ld; ++i) {
+        switch (md->ff_bits) {
+            case 8:
+                bs->cf_8[i]   = NULL;
+                break;
+            case 16:
+                bs->cf_16[i]  = NULL;
+                break;
+            case 32:
+            default:
+                bs->cf_32[i]  = NULL;
+                break;
+        }
+    }
+    bs->ld = bs->lml = lml;
+
+    free(cf);
+    free(hm);
+    free(keep);
+}
+
 static void reduce_final_basis(
         bs_t *bs,
         mat_t *mat,
@@ -579,6 +874,17 @@ static void reduce_final_basis(
         ct = cputime();
         rt = realtime();
 
+        if (md->ff_bits != 0 && md->nf == 0) {
+            reduce_final_basis_incrementally(bs, mat, md);
+
+            md->in_final_reduction_step = 0;
+
+            /* timings */
+            print_round_timings(VERBSTREAM, md, rt, ct);
+            print_round_information_footer(VERBSTREAM, md);
+            return;
+        }
+
         len_t i;
 
         ht_t *bht   = bs->ht;
@@ -641,8 +947,7 @@ static void free_local_data(
 {
     free_meta_data(mdp);
 
-    free(*matp);
-    *matp = NULL;
+    free_matrix(matp);
 }
 
 static void finalize_f4(
@@ -663,6 +968,17 @@ static void finalize_f4(
         gmd->trace_level = APPLY_TRACER;
     }
     gmd->min_deg_in_first_deg_fall = (*lmdp)->min_deg_in_first_deg_fall;
+    if (gmd->hf == NULL) {
+        gmd->hf     = (*lmdp)->hf;
+        gmd->hf_deg = (*lmdp)->hf_deg;
+    }
+    if ((*lmdp)->hf_validated == 1) {
+        gmd->hf_validated = 1;
+    }
+    /* drop the learned Hilbert function for all upcoming computations */
+    if ((*lmdp)->hf_mismatch == 1) {
+        gmd->hilbert_driven = 0;
+    }
     free_local_data(matp, lmdp);
 }
 
@@ -696,6 +1012,15 @@ bs_t *core_f4(
     /* reset error */
     *errp = 0;
     while (!done) {
+        if (md->cancel != NULL) {
+            int32_t cancel;
+#pragma omp atomic read
+            cancel = *(md->cancel);
+            if (cancel != 0) {
+                *errp = 3;
+                break;
+            }
+        }
         rrt = realtime();
         crt = cputime();
         md->max_bht_size = md->max_bht_size > bs->ht->esz ?
@@ -713,13 +1038,43 @@ bs_t *core_f4(
         print_round_timings(VERBSTREAM, md, rrt, crt);
     }
     if (*errp > 0) {
-        free_basis_and_only_local_hash_table_data(&bs);
+        /* in learning rounds the hash table is the one of gbs */
+        if (bs->ht == gbs->ht) {
+            free_basis_without_hash_table(&bs);
+        } else {
+            free_basis_and_only_local_hash_table_data(&bs);
+        }
+        /* a trace learned so far is of no use */
+        if (md->trace_level == LEARN_TRACER) {
+            free_trace(&(md->tr));
+        }
+        free_local_data(&mat, &md);
     } else {
         print_round_information_footer(VERBSTREAM, md);
 
         /* remove possible redudant elements */
         process_redundant_elements(bs, md);
 
+        /* learn the Hilbert function of the leading ideal for
+         * pruning pairs in upcoming computations, the first of
+         * them does not prune but validates the learned one */
+        if (md->hilbert_driven == 1 && md->hf_mismatch == 0
+                && md->homogeneous == 1 && md->mo == 0 && md->nev == 0
+                && md->trace_level != APPLY_TRACER) {
+            if (md->hf == NULL) {
+                md->hf_deg  = maximal_lead_term_degree(bs);
+                md->hf      = hilbert_function_of_leading_ideal(bs, md->hf_deg);
+            } else {
+                if (md->hf_validated == 0) {
+                    if (learned_hilbert_function_is_confirmed(bs, md)) {
+                        md->hf_validated  = 1;
+                    } else {
+                        md->hf_mismatch   = 1;
+                    }
+                }
+            }
+        }
+
         /* reduce final basis? */
         reduce_final_basis(bs, mat, md);
 
@@ -761,7 +761,7 @@ end_sat_step:
     /* note that all rows kept from mat during the overall computation are
      * basis elements and thus we do not need to free the rows itself, but
      * just the matrix structure */
-    free(mat);
+    free_matrix(&mat);
     if (sht != NULL) {
         free_hash_table(&sht);
     }
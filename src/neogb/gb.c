@@ -41,6 +41,7 @@
 #include "la_qq.c"    /* rational linear algebra */
 #include "update.c"   /* update process and pairset handling */
 #include "convert.c"  /* conversion between hashes and column indices*/
+#include "hilbert.c"  /* hilbert series of leading ideals */
 #include "symbol.c"   /* symbolic preprocessing */
 #include "io.c"       /* input and output data handling */
 #include "engine.c"   /* global, shared parts of gb engine */
@@ -0,0 +1,330 @@
+/* This file is part of msolve.
+ *
+ * msolve is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * msolve is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with msolve.  If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors:
+ * Jérémy Berthomieu
+ * Christian Eder
+ * Mohab Safey El Din */
+
+
+#include "data.h"
+#include "hilbert.h"
+
+/* Hilbert series of monomial ideals: For a monomial ideal I in n variables
+ * the Hilbert series of R/I is N(t)/(1-t)^n. We compute the numerator N(t)
+ * recursively via Bigatti's pivot rule
+ *
+ *     N(I) = N(I + <p>) + t^deg(p) * N(I : p)
+ *
+ * where the pivot p = x^e is a power of a variable x dividing at least two
+ * minimal generators of I, e being the median of the exponents of x in
+ * these generators. If there is no such variable the generators are
+ * pairwise coprime and N(I) is the product of all (1 - t^deg(m)).
+ *
+ * All coefficients are computed modulo 2^64, so values of the Hilbert
+ * function are exact as long as they fit into 63 bits, which is always
+ * the case for the degrees and numbers of variables we can handle. */
+
+/* monomials are stored as consecutive exponent vectors of length nv,
+ * removes all non-minimal generators in place, returns the new number
+ * of generators */
+static len_t minimize_monomial_generators(
+        int32_t *m,
+        const len_t nm,
+        const len_t nv
+        )
+{
+    len_t i, j, k;
+
+    int8_t *red = (int8_t *)calloc((unsigned long)nm, sizeof(int8_t));
+
+    for (i = 0; i < nm; ++i) {
+        const int32_t * const a = m + (unsigned long)i * nv;
+        for (j = 0; j < nm; ++j) {
+            if (i == j || red[j] == 1) {
+                continue;
+            }
+            const int32_t * const b = m + (unsigned long)j * nv;
+            for (k = 0; k < nv; ++k) {
+                if (b[k] > a[k]) {
+                    break;
+                }
+            }
+            /* b divides a, for equal monomials keep the first one */
+            if (k == nv) {
+                for (k = 0; k < nv; ++k) {
+                    if (b[k] != a[k]) {
+                        break;
+                    }
+                }
+                if (k < nv || j < i) {
+                    red[i] = 1;
+                    break;
+                }
+            }
+        }
+    }
+    for (i = 0, j = 0; i < nm; ++i) {
+        if (red[i] == 0) {
+            if (i != j) {
+                memcpy(m + (unsigned long)j * nv, m + (unsigned long)i * nv,
+                        (unsigned long)nv * sizeof(int32_t));
+            }
+            ++j;
+        }
+    }
+    free(red);
+
+    return j;
+}
+
+static int cmp_exponents(
+        const void *a,
+        const void *b
+        )
+{
+    const int32_t ea = *((const int32_t *)a);
+    const int32_t eb = *((const int32_t *)b);
+
+    return (ea > eb) - (ea < eb);
+}
+
+/* returns the coefficients of the numerator of the Hilbert series of
+ * R/<m>, *dp is set to its degree, the generators in m must be minimal */
+static uint64_t *hilbert_series_numerator(
+        const int32_t *m,
+        const len_t nm,
+        const len_t nv,
+        deg_t *dp
+        )
+{
+    len_t i, j, k;
+    deg_t d, e;
+    uint64_t *num;
+
+    if (nm == 0) {
+        num     = (uint64_t *)calloc(1, sizeof(uint64_t));
+        num[0]  = 1;
+        *dp     = 0;
+        return num;
+    }
+
+    /* choose the variable dividing most generators as pivot */
+    len_t piv = 0, mc = 0;
+    for (k = 0; k < nv; ++k) {
+        len_t ctr = 0;
+        for (i = 0; i < nm; ++i) {
+            ctr += m[(unsigned long)i * nv + k] > 0;
+        }
+        if (ctr > mc) {
+            mc  = ctr;
+            piv = k;
+        }
+    }
+
+    if (mc < 2) {
+        /* pairwise coprime generators */
+        d   = 0;
+        for (i = 0; i < (unsigned long)nm * nv; ++i) {
+            d +=  m[i];
+        }
+        num     = (uint64_t *)calloc((unsigned long)d + 1, sizeof(uint64_t));
+        num[0]  = 1;
+        d       = 0;
+        for (i = 0; i < nm; ++i) {
+            e = 0;
+            for (k = 0; k < nv; ++k) {
+                e +=  m[(unsigned long)i * nv + k];
+            }
+            /* constant generator, i.e. R/I = 0 */
+            if (e == 0) {
+                memset(num, 0, ((unsigned long)d + 1) * sizeof(uint64_t));
+                break;
+            }
+            /* multiply by 1 - t^e */
+            for (j = d + 1; j > 0; --j) {
+                num[j - 1 + e] -=  num[j - 1];
+            }
+            d +=  e;
+        }
+        *dp = d;
+        return num;
+    }
+
+    /* pivot exponent: median of the positive exponents of x, it has to
+     * stay below the exponent of the pure power of x in I, if any, so that
+     * x^e is not in I */
+    int32_t *ex = (int32_t *)malloc((unsigned long)mc * sizeof(int32_t));
+    int32_t pp  = 0;
+    for (i = 0, j = 0; i < nm; ++i) {
+        const int32_t * const a = m + (unsigned long)i * nv;
+        if (a[piv] > 0) {
+            ex[j++] = a[piv];
+            for (k = 0; k < nv; ++k) {
+                if (k != piv && a[k] != 0) {
+                    break;
+                }
+            }
+            if (k == nv) {
+                pp  = a[piv];
+            }
+        }
+    }
+    qsort(ex, mc, sizeof(int32_t), cmp_exponents);
+    int32_t pe  = ex[(mc - 1) / 2];
+    free(ex);
+    if (pp > 0 && pe >= pp) {
+        pe  = pp - 1;
+    }
+
+    /* I + <x^e>: generators not divisible by x^e together with x^e */
+    int32_t *ma = (int32_t *)malloc(
+            (unsigned long)(nm + 1) * nv * sizeof(int32_t));
+    for (i = 0, j = 0; i < nm; ++i) {
+        if (m[(unsigned long)i * nv + piv] < pe) {
+            memcpy(ma + (unsigned long)j * nv, m + (unsigned long)i * nv,
+                    (unsigned long)nv * sizeof(int32_t));
+            ++j;
+        }
+    }
+    memset(ma + (unsigned long)j * nv, 0, (unsigned long)nv * sizeof(int32_t));
+    ma[(unsigned long)j * nv + piv] = pe;
+    const len_t nma = j + 1;
+
+    /* I : x^e */
+    int32_t *mq = (int32_t *)malloc((unsigned long)nm * nv * sizeof(int32_t));
+    memcpy(mq, m, (unsigned long)nm * nv * sizeof(int32_t));
+    for (i = 0; i < nm; ++i) {
+        const int32_t a = mq[(unsigned long)i * nv + piv];
+        mq[(unsigned long)i * nv + piv] = a > pe ? a - pe : 0;
+    }
+    const len_t nmq = minimize_monomial_generators(mq, nm, nv);
+
+    deg_t da, dq;
+    uint64_t *na  = hilbert_series_numerator(ma, nma, nv, &da);
+    free(ma);
+    uint64_t *nq  = hilbert_series_numerator(mq, nmq, nv, &dq);
+    free(mq);
+
+    d   = da > dq + pe ? da : dq + pe;
+    num = (uint64_t *)calloc((unsigned long)d + 1, sizeof(uint64_t));
+    for (e = 0; e <= da; ++e) {
+        num[e]  +=  na[e];
+    }
+    for (e = 0; e <= dq; ++e) {
+        num[e+pe] +=  nq[e];
+    }
+    free(na);
+    free(nq);
+
+    *dp = d;
+    return num;
+}
+
+uint64_t *hilbert_series_numerator_of_monomials(
+        const int32_t *lm,
+        const len_t nm,
+        const len_t nv,
+        deg_t *dp
+        )
+{
+    int32_t *m  = (int32_t *)malloc((unsigned long)(nm + 1) * nv * sizeof(int32_t));
+    memcpy(m, lm, (unsigned long)nm * nv * sizeof(int32_t));
+    const len_t nmm = minimize_monomial_generators(m, nm, nv);
+
+    uint64_t *num = hilbert_series_numerator(m, nmm, nv, dp);
+    free(m);
+
+    return num;
+}
+
+/* returns the values of the Hilbert function of R/L in degrees 0,...,d
+ * where L is the ideal generated by the lead terms of the (minimal) basis */
+static uint64_t *hilbert_function_of_leading_ideal(
+        const bs_t * const bs,
+        const deg_t d
+        )
+{
+    len_t i, j, k;
+    deg_t e, nd;
+
+    const ht_t * const ht = bs->ht;
+    const len_t nv  = ht->nv;
+    const len_t evl = ht->evl;
+    const len_t ebl = ht->ebl;
+    const len_t lml = bs->lml;
+
+    int32_t *m  = (int32_t *)malloc((unsigned long)lml * nv * sizeof(int32_t));
+    for (i = 0, j = 0; i < lml; ++i) {
+        const exp_t * const ev = ht->ev[bs->hm[bs->lmps[i]][OFFSET]];
+        for (k = 1; k < ebl; ++k) {
+            m[j++]  = (int32_t)ev[k];
+        }
+        for (k = ebl+1; k < evl; ++k) {
+            m[j++]  = (int32_t)ev[k];
+        }
+    }
+    uint64_t *num = hilbert_series_numerator_of_monomials(m, lml, nv, &nd);
+    free(m);
+
+    /* expand N(t)/(1-t)^nv up to degree d */
+    uint64_t *hf  = (uint64_t *)calloc((unsigned long)d + 1, sizeof(uint64_t));
+    for (e = 0; e <= d && e <= nd; ++e) {
+        hf[e] = num[e];
+    }
+    free(num);
+    for (i = 0; i < nv; ++i) {
+        for (e = 1; e <= d; ++e) {
+            hf[e] +=  hf[e-1];
+        }
+    }
+
+    return hf;
+}
+
+/* maximal total degree of the lead terms of the (minimal) basis */
+static deg_t maximal_lead_term_degree(
+        const bs_t * const bs
+        )
+{
+    len_t i;
+    deg_t d = 0;
+
+    const ht_t * const ht = bs->ht;
+
+    for (i = 0; i < bs->lml; ++i) {
+        const deg_t e = ht->hd[bs->hm[bs->lmps[i]][OFFSET]].deg;
+        d = d > e ? d : e;
+    }
+    return d;
+}
+
+/* checks if the learned Hilbert function is the one of the leading ideal
+ * of bs, computed modulo another prime without pruning */
+static int32_t learned_hilbert_function_is_confirmed(
+        const bs_t * const bs,
+        const md_t * const md
+        )
+{
+    if (maximal_lead_term_degree(bs) != md->hf_deg) {
+        return 0;
+    }
+    uint64_t *hf = hilbert_function_of_leading_ideal(bs, md->hf_deg);
+    const int32_t eq = memcmp(hf, md->hf,
+            ((unsigned long)md->hf_deg + 1) * sizeof(uint64_t)) == 0;
+    free(hf);
+
+    return eq;
+}
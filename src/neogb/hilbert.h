@@ -0,0 +1,35 @@
+/* This file is part of msolve.
+ *
+ * msolve is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * msolve is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with msolve.  If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors:
+ * Jérémy Berthomieu
+ * Christian Eder
+ * Mohab Safey El Din */
+
+#ifndef GB_HILBERT_H
+#define GB_HILBERT_H
+
+#include "data.h"
+
+/* numerator of the Hilbert series of R/<lm> where lm are nm monomials
+ * given as consecutive exponent vectors of length nv, coefficients are
+ * stored modulo 2^64, *dp is set to the degree of the numerator */
+uint64_t *hilbert_series_numerator_of_monomials(
+        const int32_t *lm,
+        const len_t nm,
+        const len_t nv,
+        deg_t *dp
+        );
+#endif
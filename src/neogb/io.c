@@ -697,8 +697,8 @@ int validate_input_data(
         fprintf(ERRSTREAM, "Fixes maximal number of spairs chosen to all possible.\n");
         *max_nr_pairsp  =   0;
     }
-    if (*la_optionp != 1 && *la_optionp != 2 &&
-            *la_optionp != 42 && *la_optionp != 44) {
+    if (*la_optionp != 1 && *la_optionp != 2 && *la_optionp != 3 &&
+            *la_optionp != 42 && *la_optionp != 44 && *la_optionp != 45) {
         fprintf(ERRSTREAM, "Fixes linear algebra option to exact sparse.\n");
         *la_optionp =   2;
     }
@@ -875,6 +875,64 @@ void dispatch_sba_linear_algebra(
     sba_linear_algebra_ff_32(smat, syz, st, ht);
 }
 
+static inline len_t la_cost_index(
+        const int32_t la
+        )
+{
+    switch (la) {
+        case 1:
+            return 0;
+        case 2:
+            return 1;
+        case 42:
+            return 2;
+        default:
+            return 3;
+    }
+}
+
+/* Automatic choice of the linear algebra for the current matrix (laopt
+ * 3 resp. 45): Sparse matrices are reduced with the exact sparse kernel,
+ * denser ones get their new pivots reduced densely. Only the exact sparse
+ * kernel records the rows of a learned trace, so learning computations
+ * always use it, whereas both exact kernels can be used when applying a
+ * trace. If probabilistic linear algebra is allowed (laopt 45), there is
+ * no tracer and the field is large enough, matrices with many expected
+ * zero reductions, i.e. more rows to reduce than new columns or mostly
+ * zero reductions in the last matrix, are handled by the probabilistic
+ * kernels. Finally, if the alternative kernel of the same kind was
+ * clearly faster on an earlier matrix, measured per lower row and column,
+ * we use it instead. */
+static int32_t select_linear_algebra_option(
+        const mat_t * const mat,
+        const md_t * const st
+        )
+{
+    if (st->trace_level == LEARN_TRACER) {
+        return 2;
+    }
+    int32_t la  = 2;
+    if (mat->density > LA_AUTO_DENSITY
+            && (uint64_t)mat->nrl * mat->ncr <= LA_AUTO_MAX_DENSE) {
+        la  = 1;
+    }
+    if (st->laopt == 45 && st->trace_level == NO_TRACER
+            && st->fc >= (uint32_t)(1) << 15
+            && (mat->nrl > 2 * mat->ncr || st->la_zero > 0.5)) {
+        la  = la == 1 ? 42 : 44;
+    }
+    int32_t alt = la == 1 ? 2 : la == 2 ? 1 : la == 42 ? 44 : 42;
+    if (alt == 1 && (uint64_t)mat->nrl * mat->ncr > LA_AUTO_MAX_DENSE) {
+        alt = la;
+    }
+    const double cl = st->la_cost[la_cost_index(la)];
+    const double ca = st->la_cost[la_cost_index(alt)];
+    if (cl > 0 && ca > 0 && 2 * ca < cl) {
+        la  = alt;
+    }
+    return la;
+}
+
 void dispatch_linear_algebra(
         mat_t *mat,
         const bs_t * const tbr,
@@ -882,78 +940,99 @@ void dispatch_linear_algebra(
         md_t *st
         )
 {
+    int32_t la = st->laopt;
+
+    if (la == 3 || la == 45) {
+        la = select_linear_algebra_option(mat, st);
+    }
+    /* the dense kernel does not record the trace */
+    if (la == 1 && st->trace_level == LEARN_TRACER) {
+        la = 2;
+    }
+    const double rt     = realtime();
+    const double units  = (double)mat->nrl * mat->nc + 1;
+    const len_t nrl     = mat->nrl;
+
     switch (st->ff_bits) {
         case 0:
-            if (st->laopt == 1) {
+            if (la == 1) {
                 exact_sparse_linear_algebra_ab_first_qq(mat, tbr, bs, st);
             } else {
                 exact_sparse_linear_algebra_qq(mat, tbr, bs, st);
             }
             return;
         case 8:
-            switch (st->laopt) {
+            switch (la) {
                 case 1:
                     exact_sparse_dense_linear_algebra_ff_8(mat, tbr, bs, st);
-                    return;
+                    break;
                 case 2:
                     exact_sparse_linear_algebra_ff_8(mat, tbr, bs, st);
-                    return;
+                    break;
                 case 42:
                     probabilistic_sparse_dense_linear_algebra_ff_8(mat, tbr, bs, st);
-                    return;
+                    break;
                 case 43:
                     probabilistic_sparse_dense_linear_algebra_ff_8_2(mat, tbr, bs, st);
-                    return;
+                    break;
                 case 44:
                     probabilistic_sparse_linear_algebra_ff_8(mat, tbr, bs, st);
-                    return;
+                    break;
                 default:
                     exact_sparse_linear_algebra_ff_8(mat, tbr, bs, st);
-                    return;
+                    break;
             }
+            break;
         case 16:
-            switch (st->laopt) {
+            switch (la) {
                 case 1:
                     exact_sparse_dense_linear_algebra_ff_16(mat, tbr, bs, st);
-                    return;
+                    break;
                 case 2:
                     exact_sparse_linear_algebra_ff_16(mat, tbr, bs, st);
-                    return;
+                    break;
                 case 42:
                     probabilistic_sparse_dense_linear_algebra_ff_16(mat, tbr, bs, st);
-                    return;
+                    break;
                 case 43:
                     probabilistic_sparse_dense_linear_algebra_ff_16_2(mat, tbr, bs, st);
-                    return;
+                    break;
                 case 44:
                     probabilistic_sparse_linear_algebra_ff_16(mat, tbr, bs, st);
-                    return;
+                    break;
                 default:
                     exact_sparse_linear_algebra_ff_16(mat, tbr, bs, st);
-                    return;
+                    break;
             }
+            break;
         case 32:
         default:
-            switch (st->laopt) {
+            switch (la) {
                 case 1:
                     exact_sparse_dense_linear_algebra_ff_32(mat, tbr, bs, st);
-                    return;
+                    break;
                 case 2:
                     exact_sparse_linear_algebra_ff_32(mat, tbr, bs, st);
-                    return;
+                    break;
                 case 42:
                     probabilistic_sparse_dense_linear_algebra_ff_32(mat, tbr, bs, st);
-                    return;
+                    break;
                 case 43:
                     probabilistic_sparse_dense_linear_algebra_ff_32_2(mat, tbr, bs, st);
-                    return;
+                    break;
                 case 44:
                     probabilistic_sparse_linear_algebra_ff_32(mat, tbr, bs, st);
-                    return;
+                    break;
                 default:
                     exact_sparse_linear_algebra_ff_32(mat, tbr, bs, st);
-                    return;
+                    break;
             }
+            break;
+    }
+    /* keep timings and zero reductions for the next automatic choice */
+    if (st->laopt == 3 || st->laopt == 45) {
+        st->la_cost[la_cost_index(la)]  = (realtime() - rt) / units;
+        st->la_zero = nrl > 0 ? (double)(nrl - mat->np) / (double)nrl : 0;
     }
 }
 
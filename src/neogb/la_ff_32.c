@@ -303,6 +303,24 @@ static inline cf32_t *multiply_sparse_matrix_row_ff_32(
     return row;
 }
 
+/* While mat->ua is set new rows are taken from the arena of the calling
+ * thread. They are then released all at once when the matrix is cleared,
+ * callers must not free them. */
+static inline hm_t *allocate_sparse_matrix_row_ff_32(
+        mat_t *mat,
+        cf32_t **cfp,
+        const len_t len
+        )
+{
+    if (mat->ua == 1) {
+        arena_t *ar = mat->ar + omp_get_thread_num();
+        *cfp  = (cf32_t *)arena_alloc(ar, (uint64_t)len * sizeof(cf32_t));
+        return (hm_t *)arena_alloc(ar, (uint64_t)(len+OFFSET) * sizeof(hm_t));
+    }
+    *cfp  = (cf32_t *)malloc((uint64_t)len * sizeof(cf32_t));
+    return (hm_t *)malloc((uint64_t)(len+OFFSET) * sizeof(hm_t));
+}
+
 static hm_t *reduce_dense_row_by_known_pivots_sparse_17_bit(
         int64_t *dr,
         mat_t *mat,
@@ -556,8 +574,8 @@ static hm_t *reduce_dense_row_by_known_pivots_sparse_17_bit(
         return NULL;
     }
 
-    hm_t *row   = (hm_t *)malloc((uint64_t)(k+OFFSET) * sizeof(hm_t));
-    cf32_t *cf  = (cf32_t *)malloc((uint64_t)(k) * sizeof(cf32_t));
+    cf32_t *cf  = NULL;
+    hm_t *row   = allocate_sparse_matrix_row_ff_32(mat, &cf, k);
     j = 0;
     hm_t *rs = row + OFFSET;
     for (i = ncl; i < ncols; ++i) {
@@ -642,8 +660,8 @@ static hm_t *trace_reduce_dense_row_by_known_pivots_sparse_17_bit(
         st->trace_nr_add  +=  len / 1000.0;
         st->trace_nr_red++;
     }
-    hm_t *row   = (hm_t *)malloc((uint64_t)(k+OFFSET) * sizeof(hm_t));
-    cf32_t *cf  = (cf32_t *)malloc((uint64_t)(k) * sizeof(cf32_t));
+    cf32_t *cf  = NULL;
+    hm_t *row   = allocate_sparse_matrix_row_ff_32(mat, &cf, k);
     j = 0;
     hm_t *rs = row + OFFSET;
     for (i = ncl; i < ncols; ++i) {
@@ -1220,8 +1238,8 @@ static hm_t *reduce_dense_row_by_known_pivots_sparse_31_bit(
         return NULL;
     }
 
-    hm_t *row   = (hm_t *)malloc((uint64_t)(k+OFFSET) * sizeof(hm_t));
-    cf32_t *cf  = (cf32_t *)malloc((uint64_t)(k) * sizeof(cf32_t));
+    cf32_t *cf  = NULL;
+    hm_t *row   = allocate_sparse_matrix_row_ff_32(mat, &cf, k);
     j = 0;
     hm_t *rs  = row + OFFSET;
     for (i = ncl; i < ncols; ++i) {
@@ -1604,8 +1622,8 @@ static hm_t *trace_reduce_dense_row_by_known_pivots_sparse_31_bit(
         return NULL;
     }
 
-    hm_t *row   = (hm_t *)malloc((uint64_t)(k+OFFSET) * sizeof(hm_t));
-    cf32_t *cf  = (cf32_t *)malloc((uint64_t)(k) * sizeof(cf32_t));
+    cf32_t *cf  = NULL;
+    hm_t *row   = allocate_sparse_matrix_row_ff_32(mat, &cf, k);
     j = 0;
     hm_t *rs  = row + OFFSET;
     for (i = ncl; i < ncols; ++i) {
@@ -2611,6 +2629,15 @@ static void exact_sparse_reduced_echelon_form_ff_32(
 
     len_t bad_prime = 0;
 
+    /* if the new pivots are interreduced afterwards, rows generated
+     * during the parallel reduction only live until then, so we take
+     * them from the thread arenas instead of the shared heap */
+    const int32_t ua  = st->nf == 0 && st->in_final_reduction_step == 0;
+    if (ua == 1) {
+        initialize_matrix_arenas(mat, nthrds);
+        mat->ua = 1;
+    }
+
     /* we fill in all known lead terms in pivs */
     hm_t **pivs   = (hm_t **)calloc((uint64_t)ncols, sizeof(hm_t *));
     if (st->in_final_reduction_step == 0) {
@@ -2663,8 +2690,12 @@ static void exact_sparse_reduced_echelon_form_ff_32(
                 /* If we do normal form computations the first monomial in the polynomial might not
                 be a known pivot, thus setting it to npiv[OFFSET] can lead to wrong results. */
                 sc  = st->nf == 0 ? npiv[OFFSET] : 0;
-                free(npiv);
-                free(cfs);
+                /* the initial row from symbolic preprocessing is always
+                 * on the heap, rows from later passes may be arena rows */
+                if (ua == 0 || cfs == NULL) {
+                    free(npiv);
+                    free(cfs);
+                }
                 npiv  = mat->tr[i] = reduce_dense_row_by_known_pivots_sparse_ff_32(
                         drl, mat, bs, pivs, sc, i, mh, bi, st->trace_level == LEARN_TRACER, st);
                 if (st->nf > 0) {
@@ -2697,9 +2728,13 @@ static void exact_sparse_reduced_echelon_form_ff_32(
         }
     }
 
+    mat->ua = 0;
+
     if (bad_prime == 1) {
         for (i = 0; i < ncl+ncr; ++i) {
-            free(pivs[i]);
+            if (i < ncl || ua == 0) {
+                free(pivs[i]);
+            }
             pivs[i] = NULL;
         }
         mat->np = 0;
@@ -2750,8 +2785,10 @@ static void exact_sparse_reduced_echelon_form_ff_32(
                     dr[ds[j+2]]  = (int64_t)cfs[j+2];
                     dr[ds[j+3]]  = (int64_t)cfs[j+3];
                 }
-                free(pivs[k]);
-                free(cfs);
+                if (ua == 0) {
+                    free(pivs[k]);
+                    free(cfs);
+                }
                 pivs[k] = NULL;
                 pivs[k] = mat->tr[npivs++] =
                     reduce_dense_row_by_known_pivots_sparse_ff_32(
@@ -3025,6 +3062,12 @@ static void exact_trace_sparse_reduced_echelon_form_ff_32(
     /* unkown pivot rows we have to reduce with the known pivots first */
     hm_t **upivs  = mat->tr;
 
+    /* rows generated during the parallel reduction only live until
+     * the interreduction of the new pivots, see
+     * exact_sparse_reduced_echelon_form_ff_32() */
+    initialize_matrix_arenas(mat, nthrds);
+    mat->ua = 1;
+
     int64_t *dr  = (int64_t *)malloc(
             (uint64_t)ncols * nthrds * sizeof(int64_t));
     /* mo need to have any sharing dependencies on parallel computation,
@@ -3056,8 +3099,10 @@ static void exact_trace_sparse_reduced_echelon_form_ff_32(
         cfs = NULL;
         do {
             sc  = npiv[OFFSET];
-            free(npiv);
-            free(cfs);
+            /* only the initial row from symbolic preprocessing is on the heap */
+            if (cfs == NULL) {
+                free(npiv);
+            }
             npiv  = mat->tr[i]  = trace_reduce_dense_row_by_known_pivots_sparse_ff_32(
                     rba, drl, mat, bs, pivs, sc, i, mh, bi, st);
             if (!npiv) {
@@ -3077,6 +3122,8 @@ static void exact_trace_sparse_reduced_echelon_form_ff_32(
         } while (!k);
     }
 
+    mat->ua = 0;
+
     /* construct the trace */
     construct_trace(trace, mat);
 
@@ -3115,8 +3162,6 @@ static void exact_trace_sparse_reduced_echelon_form_ff_32(
                 dr[ds[j+2]]  = (int64_t)cfs[j+2];
                 dr[ds[j+3]]  = (int64_t)cfs[j+3];
             }
-            free(pivs[k]);
-            free(cfs);
             pivs[k] = NULL;
             pivs[k] = mat->tr[npivs++] =
                 reduce_dense_row_by_known_pivots_sparse_ff_32(
@@ -3155,6 +3200,12 @@ static int exact_application_sparse_reduced_echelon_form_ff_32(
     /* unkown pivot rows we have to reduce with the known pivots first */
     hm_t **upivs  = mat->tr;
 
+    /* rows generated during the parallel reduction only live until
+     * the interreduction of the new pivots, see
+     * exact_sparse_reduced_echelon_form_ff_32() */
+    initialize_matrix_arenas(mat, nthrds);
+    mat->ua = 1;
+
     int64_t *dr  = (int64_t *)malloc(
             (uint64_t)ncols * nthrds * sizeof(int64_t));
     /* mo need to have any sharing dependencies on parallel computation,
@@ -3187,8 +3238,10 @@ static int exact_application_sparse_reduced_echelon_form_ff_32(
             cfs = NULL;
             do {
                 sc  = npiv[OFFSET];
-                free(npiv);
-                free(cfs);
+                /* only the initial row from symbolic preprocessing is on the heap */
+                if (cfs == NULL) {
+                    free(npiv);
+                }
                 npiv  = mat->tr[i]  = reduce_dense_row_by_known_pivots_sparse_ff_32(
                         drl, mat, bs, pivs, sc, i, mh, bi, 0, st);
                 if (!npiv) {
@@ -3211,6 +3264,8 @@ static int exact_application_sparse_reduced_echelon_form_ff_32(
             } while (!k);
         }
     }
+    mat->ua = 0;
+
     /* unlucky prime found */
     if (flag == 0) {
         return 1;
@@ -3250,8 +3305,6 @@ static int exact_application_sparse_reduced_echelon_form_ff_32(
                 dr[ds[j+2]]  = (int64_t)cfs[j+2];
                 dr[ds[j+3]]  = (int64_t)cfs[j+3];
             }
-            free(pivs[k]);
-            free(cfs);
             pivs[k] = NULL;
             pivs[k] = mat->tr[npivs++] =
                 reduce_dense_row_by_known_pivots_sparse_ff_32(
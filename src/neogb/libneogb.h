@@ -28,6 +28,7 @@
 #include "f4.h"
 #include "sba.h"
 #include "hash.h"
+#include "hilbert.h"
 #include "io.h"
 #include "modular.h"
 #include "nf.h"
@@ -34,6 +34,9 @@ md_t *copy_meta_data(
     md->application_nr_mult = 0;
     md->application_nr_add  = 0;
     md->application_nr_red  = 0;
+    /* the Hilbert function cache is local to each computation */
+    md->hf_cur      = NULL;
+    md->hf_mismatch = 0;
 
     if (md->fc < (uint32_t)(1u) << 8) {
         md->ff_bits = 8;
@@ -60,6 +63,7 @@ void free_meta_data(
         free_pairset(&(md->ps));
     }
     free(md->hcm);
+    free(md->hf_cur);
 
     ht_t *ht = md->ht;
     if (ht != NULL) {
@@ -331,6 +335,12 @@ void get_and_print_final_statistics(
         fprintf(file, "#terms in basis    %16lu\n", (unsigned long)st->nterms_basis);
         fprintf(file, "#pairs reduced     %16lu\n", (unsigned long)st->num_pairsred);
         fprintf(file, "#GM criterion      %16lu\n", (unsigned long)st->num_gb_crit);
+        if ((st->hf != NULL && st->hf_validated == 1) || st->hf_mismatch == 1) {
+            fprintf(file, "#Hilbert pruned    %16lu\n", (unsigned long)st->num_hilbert_pruned);
+        }
+        if (st->hf_mismatch == 1) {
+            fprintf(file, "Hilbert function mismatch, pruning stopped\n");
+        }
         fprintf(file, "#redundant elements      %10lu\n", (unsigned long)st->num_redundant);
         fprintf(file, "#rows reduced      %16lu\n", (unsigned long)st->num_rowsred);
         fprintf(file, "#zero reductions   %16lu\n", (unsigned long)st->num_zerored);
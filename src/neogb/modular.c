@@ -42,6 +42,40 @@ static int minimal_traced_lm_is_equal(
     return 1;
 }
 
+/* checks if bs has the same leading ideal as the basis tbs, e.g. when bs
+ * was computed by another learning run with its own basis hash table */
+int basis_lm_is_equal(
+        const bs_t * const tbs,
+        const bs_t * const bs
+        )
+{
+    if (bs->lml != tbs->lml) {
+        return 0;
+    }
+    const ht_t * const tht = tbs->ht;
+    const ht_t * const bht = bs->ht;
+    hm_t *lmh = (hm_t *)malloc((unsigned long)tbs->lml * sizeof(hm_t));
+
+    len_t i, j;
+    for (i = 0; i < tbs->lml; ++i) {
+        const exp_t * const a = tht->ev[tbs->hm[tbs->lmps[i]][OFFSET]];
+        val_t h = 0;
+        for (j = 0; j < bht->evl; ++j) {
+            h +=  bht->rn[j] * a[j];
+        }
+        hi_t k;
+        if (is_contained_in_hash_table(a, bht, h, &k) != 1) {
+            free(lmh);
+            return 0;
+        }
+        lmh[i] = k;
+    }
+    const int eq = minimal_traced_lm_is_equal(lmh, tbs->lml, bs);
+    free(lmh);
+
+    return eq;
+}
+
 trace_t *initialize_trace(
         const bs_t * const bs,
         const md_t * const md
@@ -368,7 +402,7 @@ stop:
     /* note that all rows kept from mat during the overall computation are
      * basis elements and thus we do not need to free the rows itself, but
      * just the matrix structure */
-    free(mat);
+    free_matrix(&mat);
     gst->application_nr_add   = st->application_nr_add;
     gst->application_nr_mult  = st->application_nr_mult;
     gst->application_nr_red   = st->application_nr_red;
@@ -658,7 +692,7 @@ bs_t *f4sat_trace_application_test_phase(
     /* note that all rows kept from mat during the overall computation are
      * basis elements and thus we do not need to free the rows itself, but
      * just the matrix structure */
-    free(mat);
+    free_matrix(&mat);
     gst->application_nr_add   = st->application_nr_add;
     gst->application_nr_mult  = st->application_nr_mult;
     gst->application_nr_red   = st->application_nr_red;
@@ -942,7 +976,7 @@ stop:
     /* note that all rows kept from mat during the overall computation are
      * basis elements and thus we do not need to free the rows itself, but
      * just the matrix structure */
-    free(mat);
+    free_matrix(&mat);
     gst->application_nr_add   = st->application_nr_add;
     gst->application_nr_mult  = st->application_nr_mult;
     gst->application_nr_red   = st->application_nr_red;
@@ -1125,7 +1159,7 @@ bs_t *f4_trace_learning_phase(
     /* note that all rows kept from mat during the overall computation are
      * basis elements and thus we do not need to free the rows itself, but
      * just the matrix structure */
-    free(mat);
+    free_matrix(&mat);
 
     /* fix size of trace data */
     trace->td = realloc(trace->td, (unsigned long)trace->ltd * sizeof(td_t));
@@ -1451,7 +1485,7 @@ end_sat_step:
     /* note that all rows kept from mat during the overall computation are
      * basis elements and thus we do not need to free the rows itself, but
      * just the matrix structure */
-    free(mat);
+    free_matrix(&mat);
 
     /* fix size of trace saturation data */
     trace->ts = realloc(trace->ts, (unsigned long)trace->lts * sizeof(ts_t));
@@ -1769,7 +1803,7 @@ bs_t *f4sat_trace_learning_phase_2(
     /* note that all rows kept from mat during the overall computation are
      * basis elements and thus we do not need to free the rows itself, but
      * just the matrix structure */
-    free(mat);
+    free_matrix(&mat);
 
     /* fix size of trace data */
     trace->td = realloc(trace->td, (unsigned long)trace->ltd * sizeof(td_t));
@@ -2071,7 +2105,7 @@ bs_t *modular_f4(
     /* note that all rows kept from mat during the overall computation are
      * basis elements and thus we do not need to free the rows itself, but
      * just the matrix structure */
-    free(mat);
+    free_matrix(&mat);
 
     free(st);
 
@@ -34,6 +34,11 @@ void free_trace(
         trace_t **trp
         );
 
+int basis_lm_is_equal(
+        const bs_t * const tbs,
+        const bs_t * const bs
+        );
+
 void free_lucky_primes(
         primes_t **lpp
         );
@@ -107,7 +107,7 @@ bs_t *core_nf(
     /* note that all rows kept from mat during the overall computation are
      * basis elements and thus we do not need to free the rows itself, but
      * just the matrix structure */
-    free(mat);
+    free_matrix(&mat);
 
     *errp = 0;
 
@@ -586,7 +586,7 @@ static void sba_final_reduction_step(
     if (sht != NULL) {
         free_hash_table(&sht);
     }
-    free(mat);
+    free_matrix(&mat);
     mat = NULL;
 
     *htp  = ht;
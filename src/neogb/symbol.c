@@ -193,6 +193,71 @@ static void select_all_spairs(
 }
 #endif
 
+/* For homogeneous input the pairs are handled degree by degree. If the
+ * Hilbert function of the current leading ideal already equals the one
+ * of the learned leading ideal in the minimal pair degree, all pairs of
+ * this degree reduce to zero and are removed. If this holds for all
+ * degrees up to the maximal degree of a learned lead term, the series is
+ * met and we are done. Returns 1 if no pairs are left.
+ *
+ * All degrees below the minimal pair degree are finished. If the Hilbert
+ * functions differ in one of them, the learned one does not fit the
+ * current prime (one of both primes is unlucky), so we stop pruning.
+ *
+ * NOTE: The pair list has to be sorted! */
+static int32_t prune_spairs_by_hilbert_function(
+        bs_t *bs,
+        md_t *md
+        )
+{
+    len_t i;
+    deg_t d;
+
+    ps_t *psl         = md->ps;
+    spair_t *ps       = psl->p;
+    const deg_t hd    = md->hf_deg;
+    const uint64_t * const hfl = md->hf;
+
+    /* the leading ideal only changes if new elements are added */
+    if (md->hf_cur == NULL || md->hf_cur_ld != bs->ld) {
+        free(md->hf_cur);
+        md->hf_cur    = hilbert_function_of_leading_ideal(bs, hd);
+        md->hf_cur_ld = bs->ld;
+    }
+    const uint64_t * const hf = md->hf_cur;
+
+    for (d = 0; d < ps[0].deg && d <= hd; ++d) {
+        if (hf[d] != hfl[d]) {
+            md->hf          = NULL;
+            md->hf_mismatch = 1;
+            return 0;
+        }
+    }
+
+    i = 0;
+    while (i < psl->ld && ps[i].deg <= hd && hf[ps[i].deg] == hfl[ps[i].deg]) {
+        ++i;
+    }
+    if (i < psl->ld && ps[i].deg > hd) {
+        for (d = 0; d <= hd; ++d) {
+            if (hf[d] != hfl[d]) {
+                break;
+            }
+        }
+        if (d > hd) {
+            i = psl->ld;
+        }
+    }
+
+    if (i > 0) {
+        md->num_hilbert_pruned  +=  i;
+        memmove(ps, ps+i, (unsigned long)(psl->ld-i) * sizeof(spair_t));
+        psl->ld -=  i;
+    }
+
+    return psl->ld == 0;
+}
+
 /* selection of spairs, at the moment only selection
 by minial degree of the spairs is supported
 
@@ -224,6 +289,13 @@ static int32_t select_spairs_by_minimal_degree(
 
     /* sort pair set */
     sort_r(ps, (unsigned long)psl->ld, sizeof(spair_t), spair_cmp, bht);
+
+    /* remove pairs known to reduce to zero due to the Hilbert function */
+    if (md->hf != NULL && md->hf_validated == 1) {
+        if (prune_spairs_by_hilbert_function(bs, md)) {
+            return 1;
+        }
+    }
     /* get minimal degree */
     mdeg  = ps[0].deg;
 
@@ -490,34 +562,29 @@ static void select_tbr(
 }
 
 
-static inline void find_multiplied_reducer(
-        bs_t *bs,
+/* returns the position in bs->lmps of the first basis element whose lead
+ * term divides m, -1 if there is no such element. only reads data, so it
+ * can be called for different monomials in parallel. */
+static inline int64_t find_reducer_position(
+        const bs_t * const bs,
         const hm_t m,
-        len_t *nr,
-        hm_t **rows,
-        ht_t *sht,
-        const md_t * const md
+        const ht_t * const sht
         )
 {
     len_t i, k;
 
-    ht_t *bht = bs->ht;
-
-    const len_t rr  = *nr;
+    const ht_t * const bht = bs->ht;
 
     const len_t evl = bht->evl;
 
     const exp_t * const e  = sht->ev[m];
 
-    const hd_t hdm    = sht->hd[m];
     const len_t lml   = bs->lml;
-    const sdm_t ns    = ~hdm.sdm;
+    const sdm_t ns    = ~sht->hd[m].sdm;
 
     const sdm_t * const lms = bs->lm;
     const bl_t * const lmps = bs->lmps;
 
-    exp_t etmp[bht->evl];
-    const hd_t * const hdb  = bht->hd;
     exp_t * const * const evb = bht->ev;
 
     i = 0;
@@ -526,35 +593,74 @@ start:
         i++;
     }
     if (i < lml) {
-        const hm_t *b = bs->hm[lmps[i]];
-        const exp_t * const f = evb[b[OFFSET]];
+        const exp_t * const f = evb[bs->hm[lmps[i]][OFFSET]];
         for (k=0; k < evl; ++k) {
             if (e[k] < f[k]) {
                 i++;
                 goto start;
             }
-            etmp[k] = (exp_t)(e[k]-f[k]);
         }
+        return (int64_t)i;
+    }
+    return -1;
+}
 
-        const hi_t h  = hdm.val - hdb[b[OFFSET]].val;
-        rows[rr]  = multiplied_poly_to_matrix_row(sht, bht, h, etmp, b);
-        /* track trace information ? */
-        if (md->trace_level == LEARN_TRACER) {
-            rows[rr][BINDEX]  = lmps[i];
-            if (bht->eld == bht->esz-1) {
-                enlarge_hash_table(bht);
-            }
+/* adds the multiple of the basis element at position pos in bs->lmps
+ * with lead term m as new reducer row, inserts into the hash tables */
+static inline void add_multiplied_reducer(
+        bs_t *bs,
+        const hm_t m,
+        const len_t pos,
+        len_t *nr,
+        hm_t **rows,
+        ht_t *sht,
+        const md_t * const md
+        )
+{
+    len_t k;
+
+    ht_t *bht = bs->ht;
+
+    const len_t rr  = *nr;
+
+    const len_t evl = bht->evl;
+
+    const exp_t * const e  = sht->ev[m];
+
+    const hd_t hdm    = sht->hd[m];
+    const bl_t * const lmps = bs->lmps;
+
+    exp_t etmp[bht->evl];
+    const hd_t * const hdb  = bht->hd;
+    exp_t * const * const evb = bht->ev;
+
+    const hm_t *b = bs->hm[lmps[pos]];
+    const exp_t * const f = evb[b[OFFSET]];
+    for (k=0; k < evl; ++k) {
+        etmp[k] = (exp_t)(e[k]-f[k]);
+    }
+
+    const hi_t h  = hdm.val - hdb[b[OFFSET]].val;
+    rows[rr]  = multiplied_poly_to_matrix_row(sht, bht, h, etmp, b);
+    /* track trace information ? */
+    if (md->trace_level == LEARN_TRACER) {
+        rows[rr][BINDEX]  = lmps[pos];
+        if (bht->eld == bht->esz-1) {
+            enlarge_hash_table(bht);
+        }
 #if PARALLEL_HASHING
-            rows[rr][MULT]    = check_insert_in_hash_table(etmp, h, bht);
+        rows[rr][MULT]    = check_insert_in_hash_table(etmp, h, bht);
 #else
-            rows[rr][MULT]    = insert_in_hash_table(etmp, bht);
+        rows[rr][MULT]    = insert_in_hash_table(etmp, bht);
 #endif
-        }
-        sht->hd[m].idx  = 2;
-        *nr             = rr + 1;
     }
+    sht->hd[m].idx  = 2;
+    *nr             = rr + 1;
 }
 
+/* waves with fewer monomials are handled by one thread */
+#define SYMBOL_MIN_PARALLEL_WAVE 512
+
 static void symbolic_preprocessing(
         mat_t *mat,
         bs_t *bs,
@@ -581,38 +687,62 @@ static void symbolic_preprocessing(
 
     const hl_t oesld = sht->eld;
     const len_t onrr  = mat->nc;
-    i = 1;
-    /* we only have to check if idx is set for the elements already set
-     * when selecting spairs, afterwards (second for loop) we do not
-     * have to do this check */
-    while (mat->sz <= nrr + oesld) {
-        mat->sz *=  2;
-        mat->rr =   realloc(mat->rr, (unsigned long)mat->sz * sizeof(hm_t *));
-        if (mat->rr == NULL) {
-            fprintf(ERRSTREAM, "Allocating memory for matrix failed,\n");
-            fprintf(ERRSTREAM, "segmentation fault will follow.\n");
+
+    /* We proceed in waves: the monomials in [lo, hi) are the ones that
+     * were added to sht during the previous wave (resp. all monomials
+     * from the selected pairs in the first wave). Searching for reducers
+     * only reads data and is done in parallel, the positions found are
+     * stored per monomial. Afterwards the reducer rows are generated
+     * in increasing monomial order, so the matrix is the same as
+     * with a purely sequential preprocessing. Each monomial gets at most
+     * one reducer, thus there are no duplicate rows. */
+    int64_t *rp   = NULL;
+    hl_t rpsz     = 0;
+    hl_t lo       = 1;
+    hl_t hi       = oesld;
+    while (lo < hi) {
+        const hl_t nw = hi - lo;
+        if (rpsz < nw) {
+            rpsz  = nw;
+            rp    = realloc(rp, (unsigned long)rpsz * sizeof(int64_t));
         }
-    }
-    for (; i < oesld; ++i) {
-        if (!sht->hd[i].idx) {
-            sht->hd[i].idx = 1;
-            mat->nc++;
-            find_multiplied_reducer(bs, i, &nrr, mat->rr, sht, md);
+        const int32_t nthrds = nw < SYMBOL_MIN_PARALLEL_WAVE ? 1 : md->nthrds;
+#pragma omp parallel for num_threads(nthrds) \
+    private(i) schedule(dynamic, 64)
+        for (i = lo; i < hi; ++i) {
+            /* we only have to check if idx is set for the elements already
+             * set when selecting spairs, afterwards we do not have to do
+             * this check */
+            if (i < oesld && sht->hd[i].idx) {
+                rp[i-lo]  = -2;
+            } else {
+                rp[i-lo]  = find_reducer_position(bs, i, sht);
+            }
         }
-    }
-    for (; i < sht->eld; ++i) {
-        if (mat->sz == nrr) {
+        while (mat->sz <= nrr + nw) {
             mat->sz *=  2;
-            mat->rr  =  realloc(mat->rr, (unsigned long)mat->sz * sizeof(hm_t *));
+            mat->rr =   realloc(mat->rr, (unsigned long)mat->sz * sizeof(hm_t *));
             if (mat->rr == NULL) {
                 fprintf(ERRSTREAM, "Allocating memory for matrix failed,\n");
                 fprintf(ERRSTREAM, "segmentation fault will follow.\n");
             }
         }
-        sht->hd[i].idx = 1;
-        mat->nc++;
-        find_multiplied_reducer(bs, i, &nrr, mat->rr, sht, md);
+        for (i = lo; i < hi; ++i) {
+            if (rp[i-lo] == -2) {
+                continue;
+            }
+            sht->hd[i].idx = 1;
+            mat->nc++;
+            if (rp[i-lo] >= 0) {
+                add_multiplied_reducer(bs, i, (len_t)rp[i-lo],
+                        &nrr, mat->rr, sht, md);
+            }
+        }
+        lo  = hi;
+        hi  = sht->eld;
     }
+    free(rp);
+
     /* realloc to real size */
     mat->rr   =   realloc(mat->rr, (unsigned long)nrr * sizeof(hm_t *));
     mat->nr   +=  nrr - onrr;
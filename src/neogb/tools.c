@@ -60,6 +60,75 @@ double realtime(void)
 #endif
 }
 
+void initialize_matrix_arenas(
+        mat_t *mat,
+        const int32_t nthrds
+        )
+{
+    if (mat->nar >= (len_t)nthrds) {
+        return;
+    }
+    mat->ar = realloc(mat->ar, (uint64_t)nthrds * sizeof(arena_t));
+    memset(mat->ar + mat->nar, 0,
+            (uint64_t)(nthrds - mat->nar) * sizeof(arena_t));
+    mat->nar  = nthrds;
+}
+
+void reset_matrix_arenas(
+        mat_t *mat
+        )
+{
+    len_t i;
+
+    for (i = 0; i < mat->nar; ++i) {
+        mat->ar[i].cc = 0;
+        mat->ar[i].ld = 0;
+    }
+}
+
+void free_matrix_arenas(
+        mat_t *mat
+        )
+{
+    len_t i, j;
+
+    for (i = 0; i < mat->nar; ++i) {
+        for (j = 0; j < mat->ar[i].nch; ++j) {
+            free(mat->ar[i].ch[j]);
+        }
+        free(mat->ar[i].ch);
+        free(mat->ar[i].csz);
+    }
+    free(mat->ar);
+    mat->ar   = NULL;
+    mat->nar  = 0;
+}
+
+/* move on to the next chunk of the arena that can hold sz bytes,
+ * chunks too small for sz are skipped until the next reset */
+void enlarge_arena(
+        arena_t *ar,
+        const uint64_t sz
+        )
+{
+    len_t i;
+
+    i = ar->nch == 0 ? 0 : ar->cc + 1;
+    while (i < ar->nch && ar->csz[i] < sz) {
+        ++i;
+    }
+    if (i == ar->nch) {
+        const uint64_t csz = sz > ARENA_CHUNK_SIZE ? sz : ARENA_CHUNK_SIZE;
+        ar->ch  = realloc(ar->ch, (uint64_t)(ar->nch+1) * sizeof(char *));
+        ar->csz = realloc(ar->csz, (uint64_t)(ar->nch+1) * sizeof(uint64_t));
+        ar->ch[ar->nch]   = (char *)malloc(csz);
+        ar->csz[ar->nch]  = csz;
+        ar->nch++;
+    }
+    ar->cc  = i;
+    ar->ld  = 0;
+}
+
 static void construct_trace(
         trace_t *trace,
         mat_t *mat
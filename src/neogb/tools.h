@@ -34,6 +34,41 @@ double realtime(
     void
     );
 
+/* per-thread arenas for temporary matrix rows */
+void initialize_matrix_arenas(
+        mat_t *mat,
+        const int32_t nthrds
+        );
+
+void reset_matrix_arenas(
+        mat_t *mat
+        );
+
+void free_matrix_arenas(
+        mat_t *mat
+        );
+
+void enlarge_arena(
+        arena_t *ar,
+        const uint64_t sz
+        );
+
+static inline void *arena_alloc(
+        arena_t *ar,
+        uint64_t sz
+        )
+{
+    /* keep 16 byte alignment as malloc does */
+    sz  = (sz + 15) & ~(uint64_t)15;
+    if (ar->nch == 0 || ar->ld + sz > ar->csz[ar->cc]) {
+        enlarge_arena(ar, sz);
+    }
+    void *mem = ar->ch[ar->cc] + ar->ld;
+    ar->ld  +=  sz;
+
+    return mem;
+}
+
 static inline uint8_t mod_p_inverse_8(
         const int16_t val,
         const int16_t p
@@ -0,0 +1,68 @@
+#!/usr/bin/env bash
+
+# parametrizations through block Wiedemann sequences, the minimal
+# dimension is lowered so that these small inputs use them
+
+source test/diff/diff_source.sh
+
+file=eco10-31
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.1.res \
+      --random-seed $seed --block-wiedemann 64 \
+      -P 2 -d 0 -t 1
+if [ $? -gt 0 ]; then
+    print_exit 1
+fi
+
+diff test/diff/$file.1.res output_files/$file.P2.d0.res
+if [ $? -gt 0 ]; then
+    print_exit 2
+fi
+
+rm test/diff/$file.1.res
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.41.res \
+      --random-seed $seed --block-wiedemann 64 \
+      -P 2 -d 0 -t 4
+if [ $? -gt 0 ]; then
+    print_exit 41
+fi
+
+diff test/diff/$file.41.res output_files/$file.P2.d0.res
+if [ $? -gt 0 ]; then
+    print_exit 42
+fi
+
+rm test/diff/$file.41.res
+
+file=kat7-qq
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.1.res \
+      --random-seed $seed --block-wiedemann 64 \
+      -P 2 -d 0 -t 1
+if [ $? -gt 0 ]; then
+    print_exit 11
+fi
+
+diff test/diff/$file.1.res output_files/$file.P2.d0.res
+if [ $? -gt 0 ]; then
+    print_exit 12
+fi
+
+rm test/diff/$file.1.res
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.41.res \
+      --random-seed $seed --block-wiedemann 64 \
+      -P 2 -d 0 -t 4
+if [ $? -gt 0 ]; then
+    print_exit 51
+fi
+
+diff test/diff/$file.41.res output_files/$file.P2.d0.res
+if [ $? -gt 0 ]; then
+    print_exit 52
+fi
+
+rm test/diff/$file.41.res
+
+normal_exit
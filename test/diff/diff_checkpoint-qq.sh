@@ -0,0 +1,94 @@
+#!/usr/bin/env bash
+
+# interrupts a computation over the rationals once it saved a checkpoint,
+# resumes it from this checkpoint, from a truncated one and from the one of
+# another computation
+
+file=kat7-qq
+other=henrion5-qq
+
+source test/diff/diff_source.sh
+
+# reads the verbose output of msolve until it reports a checkpoint, msolve
+# is then killed by SIGPIPE on its next output
+until_checkpoint() {
+    while IFS= read -r -d '>' tok; do
+        case "$tok" in
+            *"<ckpt") return 0;;
+        esac
+    done
+    return 1
+}
+
+rm -f test/diff/$file.ckpt test/diff/$file.ckpt.tmp
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.1.res \
+      --random-seed $seed \
+      -P 2 -d 0 -t 1 -v 1 \
+      --checkpoint test/diff/$file.ckpt --checkpoint-period 0 2>&1 \
+    | until_checkpoint
+if [ $? -gt 0 ] || [ ! -f test/diff/$file.ckpt ]; then
+    print_exit 1
+fi
+
+rm -f test/diff/$file.1.res
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.3.res \
+      --random-seed $seed \
+      -P 2 -d 0 -t 2 \
+      --checkpoint test/diff/$file.ckpt --resume
+if [ $? -gt 0 ]; then
+    print_exit 3
+fi
+
+diff test/diff/$file.3.res output_files/$file.P2.d0.res
+if [ $? -gt 0 ]; then
+    print_exit 4
+fi
+
+rm test/diff/$file.3.res
+
+head -c 4096 test/diff/$file.ckpt > test/diff/$file.ckpt.tmp
+mv test/diff/$file.ckpt.tmp test/diff/$file.ckpt
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.5.res \
+      --random-seed $seed \
+      -P 2 -d 0 -t 1 \
+      --checkpoint test/diff/$file.ckpt --resume 2> /dev/null
+if [ $? -gt 0 ]; then
+    print_exit 5
+fi
+
+diff test/diff/$file.5.res output_files/$file.P2.d0.res
+if [ $? -gt 0 ]; then
+    print_exit 6
+fi
+
+rm test/diff/$file.5.res
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.7.res \
+      --random-seed $seed \
+      -P 2 -d 0 -t 1 \
+      --checkpoint test/diff/$file.ckpt --checkpoint-period 0
+if [ $? -gt 0 ]; then
+    print_exit 7
+fi
+
+rm test/diff/$file.7.res
+
+$(pwd)/msolve -f input_files/$other.ms -o test/diff/$other.9.res \
+      --random-seed $seed \
+      -P 2 -d 0 -t 1 \
+      --checkpoint test/diff/$file.ckpt --resume 2> /dev/null
+if [ $? -gt 0 ]; then
+    print_exit 9
+fi
+
+diff test/diff/$other.9.res output_files/$other.P2.d0.res
+if [ $? -gt 0 ]; then
+    print_exit 10
+fi
+
+rm test/diff/$other.9.res test/diff/$file.ckpt
+
+normal_exit
@@ -0,0 +1,30 @@
+#!/usr/bin/env bash
+
+# runs the diff tests over the rationals going through FGLM with all
+# multiplication matrices stored with compressed rows
+
+source test/diff/diff_source.sh
+
+export SEED=$seed
+export MSOLVE_FGLM_COMPRESS_MIN=0
+
+excode=1
+for test in block-wiedemann \
+            cyclic5-qq \
+            eco6-qq \
+            henrion5-qq \
+            kat7-qq \
+            nonradical-radicalshape-no-square-qq \
+            nonradical-radicalshape-qq \
+            nonradical-shape-qq \
+            quadratic-nonradical-qq \
+            radical-shape-qq \
+            workers-qq; do
+    bash test/diff/diff_$test.sh 2> /dev/null
+    if [ $? -gt 0 ]; then
+        print_exit $excode
+    fi
+    excode=$((excode+1))
+done
+
+normal_exit
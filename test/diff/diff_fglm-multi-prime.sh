@@ -0,0 +1,32 @@
+#!/usr/bin/env bash
+
+# runs FGLM over the rationals with 4 to 8 primes per batch, the sequences
+# of groups of primes being generated together whatever the sizes
+
+source test/diff/diff_source.sh
+
+export MSOLVE_FGLM_MULTI_PRIME_MIN=0
+
+excode=1
+for file in henrion5-qq \
+            kat7-qq \
+            radical-shape-qq; do
+    for t in 4 6 8; do
+        $(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.$excode.res \
+              --random-seed $seed \
+              -P 2 -d 0 -t $t
+        if [ $? -gt 0 ]; then
+            print_exit $excode
+        fi
+
+        diff test/diff/$file.$excode.res output_files/$file.P2.d0.res
+        if [ $? -gt 0 ]; then
+            print_exit $((excode+1))
+        fi
+
+        rm test/diff/$file.$excode.res
+        excode=$((excode+2))
+    done
+done
+
+normal_exit
@@ -0,0 +1,124 @@
+#!/usr/bin/env bash
+
+# Hilbert series of the leading ideal, for a positive-dimensional ideal
+# over the rationals and a zero-dimensional one over a prime field
+
+source test/diff/diff_source.sh
+
+file=groebner-g2
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.1.res \
+      --random-seed $seed \
+      -g 3 -l 2 -t 1
+if [ $? -gt 0 ]; then
+    print_exit 1
+fi
+
+diff test/diff/$file.1.res output_files/$file.g3.res
+if [ $? -gt 0 ]; then
+    print_exit 2
+fi
+
+rm test/diff/$file.1.res
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.3.res \
+      --random-seed $seed \
+      -g 3 -l 2 -t 2
+if [ $? -gt 0 ]; then
+    print_exit 3
+fi
+
+diff test/diff/$file.3.res output_files/$file.g3.res
+if [ $? -gt 0 ]; then
+    print_exit 4
+fi
+
+rm test/diff/$file.3.res
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.5.res \
+      --random-seed $seed \
+      -g 3 -l 44 -t 1
+if [ $? -gt 0 ]; then
+    print_exit 5
+fi
+
+diff test/diff/$file.5.res output_files/$file.g3.res
+if [ $? -gt 0 ]; then
+    print_exit 6
+fi
+
+rm test/diff/$file.5.res
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.7.res \
+      --random-seed $seed \
+      -g 3 -l 44 -t 2
+if [ $? -gt 0 ]; then
+    print_exit 7
+fi
+
+diff test/diff/$file.7.res output_files/$file.g3.res
+if [ $? -gt 0 ]; then
+    print_exit 8
+fi
+
+rm test/diff/$file.7.res
+
+file=cyclic5-31
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.11.res \
+      --random-seed $seed \
+      -g 3 -l 2 -t 1
+if [ $? -gt 0 ]; then
+    print_exit 11
+fi
+
+diff test/diff/$file.11.res output_files/$file.g3.res
+if [ $? -gt 0 ]; then
+    print_exit 12
+fi
+
+rm test/diff/$file.11.res
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.13.res \
+      --random-seed $seed \
+      -g 3 -l 2 -t 2
+if [ $? -gt 0 ]; then
+    print_exit 13
+fi
+
+diff test/diff/$file.13.res output_files/$file.g3.res
+if [ $? -gt 0 ]; then
+    print_exit 14
+fi
+
+rm test/diff/$file.13.res
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.15.res \
+      --random-seed $seed \
+      -g 3 -l 44 -t 1
+if [ $? -gt 0 ]; then
+    print_exit 15
+fi
+
+diff test/diff/$file.15.res output_files/$file.g3.res
+if [ $? -gt 0 ]; then
+    print_exit 16
+fi
+
+rm test/diff/$file.15.res
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.17.res \
+      --random-seed $seed \
+      -g 3 -l 44 -t 2
+if [ $? -gt 0 ]; then
+    print_exit 17
+fi
+
+diff test/diff/$file.17.res output_files/$file.g3.res
+if [ $? -gt 0 ]; then
+    print_exit 18
+fi
+
+rm test/diff/$file.17.res
+
+normal_exit
@@ -0,0 +1,68 @@
+#!/usr/bin/env bash
+
+# prunes pairs via the Hilbert function learned for homogeneous input,
+# for inhomogeneous input and traced computations the option is ignored
+
+file=quadratic-nonradical-qq
+
+source test/diff/diff_source.sh
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.1.res \
+      --random-seed $seed \
+      -P 2 -d 0 -l 44 -t 1 --hilbert-driven
+if [ $? -gt 0 ]; then
+    print_exit 1
+fi
+
+diff test/diff/$file.1.res output_files/$file.P2.d0.res
+if [ $? -gt 0 ]; then
+    print_exit 2
+fi
+
+rm test/diff/$file.1.res
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.21.res \
+      --random-seed $seed \
+      -P 2 -d 0 -l 44 -t 2 --hilbert-driven
+if [ $? -gt 0 ]; then
+    print_exit 21
+fi
+
+diff test/diff/$file.21.res output_files/$file.P2.d0.res
+if [ $? -gt 0 ]; then
+    print_exit 22
+fi
+
+rm test/diff/$file.21.res
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.41.res \
+      --random-seed $seed \
+      -P 2 -d 0 -l 2 -t 1 --hilbert-driven 2> /dev/null
+if [ $? -gt 0 ]; then
+    print_exit 41
+fi
+
+diff test/diff/$file.41.res output_files/$file.P2.d0.res
+if [ $? -gt 0 ]; then
+    print_exit 42
+fi
+
+rm test/diff/$file.41.res
+
+file=henrion5-qq
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.61.res \
+      --random-seed $seed \
+      -P 2 -d 0 -l 44 -t 1 --hilbert-driven 2> /dev/null
+if [ $? -gt 0 ]; then
+    print_exit 61
+fi
+
+diff test/diff/$file.61.res output_files/$file.P2.d0.res
+if [ $? -gt 0 ]; then
+    print_exit 62
+fi
+
+rm test/diff/$file.61.res
+
+normal_exit
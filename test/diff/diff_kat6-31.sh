@@ -6,4 +6,6 @@ source test/diff/diff_source.sh
 
 source test/diff/diff_source-param-nonf.sh
 
+source test/diff/diff_source-gb-red.sh
+
 normal_exit
@@ -0,0 +1,52 @@
+#!/usr/bin/env bash
+
+# races the learning phase on several primes, the result must not depend
+# on the prime whose run finishes first
+
+file=henrion5-qq
+
+source test/diff/diff_source.sh
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.1.res \
+      --random-seed $seed \
+      -P 2 -d 0 -t 1 --learning-primes 2
+if [ $? -gt 0 ]; then
+    print_exit 1
+fi
+
+diff test/diff/$file.1.res output_files/$file.P2.d0.res
+if [ $? -gt 0 ]; then
+    print_exit 2
+fi
+
+rm test/diff/$file.1.res
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.21.res \
+      --random-seed $seed \
+      -P 2 -d 0 -t 2 --learning-primes 2
+if [ $? -gt 0 ]; then
+    print_exit 21
+fi
+
+diff test/diff/$file.21.res output_files/$file.P2.d0.res
+if [ $? -gt 0 ]; then
+    print_exit 22
+fi
+
+rm test/diff/$file.21.res
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.41.res \
+      --random-seed $seed \
+      -P 2 -d 0 -l 44 -t 4 --learning-primes 4
+if [ $? -gt 0 ]; then
+    print_exit 41
+fi
+
+diff test/diff/$file.41.res output_files/$file.P2.d0.res
+if [ $? -gt 0 ]; then
+    print_exit 42
+fi
+
+rm test/diff/$file.41.res
+
+normal_exit
@@ -0,0 +1,29 @@
+#!/usr/bin/env bash
+
+# runs the diff tests over the rationals with all rational
+# reconstructions done by half-gcd
+
+source test/diff/diff_source.sh
+
+export SEED=$seed
+export MSOLVE_RATRECON_HGCD_MIN=0
+
+excode=1
+for test in cyclic5-qq \
+            elim-qq \
+            eco6-qq \
+            henrion5-qq \
+            kat7-qq \
+            kat8-qq-truncate \
+            nonradical-radicalshape-qq \
+            nonradical-shape-qq \
+            radical-shape-qq \
+            test-lifting2; do
+    bash test/diff/diff_$test.sh 2> /dev/null
+    if [ $? -gt 0 ]; then
+        print_exit $excode
+    fi
+    excode=$((excode+1))
+done
+
+normal_exit
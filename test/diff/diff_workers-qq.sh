@@ -0,0 +1,64 @@
+#!/usr/bin/env bash
+
+# computes the parametrization with worker processes and compares it with
+# the one computed by a single process
+
+file=kat7-qq
+
+source test/diff/diff_source.sh
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.1.res \
+      --random-seed $seed \
+      -P 2 -d 0 -t 1
+if [ $? -gt 0 ]; then
+    print_exit 1
+fi
+
+diff test/diff/$file.1.res output_files/$file.P2.d0.res
+if [ $? -gt 0 ]; then
+    print_exit 2
+fi
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.3.res \
+      --random-seed $seed \
+      -P 2 -d 0 -t 1 --workers 2
+if [ $? -gt 0 ]; then
+    print_exit 3
+fi
+
+diff test/diff/$file.3.res test/diff/$file.1.res
+if [ $? -gt 0 ]; then
+    print_exit 4
+fi
+
+rm test/diff/$file.3.res
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.23.res \
+      --random-seed $seed \
+      -P 2 -d 0 -t 2 --workers 3
+if [ $? -gt 0 ]; then
+    print_exit 23
+fi
+
+diff test/diff/$file.23.res test/diff/$file.1.res
+if [ $? -gt 0 ]; then
+    print_exit 24
+fi
+
+rm test/diff/$file.23.res
+
+$(pwd)/msolve -f input_files/$file.ms -o test/diff/$file.43.res \
+      --random-seed $seed \
+      -P 2 -d 0 -l 44 -t 2 --workers 2
+if [ $? -gt 0 ]; then
+    print_exit 43
+fi
+
+diff test/diff/$file.43.res test/diff/$file.1.res
+if [ $? -gt 0 ]; then
+    print_exit 44
+fi
+
+rm test/diff/$file.43.res test/diff/$file.1.res
+
+normal_exit